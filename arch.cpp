@@ -0,0 +1,253 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "arch.h"
+#include "constants.h"
+#include <fstream>
+
+using namespace vortex;
+
+static std::string trim(const std::string& str) {
+  auto first = str.find_first_not_of(" \t\r");
+  if (first == std::string::npos)
+    return "";
+  auto last = str.find_last_not_of(" \t\r");
+  return str.substr(first, last - first + 1);
+}
+
+static bool parse_uint(const std::string& value, uint32_t* out) {
+  char* end = nullptr;
+  auto result = strtoul(value.c_str(), &end, 0);
+  if (value.empty() || *end != '\0' || result > UINT32_MAX)
+    return false;
+  *out = result;
+  return true;
+}
+
+static bool parse_bool(const std::string& value, bool* out) {
+  if (value == "1" || value == "true" || value == "on") {
+    *out = true;
+    return true;
+  }
+  if (value == "0" || value == "false" || value == "off") {
+    *out = false;
+    return true;
+  }
+  return false;
+}
+
+static bool parse_pow2(const std::string& value, uint32_t* out) {
+  uint32_t result;
+  if (!parse_uint(value, &result) || result == 0 || (result & (result - 1)) != 0)
+    return false;
+  *out = result;
+  return true;
+}
+
+static bool set_cache_param(cache_params_t* cache, const std::string& field, const std::string& value) {
+  bool ok;
+  if (field == "enabled") {
+    ok = parse_bool(value, &cache->enabled);
+  } else if (field == "size") {
+    ok = parse_pow2(value, &cache->size);
+  } else if (field == "ways") {
+    ok = parse_pow2(value, &cache->num_ways);
+  } else if (field == "banks") {
+    ok = parse_pow2(value, &cache->num_banks);
+  } else if (field == "mshr") {
+    ok = parse_uint(value, &cache->mshr_size) && cache->mshr_size != 0;
+  } else if (field == "writeback") {
+    ok = parse_bool(value, &cache->writeback);
+  } else if (field == "latency") {
+    ok = parse_uint(value, &cache->latency) && cache->latency != 0;
+  } else {
+    return false;
+  }
+  return ok;
+}
+
+static bool check_cache(const char* name, const cache_params_t& cache, uint32_t line_size, uint32_t mem_ports) {
+  if (cache.size < line_size * cache.num_ways * cache.num_banks) {
+    std::cerr << "Error: " << name << ".size=" << cache.size << " is smaller than ways * banks * line size" << std::endl;
+    return false;
+  }
+  // the banks are arbitrated down onto the memory ports (at most 64 each way)
+  if (cache.enabled && (cache.num_banks < mem_ports || cache.num_banks > 64)) {
+    std::cerr << "Error: " << name << ".banks=" << cache.num_banks << " must be between " << mem_ports << " (memory ports) and 64" << std::endl;
+    return false;
+  }
+  // CacheSim::Config keeps these in 16 and 8 bits
+  if (cache.mshr_size > UINT16_MAX) {
+    std::cerr << "Error: " << name << ".mshr=" << cache.mshr_size << " exceeds " << UINT16_MAX << std::endl;
+    return false;
+  }
+  if (cache.latency > UINT8_MAX) {
+    std::cerr << "Error: " << name << ".latency=" << cache.latency << " exceeds " << UINT8_MAX << std::endl;
+    return false;
+  }
+  return true;
+}
+
+static void dump_cache(std::ostream& os, const char* name, const cache_params_t& cache) {
+  os << name << ".enabled = " << cache.enabled << std::endl;
+  os << name << ".size = " << cache.size << std::endl;
+  os << name << ".ways = " << cache.num_ways << std::endl;
+  os << name << ".banks = " << cache.num_banks << std::endl;
+  os << name << ".mshr = " << cache.mshr_size << std::endl;
+  os << name << ".writeback = " << cache.writeback << std::endl;
+  os << name << ".latency = " << cache.latency << std::endl;
+}
+
+bool Arch::set_param(const std::string& key, const std::string& value) {
+  uint32_t u;
+  bool ok = false;
+  auto dot = key.find('.');
+  auto group = key.substr(0, dot);
+  auto field = (dot == std::string::npos) ? "" : key.substr(dot + 1);
+
+  if (key == "threads") {
+    ok = parse_uint(value, &u) && u != 0 && u <= UINT16_MAX;
+    if (ok) num_threads_ = u;
+  } else if (key == "warps") {
+    ok = parse_uint(value, &u) && u != 0 && u <= UINT16_MAX;
+    if (ok) num_warps_ = u;
+  } else if (key == "cores") {
+    ok = parse_uint(value, &u) && u != 0 && u <= UINT16_MAX;
+    if (ok) num_cores_ = u;
+  } else if (key == "core.ibuf_size") {
+    ok = parse_uint(value, &ibuf_size_) && ibuf_size_ != 0;
+  } else if (key == "fpu.fma_latency") {
+    ok = parse_uint(value, &fma_latency_);
+  } else if (key == "fpu.fdiv_latency") {
+    ok = parse_uint(value, &fdiv_latency_);
+  } else if (key == "fpu.fsqrt_latency") {
+    ok = parse_uint(value, &fsqrt_latency_);
+  } else if (key == "fpu.fcvt_latency") {
+    ok = parse_uint(value, &fcvt_latency_);
+  } else if (key == "vpu.lanes") {
+    ok = parse_pow2(value, &vpu_num_lanes_);
+  } else if (key == "vpu.lane_width") {
+    ok = parse_pow2(value, &vpu_lane_width_) && vpu_lane_width_ >= 8;
+  } else if (key == "vpu.chaining") {
+    ok = parse_bool(value, &vpu_chaining_);
+  } else if (key == "lmem.banks") {
+    ok = parse_pow2(value, &lmem_num_banks_);
+  } else if (key == "mem.banks") {
+    ok = parse_pow2(value, &mem_num_banks_);
+  } else if (key == "mem.clock_ratio") {
+    char* end = nullptr;
+    mem_clock_ratio_ = strtof(value.c_str(), &end);
+    ok = !value.empty() && *end == '\0' && mem_clock_ratio_ > 0;
+  } else if (key == "tcu.tile") {
+    uint32_t m, n, k, kf = 1;
+    ok = sscanf(value.c_str(), "%ux%ux%u:%u", &m, &n, &k, &kf) >= 3;
+    if (ok) this->set_tcu_tile(m, n, k, kf);
+  } else if (key == "tcu.kernel_tile") {
+    uint32_t m, n, k;
+    ok = sscanf(value.c_str(), "%ux%ux%u", &m, &n, &k) == 3;
+    if (ok) this->set_tcu_kernel_tile(m, n, k);
+  } else if (group == "icache") {
+    ok = set_cache_param(&icache_, field, value);
+  } else if (group == "dcache") {
+    ok = set_cache_param(&dcache_, field, value);
+  } else if (group == "l2") {
+    ok = set_cache_param(&l2cache_, field, value);
+  } else if (group == "l3") {
+    ok = set_cache_param(&l3cache_, field, value);
+  } else {
+    std::cerr << "Error: unknown config parameter: " << key << std::endl;
+    return false;
+  }
+
+  if (!ok) {
+    std::cerr << "Error: invalid value for " << key << ": " << value << std::endl;
+  }
+  return ok;
+}
+
+bool Arch::set_param(const std::string& assignment) {
+  auto sep = assignment.find('=');
+  if (sep == std::string::npos) {
+    std::cerr << "Error: expected <key>=<value>: " << assignment << std::endl;
+    return false;
+  }
+  return this->set_param(trim(assignment.substr(0, sep)), trim(assignment.substr(sep + 1)));
+}
+
+bool Arch::load_config(const std::string& filename) {
+  std::ifstream ifs(filename);
+  if (!ifs) {
+    std::cerr << "Error: cannot open config file: " << filename << std::endl;
+    return false;
+  }
+  std::string line;
+  uint32_t lineno = 0;
+  while (std::getline(ifs, line)) {
+    ++lineno;
+    line = trim(line.substr(0, line.find('#')));
+    if (line.empty())
+      continue;
+    if (!this->set_param(line)) {
+      std::cerr << "Error: " << filename << ":" << lineno << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Arch::validate() const {
+  // the active thread mask is read back through a single XLEN-bit CSR
+  if (num_threads_ > XLEN) {
+    std::cerr << "Error: threads=" << num_threads_ << " exceeds " << XLEN << std::endl;
+    return false;
+  }
+  if (num_warps_ > MAX_NUM_WARPS) {
+    std::cerr << "Error: warps=" << num_warps_ << " exceeds " << MAX_NUM_WARPS << std::endl;
+    return false;
+  }
+  if (num_cores_ > MAX_NUM_CORES) {
+    std::cerr << "Error: cores=" << num_cores_ << " exceeds " << MAX_NUM_CORES << std::endl;
+    return false;
+  }
+  if (mem_num_banks_ < L3_MEM_PORTS || mem_num_banks_ > 64) {
+    std::cerr << "Error: mem.banks=" << mem_num_banks_ << " must be between " << L3_MEM_PORTS << " (memory ports) and 64" << std::endl;
+    return false;
+  }
+  return check_cache("icache", icache_, L1_LINE_SIZE, ICACHE_MEM_PORTS)
+      && check_cache("dcache", dcache_, L1_LINE_SIZE, L1_MEM_PORTS)
+      && check_cache("l2", l2cache_, MEM_BLOCK_SIZE, L2_MEM_PORTS)
+      && check_cache("l3", l3cache_, MEM_BLOCK_SIZE, L3_MEM_PORTS);
+}
+
+void Arch::dump_config(std::ostream& os) const {
+  os << "threads = " << num_threads_ << std::endl;
+  os << "warps = " << num_warps_ << std::endl;
+  os << "cores = " << num_cores_ << std::endl;
+  os << "core.ibuf_size = " << ibuf_size_ << std::endl;
+  os << "fpu.fma_latency = " << fma_latency_ << std::endl;
+  os << "fpu.fdiv_latency = " << fdiv_latency_ << std::endl;
+  os << "fpu.fsqrt_latency = " << fsqrt_latency_ << std::endl;
+  os << "fpu.fcvt_latency = " << fcvt_latency_ << std::endl;
+  os << "vpu.lanes = " << vpu_num_lanes_ << std::endl;
+  os << "vpu.lane_width = " << vpu_lane_width_ << std::endl;
+  os << "vpu.chaining = " << vpu_chaining_ << std::endl;
+  os << "lmem.banks = " << lmem_num_banks_ << std::endl;
+  os << "mem.banks = " << mem_num_banks_ << std::endl;
+  os << "mem.clock_ratio = " << mem_clock_ratio_ << std::endl;
+  os << "tcu.tile = " << tcu_tile_m_ << "x" << tcu_tile_n_ << "x" << tcu_tile_k_ << ":" << tcu_k_fusion_ << std::endl;
+  os << "tcu.kernel_tile = " << tcu_kernel_tile_m_ << "x" << tcu_kernel_tile_n_ << "x" << tcu_kernel_tile_k_ << std::endl;
+  dump_cache(os, "icache", icache_);
+  dump_cache(os, "dcache", dcache_);
+  dump_cache(os, "l2", l2cache_);
+  dump_cache(os, "l3", l3cache_);
+}
@@ -15,6 +15,7 @@
 
 #include <string>
 #include <sstream>
+#include <iostream>
 
 #include <cstdlib>
 #include <stdio.h>
@@ -22,6 +23,20 @@
 
 namespace vortex {
 
+// cache geometry and timing (sizes in bytes)
+struct cache_params_t {
+  bool     enabled;
+  uint32_t size;
+  uint32_t num_ways;
+  uint32_t num_banks;
+  uint32_t mshr_size;
+  bool     writeback;
+  uint32_t latency;
+};
+
+// Architecture parameters. The VX_config.h values are the defaults, so an
+// empty configuration reproduces the compile-time design point exactly;
+// load_config() and set_param() override them at startup.
 class Arch {
 private:
   uint16_t num_threads_;
@@ -31,6 +46,28 @@ private:
   uint16_t socket_size_;
   uint16_t num_barriers_;
   uint64_t local_mem_base_;
+  uint32_t tcu_tile_m_;
+  uint32_t tcu_tile_n_;
+  uint32_t tcu_tile_k_;
+  uint32_t tcu_k_fusion_;
+  uint32_t tcu_kernel_tile_m_;
+  uint32_t tcu_kernel_tile_n_;
+  uint32_t tcu_kernel_tile_k_;
+  cache_params_t icache_;
+  cache_params_t dcache_;
+  cache_params_t l2cache_;
+  cache_params_t l3cache_;
+  uint32_t mem_num_banks_;
+  float    mem_clock_ratio_;
+  uint32_t lmem_num_banks_;
+  uint32_t ibuf_size_;
+  uint32_t fma_latency_;
+  uint32_t fdiv_latency_;
+  uint32_t fsqrt_latency_;
+  uint32_t fcvt_latency_;
+  uint32_t vpu_num_lanes_;
+  uint32_t vpu_lane_width_;
+  bool     vpu_chaining_;
 
 public:
   Arch(uint16_t num_threads, uint16_t num_warps, uint16_t num_cores)   
@@ -41,8 +78,61 @@ public:
     , socket_size_(SOCKET_SIZE)
     , num_barriers_(NUM_BARRIERS)
     , local_mem_base_(LMEM_BASE_ADDR)
+    , tcu_tile_m_(0)
+    , tcu_tile_n_(0)
+    , tcu_tile_k_(0)
+    , tcu_k_fusion_(1)
+    , tcu_kernel_tile_m_(0)
+    , tcu_kernel_tile_n_(0)
+    , tcu_kernel_tile_k_(0)
+    , icache_{ICACHE_ENABLED, ICACHE_SIZE, ICACHE_NUM_WAYS, 1, ICACHE_MSHR_SIZE, false, 2}
+    , dcache_{DCACHE_ENABLED, DCACHE_SIZE, DCACHE_NUM_WAYS, DCACHE_NUM_BANKS, DCACHE_MSHR_SIZE, DCACHE_WRITEBACK, 2}
+    , l2cache_{L2_ENABLED, L2_CACHE_SIZE, L2_NUM_WAYS, L2_NUM_BANKS, L2_MSHR_SIZE, L2_WRITEBACK, 2}
+    , l3cache_{L3_ENABLED, L3_CACHE_SIZE, L3_NUM_WAYS, L3_NUM_BANKS, L3_MSHR_SIZE, L3_WRITEBACK, 2}
+    , mem_num_banks_(PLATFORM_MEMORY_NUM_BANKS)
+    , mem_clock_ratio_(MEM_CLOCK_RATIO)
+    , lmem_num_banks_(LMEM_NUM_BANKS)
+    , ibuf_size_(IBUF_SIZE)
+    , fma_latency_(LATENCY_FMA)
+    , fdiv_latency_(LATENCY_FDIV)
+    , fsqrt_latency_(LATENCY_FSQRT)
+    , fcvt_latency_(LATENCY_FCVT)
+    , vpu_num_lanes_(VPU_NUM_LANES)
+    , vpu_lane_width_(VPU_LANE_WIDTH)
+    , vpu_chaining_(VPU_CHAINING)
   {}
 
+  // apply "key = value" lines from <filename> ('#' starts a comment)
+  bool load_config(const std::string& filename);
+
+  // override a single parameter, e.g. "l2.size", "dcache.mshr" or "tcu.tile"
+  bool set_param(const std::string& key, const std::string& value);
+
+  // "key=value" form of set_param()
+  bool set_param(const std::string& assignment);
+
+  // cross-parameter checks, once every override is applied
+  bool validate() const;
+
+  // write every parameter back in load_config() format
+  void dump_config(std::ostream& os) const;
+
+  // override the tensor core step shape (zero keeps the tensor_cfg.h default)
+  void set_tcu_tile(uint32_t m, uint32_t n, uint32_t k, uint32_t k_fusion) {
+    tcu_tile_m_ = m;
+    tcu_tile_n_ = n;
+    tcu_tile_k_ = k;
+    tcu_k_fusion_ = k_fusion;
+  }
+
+  // step shape the kernel's WMMA fragments were built for (zero keeps the
+  // tensor_cfg.h default); the tensor unit rejects a tile that differs from it
+  void set_tcu_kernel_tile(uint32_t m, uint32_t n, uint32_t k) {
+    tcu_kernel_tile_m_ = m;
+    tcu_kernel_tile_n_ = n;
+    tcu_kernel_tile_k_ = k;
+  }
+
   uint16_t num_barriers() const {
     return num_barriers_;
   }
@@ -71,6 +161,99 @@ public:
     return socket_size_;
   }
 
+  uint32_t tcu_tile_m() const {
+    return tcu_tile_m_;
+  }
+
+  uint32_t tcu_tile_n() const {
+    return tcu_tile_n_;
+  }
+
+  uint32_t tcu_tile_k() const {
+    return tcu_tile_k_;
+  }
+
+  uint32_t tcu_k_fusion() const {
+    return tcu_k_fusion_;
+  }
+
+  uint32_t tcu_kernel_tile_m() const {
+    return tcu_kernel_tile_m_;
+  }
+
+  uint32_t tcu_kernel_tile_n() const {
+    return tcu_kernel_tile_n_;
+  }
+
+  uint32_t tcu_kernel_tile_k() const {
+    return tcu_kernel_tile_k_;
+  }
+
+  const cache_params_t& icache() const {
+    return icache_;
+  }
+
+  const cache_params_t& dcache() const {
+    return dcache_;
+  }
+
+  const cache_params_t& l2cache() const {
+    return l2cache_;
+  }
+
+  const cache_params_t& l3cache() const {
+    return l3cache_;
+  }
+
+  uint32_t mem_num_banks() const {
+    return mem_num_banks_;
+  }
+
+  float mem_clock_ratio() const {
+    return mem_clock_ratio_;
+  }
+
+  uint32_t lmem_num_banks() const {
+    return lmem_num_banks_;
+  }
+
+  uint32_t ibuf_size() const {
+    return ibuf_size_;
+  }
+
+  uint32_t fma_latency() const {
+    return fma_latency_;
+  }
+
+  uint32_t fdiv_latency() const {
+    return fdiv_latency_;
+  }
+
+  uint32_t fsqrt_latency() const {
+    return fsqrt_latency_;
+  }
+
+  uint32_t fcvt_latency() const {
+    return fcvt_latency_;
+  }
+
+  uint32_t vpu_num_lanes() const {
+    return vpu_num_lanes_;
+  }
+
+  uint32_t vpu_lane_width() const {
+    return vpu_lane_width_;
+  }
+
+  // vector arithmetic datapath width in bits
+  uint32_t vpu_datapath_width() const {
+    return vpu_num_lanes_ * vpu_lane_width_;
+  }
+
+  bool vpu_chaining() const {
+    return vpu_chaining_;
+  }
+
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,190 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "bin_trace.h"
+#include "constants.h"
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <string.h>
+
+using namespace vortex;
+
+static_assert(sizeof(BinTrace::Record) == 32, "unexpected trace record size");
+static_assert(MAX_NUM_WARPS <= 256, "warp ids must fit the record's 8-bit wid");
+
+namespace {
+
+struct event_info_t {
+  const char*          name;
+  BinTrace::Component  component;
+  uint8_t              level;
+};
+
+const char* component_names[BinTrace::ComponentCount] = {
+  "pipeline", "cache", "memory", "lsu", "tcu", "vpu"
+};
+
+// lower levels are the cheapest, coarsest view
+const event_info_t event_infos[BinTrace::EventCount] = {
+  {"schedule",   BinTrace::Pipeline, 2},
+  {"decode",     BinTrace::Pipeline, 2},
+  {"issue",      BinTrace::Pipeline, 2},
+  {"dispatch",   BinTrace::Pipeline, 3},
+  {"commit",     BinTrace::Pipeline, 1},
+  {"ibuf-stall", BinTrace::Pipeline, 3},
+  {"cache-req",  BinTrace::Cache,    3},
+  {"cache-miss", BinTrace::Cache,    1},
+  {"cache-fill", BinTrace::Cache,    2},
+  {"cache-evict",BinTrace::Cache,    2},
+  {"dram-req",   BinTrace::Memory,   1},
+  {"dram-rsp",   BinTrace::Memory,   2},
+  {"lsu-req",    BinTrace::Lsu,      2},
+  {"lsu-rsp",    BinTrace::Lsu,      2},
+  {"wmma",       BinTrace::Tcu,      1},
+  {"vpu-op",     BinTrace::Vpu,      1},
+};
+
+template <typename T>
+void write_pod(std::ofstream& ofs, const T& value) {
+  ofs.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void write_str(std::ofstream& ofs, const std::string& str) {
+  write_pod<uint16_t>(ofs, str.size());
+  ofs.write(str.data(), str.size());
+}
+
+}
+
+bool BinTrace::active_[BinTrace::EventCount] = {};
+
+BinTrace::BinTrace()
+  : ring_(RING_SIZE)
+  , head_(0)
+  , tail_(0)
+  , stop_(false)
+  , stalls_(0)
+{}
+
+BinTrace::~BinTrace() {
+  this->close();
+}
+
+uint16_t BinTrace::intern(const std::string& name) {
+  for (uint32_t i = 0; i < sources_.size(); ++i) {
+    if (sources_.at(i) == name)
+      return i;
+  }
+  sources_.push_back(name);
+  return sources_.size() - 1;
+}
+
+bool BinTrace::open(const std::string& filename, const std::string& components, uint32_t level) {
+  uint32_t mask = 0;
+  std::stringstream ss(components);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (item == "all") {
+      mask = (1 << ComponentCount) - 1;
+      continue;
+    }
+    uint32_t c = 0;
+    while (c < ComponentCount && item != component_names[c]) {
+      ++c;
+    }
+    if (c == ComponentCount) {
+      std::cerr << "Error: unknown trace component: " << item << std::endl;
+      return false;
+    }
+    mask |= 1 << c;
+  }
+
+  ofs_.open(filename, std::ios::binary);
+  if (!ofs_) {
+    std::cerr << "Error: cannot open trace file: " << filename << std::endl;
+    return false;
+  }
+
+  // header: format, then the event table so the decoder needs no sources
+  ofs_.write("VXBT", 4);
+  write_pod<uint32_t>(ofs_, VERSION);
+  write_pod<uint32_t>(ofs_, sizeof(Record));
+  write_pod<uint32_t>(ofs_, EventCount);
+  for (uint32_t e = 0; e < EventCount; ++e) {
+    auto& info = event_infos[e];
+    write_str(ofs_, std::string(component_names[info.component]) + ":" + info.name);
+  }
+
+  for (uint32_t e = 0; e < EventCount; ++e) {
+    auto& info = event_infos[e];
+    active_[e] = ((mask >> info.component) & 1) && (info.level <= level);
+  }
+
+  head_ = 0;
+  tail_ = 0;
+  stop_ = false;
+  writer_ = std::thread(&BinTrace::writer, this);
+  return true;
+}
+
+void BinTrace::close() {
+  if (!writer_.joinable())
+    return;
+  memset(active_, 0, sizeof(active_));
+  stop_.store(true, std::memory_order_release);
+  writer_.join();
+
+  // trailer: source names, then its offset so the decoder can find it
+  uint64_t offset = ofs_.tellp();
+  ofs_.write("VXSR", 4);
+  write_pod<uint32_t>(ofs_, sources_.size());
+  for (auto& name : sources_) {
+    write_str(ofs_, name);
+  }
+  write_pod<uint64_t>(ofs_, offset);
+  ofs_.write("VXND", 4);
+  ofs_.close();
+
+  if (stalls_ != 0) {
+    std::cout << "Warning: binary trace writer fell behind, simulation stalled " << stalls_ << " times" << std::endl;
+  }
+}
+
+void BinTrace::wait_for_space(uint64_t head) {
+  ++stalls_;
+  while (head - tail_.load(std::memory_order_acquire) >= RING_SIZE) {
+    std::this_thread::yield();
+  }
+}
+
+void BinTrace::writer() {
+  for (;;) {
+    bool stop = stop_.load(std::memory_order_acquire);
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    uint64_t head = head_.load(std::memory_order_acquire);
+    if (head == tail) {
+      if (stop)
+        break;
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+      continue;
+    }
+    // write up to the end of the ring, a wrapped region takes two passes
+    uint64_t start = tail & (RING_SIZE - 1);
+    uint64_t count = std::min<uint64_t>(head - tail, RING_SIZE - start);
+    ofs_.write(reinterpret_cast<const char*>(&ring_.at(start)), count * sizeof(Record));
+    tail_.store(tail + count, std::memory_order_release);
+  }
+  ofs_.flush();
+}
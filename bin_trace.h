@@ -0,0 +1,140 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include <assert.h>
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vortex {
+
+// Binary debug trace available in release builds. Call sites emit fixed-size
+// records through BT(); a record is only built when its event is enabled at
+// runtime (component mask and verbosity level). Records go into a
+// single-producer ring buffer that a background thread drains to disk.
+// scripts/decode_trace.py converts the file back to text.
+class BinTrace {
+public:
+  enum Component {
+    Pipeline = 0,
+    Cache,
+    Memory,
+    Lsu,
+    Tcu,
+    Vpu,
+    ComponentCount
+  };
+
+  enum Event : uint8_t {
+    Schedule = 0, // pipeline: warp instruction created (arg=active threads)
+    Decode,       // pipeline: instruction entered the ibuffer
+    Issue,        // pipeline: instruction left the ibuffer
+    Dispatch,     // pipeline: dispatched to its unit (arg=first lane)
+    Commit,       // pipeline: instruction retired (arg=active threads)
+    IbufStall,    // pipeline: decode blocked on a full ibuffer
+    CacheReq,     // cache: core request accepted (arg=cid, addr=set<<32|tag)
+    CacheMiss,    // cache: tag miss (arg=write)
+    CacheFill,    // cache: fill response (arg=mshr id)
+    CacheEvict,   // cache: dirty line written back
+    DramReq,      // memory: request sent to a bank (arg=write)
+    DramRsp,      // memory: read response returned (arg=tag)
+    LsuReq,       // lsu: memory request (arg=lanes | write << 31)
+    LsuRsp,       // lsu: memory response (arg=lanes)
+    Wmma,         // tcu: wmma step issued (arg=latency, as in the event trace)
+    VpuOp,        // vpu: vector instruction issued (arg=occupancy)
+    EventCount
+  };
+
+  // 32-byte on-disk record
+  struct Record {
+    uint64_t cycle;
+    uint64_t uuid;
+    uint64_t addr;
+    uint32_t arg;
+    uint16_t src;   // interned source name
+    uint8_t  event;
+    uint8_t  wid;   // warp ids are bounded by MAX_NUM_WARPS
+  };
+
+  static constexpr uint32_t VERSION = 1;
+  static constexpr uint32_t RING_SIZE = 1 << 16; // records
+
+  static BinTrace& instance() {
+    static BinTrace trace;
+    return trace;
+  }
+
+  static bool enabled(Event event) {
+    return active_[event];
+  }
+
+  // <components>: comma list of component names or "all"
+  bool open(const std::string& filename, const std::string& components, uint32_t level);
+
+  // drain the ring and write the source name table
+  void close();
+
+  // register a source (simobject) name, valid before or after open()
+  uint16_t intern(const std::string& name);
+
+  void log(Event event, uint64_t cycle, uint16_t src, uint32_t wid, uint64_t uuid, uint64_t addr, uint32_t arg) {
+    assert(wid <= UINT8_MAX);
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) >= RING_SIZE) {
+      this->wait_for_space(head);
+    }
+    auto& record = ring_[head & (RING_SIZE - 1)];
+    record.cycle = cycle;
+    record.uuid  = uuid;
+    record.addr  = addr;
+    record.arg   = arg;
+    record.src   = src;
+    record.event = event;
+    record.wid   = wid;
+    head_.store(head + 1, std::memory_order_release);
+  }
+
+private:
+
+  BinTrace();
+  ~BinTrace();
+
+  void wait_for_space(uint64_t head);
+
+  void writer();
+
+  static bool active_[EventCount];
+
+  std::vector<Record> ring_;
+  std::atomic<uint64_t> head_;
+  std::atomic<uint64_t> tail_;
+  std::atomic<bool> stop_;
+  std::thread writer_;
+  std::ofstream ofs_;
+  std::vector<std::string> sources_;
+  uint64_t stalls_;
+};
+
+}
+
+// binary trace point, compiled in all builds and gated at runtime
+#define BT(event, src, wid, uuid, addr, arg) do { \
+  if (vortex::BinTrace::enabled(vortex::BinTrace::event)) { \
+    vortex::BinTrace::instance().log(vortex::BinTrace::event, SimPlatform::instance().cycles(), src, wid, uuid, addr, arg); \
+  } \
+} while(0)
@@ -95,6 +95,18 @@ public:
 		return perf;
 	}
 
+	void set_miss_callback(const CacheSim::MissCallback& callback) {
+		for (auto cache : caches_) {
+			cache->set_miss_callback(callback);
+		}
+	}
+
+	void set_fill_callback(const CacheSim::FillCallback& callback) {
+		for (auto cache : caches_) {
+			cache->set_fill_callback(callback);
+		}
+	}
+
 private:
   std::vector<CacheSim::Ptr> caches_;
 };
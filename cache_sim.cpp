@@ -193,6 +193,7 @@ struct bank_req_t {
 struct mshr_entry_t {
 	bank_req_t bank_req;
 	uint32_t line_id;
+	uint64_t alloc_time;
 
 	mshr_entry_t() {}
 
@@ -248,6 +249,7 @@ public:
 			if (entry.bank_req.type == bank_req_t::None) {
 				entry.bank_req = bank_req;
 				entry.line_id = line_id;
+				entry.alloc_time = SimPlatform::instance().cycles();
 				++size_;
 				return i;
 			}
@@ -322,6 +324,7 @@ public:
 		, sets_(params.sets_per_bank, params.lines_per_set)
 		, mshr_(config.mshr_size)
 		, pipe_req_(TFifo<bank_req_t>::Create("", config.latency-1))
+		, trace_src_(BinTrace::instance().intern(name))
 	{
 		this->reset();
 	}
@@ -349,6 +352,14 @@ public:
 		return perf_stats_;
 	}
 
+	void set_miss_callback(const CacheSim::MissCallback& callback) {
+		miss_callback_ = callback;
+	}
+
+	void set_fill_callback(const CacheSim::FillCallback& callback) {
+		fill_callback_ = callback;
+	}
+
 private:
 
 	void processInputs() {
@@ -368,8 +379,14 @@ private:
 			if (!this->mem_rsp_port.empty()) {
 				auto& mem_rsp = mem_rsp_port.front();
 				DT(3, this->name() << "-fill-rsp: " << mem_rsp);
+				BT(CacheFill, trace_src_, 0, mem_rsp.uuid, 0, mem_rsp.tag);
 				// update MSHR
 				auto& entry = mshr_.replay(mem_rsp.tag);
+				if (fill_callback_) {
+					fill_callback_(entry.bank_req.cid, entry.bank_req.uuid,
+					               params_.mem_addr(bank_id_, entry.bank_req.set_id, entry.bank_req.addr_tag),
+					               entry.alloc_time);
+				}
 				auto& set   = sets_.at(entry.bank_req.set_id);
 				auto& line  = set.lines.at(entry.line_id);
 				line.valid  = true;
@@ -393,6 +410,7 @@ private:
 				}
 				++pending_mshr_size_;
 				DT(3, this->name() << "-core-req: " << core_req);
+				BT(CacheReq, trace_src_, 0, core_req.uuid, core_req.addr, core_req.cid);
 				bank_req.type = bank_req_t::Core;
 				bank_req.cid = core_req.cid;
 				bank_req.uuid = core_req.uuid;
@@ -465,6 +483,11 @@ private:
 					++perf_stats_.write_misses;
 				else
 					++perf_stats_.read_misses;
+				if (miss_callback_) {
+					miss_callback_(bank_req.cid, bank_req.uuid, bank_req.write);
+				}
+				BT(CacheMiss, trace_src_, 0, bank_req.uuid,
+				   params_.mem_addr(bank_id_, bank_req.set_id, bank_req.addr_tag), bank_req.write);
 
 				if (free_line_id == -1 && config_.write_back) {
 					// write back dirty line
@@ -476,6 +499,7 @@ private:
 						mem_req.cid   = bank_req.cid;
 						this->mem_req_port.push(mem_req);
 						DT(3, this->name() << "-writeback: " << mem_req);
+						BT(CacheEvict, trace_src_, 0, bank_req.uuid, mem_req.addr, 0);
 						++perf_stats_.evictions;
 					}
 				}
@@ -538,6 +562,10 @@ private:
 	TFifo<bank_req_t>::Ptr pipe_req_;
 
 	CacheSim::PerfStats perf_stats_;
+	CacheSim::MissCallback miss_callback_;
+	CacheSim::FillCallback fill_callback_;
+
+	uint16_t trace_src_;
 
 	uint64_t pending_read_reqs_;
 	uint64_t pending_write_reqs_;
@@ -684,6 +712,22 @@ public:
 		return perf_stats;
 	}
 
+	void set_miss_callback(const MissCallback& callback) {
+		if (config_.bypass)
+			return;
+		for (auto& bank : banks_) {
+			bank->set_miss_callback(callback);
+		}
+	}
+
+	void set_fill_callback(const FillCallback& callback) {
+		if (config_.bypass)
+			return;
+		for (auto& bank : banks_) {
+			bank->set_fill_callback(callback);
+		}
+	}
+
 private:
 
 	void processBypassResponse(const MemRsp& mem_rsp) {
@@ -746,4 +790,12 @@ void CacheSim::tick() {
 
 CacheSim::PerfStats CacheSim::perf_stats() const {
   return impl_->perf_stats();
-}
\ No newline at end of file
+}
+
+void CacheSim::set_miss_callback(const MissCallback& callback) {
+  impl_->set_miss_callback(callback);
+}
+
+void CacheSim::set_fill_callback(const FillCallback& callback) {
+  impl_->set_fill_callback(callback);
+}
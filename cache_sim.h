@@ -14,6 +14,7 @@
 #pragma once
 
 #include <simobject.h>
+#include <functional>
 #include "mem_sim.h"
 
 namespace vortex {
@@ -70,6 +71,13 @@ public:
 		}
 	};
 
+	// miss listener used by the profilers: (core id, instruction uuid, write)
+	using MissCallback = std::function<void(uint32_t cid, uint64_t uuid, bool write)>;
+
+	// MSHR lifetime listener used by the event trace: called when the fill for
+	// the entry allocated at <alloc_cycle> returns
+	using FillCallback = std::function<void(uint32_t cid, uint64_t uuid, uint64_t addr, uint64_t alloc_cycle)>;
+
 	std::vector<SimPort<MemReq>> CoreReqPorts;
 	std::vector<SimPort<MemRsp>> CoreRspPorts;
 	std::vector<SimPort<MemReq>> MemReqPorts;
@@ -84,6 +92,10 @@ public:
 
 	PerfStats perf_stats() const;
 
+	void set_miss_callback(const MissCallback& callback);
+
+	void set_fill_callback(const FillCallback& callback);
+
 private:
 	class Impl;
 	Impl* impl_;
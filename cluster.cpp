@@ -42,21 +42,22 @@ Cluster::Cluster(const SimContext& ctx,
 
   // Create l2cache
 
+  auto& l2 = arch.l2cache();
   snprintf(sname, 100, "%s-l2cache", this->name().c_str());
   l2cache_ = CacheSim::Create(sname, CacheSim::Config{
-    !L2_ENABLED,
-    log2ceil(L2_CACHE_SIZE),// C
+    !l2.enabled,
+    uint8_t(log2ceil(l2.size)), // C
     log2ceil(MEM_BLOCK_SIZE),// L
     log2ceil(L1_LINE_SIZE), // W
-    log2ceil(L2_NUM_WAYS),  // A
-    log2ceil(L2_NUM_BANKS), // B
+    uint8_t(log2ceil(l2.num_ways)), // A
+    uint8_t(log2ceil(l2.num_banks)), // B
     XLEN,                   // address bits
     L2_NUM_REQS,            // request size
     L2_MEM_PORTS,           // memory ports
-    L2_WRITEBACK,           // write-back
+    l2.writeback,           // write-back
     false,                  // write response
-    L2_MSHR_SIZE,           // mshr size
-    2,                      // pipeline latency
+    uint16_t(l2.mshr_size), // mshr size
+    uint8_t(l2.latency),    // pipeline latency
   });
 
   // connect l2cache core interfaces
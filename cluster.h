@@ -51,6 +51,14 @@ public:
     return processor_;
   }
 
+  const std::vector<Socket::Ptr>& sockets() const {
+    return sockets_;
+  }
+
+  const CacheSim::Ptr& l2cache() const {
+    return l2cache_;
+  }
+
   void reset();
 
   void tick();
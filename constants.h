@@ -24,6 +24,18 @@
 #define MEM_CLOCK_RATIO   1
 #endif
 
+#ifndef VPU_NUM_LANES
+#define VPU_NUM_LANES     4
+#endif
+
+#ifndef VPU_LANE_WIDTH
+#define VPU_LANE_WIDTH    64
+#endif
+
+#ifndef VPU_CHAINING
+#define VPU_CHAINING      1
+#endif
+
 namespace vortex {
 
 inline constexpr uint32_t XLENB           = (XLEN / 8);
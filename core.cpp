@@ -46,7 +46,7 @@ Core::Core(const SimContext& ctx,
   , vec_unit_(VecUnit::Create("vpu", arch, this))
 #endif
   , emulator_(arch, dcrs, this)
-  , ibuffers_(arch.num_warps(), IBUF_SIZE)
+  , ibuffers_(arch.num_warps(), arch.ibuf_size())
   , scoreboard_(arch_)
   , operands_(ISSUE_WIDTH)
   , dispatchers_((uint32_t)FUType::Count)
@@ -56,6 +56,10 @@ Core::Core(const SimContext& ctx,
   , pending_icache_(arch_.num_warps())
   , commit_arbs_(ISSUE_WIDTH)
   , ibuffer_arbs_(ISSUE_WIDTH, {ArbiterType::RoundRobin, PER_ISSUE_WARPS})
+  , pc_profiler_(nullptr)
+  , mem_profiler_(nullptr)
+  , event_trace_(nullptr)
+  , trace_src_(BinTrace::instance().intern(this->name()))
 {
   char sname[100];
 
@@ -75,7 +79,7 @@ Core::Core(const SimContext& ctx,
     (1 << LMEM_LOG_SIZE),
     LSU_WORD_SIZE,
     LSU_CHANNELS,
-    log2ceil(LMEM_NUM_BANKS),
+    log2ceil(arch.lmem_num_banks()),
     false
   });
 
@@ -225,6 +229,10 @@ void Core::schedule() {
   emulator_.suspend(trace->wid);
 
   DT(3, "pipeline-schedule: " << *trace);
+  BT(Schedule, trace_src_, trace->wid, trace->uuid, trace->PC, trace->tmask.count());
+  if (event_trace_) {
+    event_trace_->scheduled(trace);
+  }
 
   // advance to fetch stage
   fetch_latch_.push(trace);
@@ -274,8 +282,12 @@ void Core::decode() {
   if (ibuffer.full()) {
     if (!trace->log_once(true)) {
       DT(4, "*** ibuffer-stall: " << *trace);
+      BT(IbufStall, trace_src_, trace->wid, trace->uuid, trace->PC, 0);
     }
     ++perf_stats_.ibuf_stalls;
+    if (pc_profiler_) {
+      pc_profiler_->ibuf_stall(trace);
+    }
     return;
   } else {
     trace->log_once(false);
@@ -287,9 +299,16 @@ void Core::decode() {
   }
 
   DT(3, "pipeline-decode: " << *trace);
+  BT(Decode, trace_src_, trace->wid, trace->uuid, trace->PC, 0);
 
   // insert to ibuffer
   ibuffer.push(trace);
+  if (pc_profiler_) {
+    pc_profiler_->decoded(trace);
+  }
+  if (event_trace_) {
+    event_trace_->stage(trace, "fetch");
+  }
 
   decode_latch_.pop();
 }
@@ -301,6 +320,9 @@ void Core::issue() {
     if (operand->Output.empty())
       continue;
     auto trace = operand->Output.front();
+    if (event_trace_) {
+      event_trace_->stage(trace, "operands");
+    }
     dispatchers_.at((int)trace->fu_type)->Inputs.at(iw).push(trace);
     operand->Output.pop();
   }
@@ -351,6 +373,9 @@ void Core::issue() {
         #endif
           default: assert(false);
           }
+          if (pc_profiler_) {
+            pc_profiler_->scrb_stall(trace, use.fu_type, (j == 0));
+          }
         }
       } else {
         trace->log_once(false);
@@ -366,9 +391,13 @@ void Core::issue() {
       auto trace = ibuffer.top();
       // update scoreboard
       DT(3, "pipeline-ibuffer: " << *trace);
+      BT(Issue, trace_src_, trace->wid, trace->uuid, trace->PC, 0);
       if (trace->wb) {
         scoreboard_.reserve(trace);
       }
+      if (event_trace_) {
+        event_trace_->stage(trace, "ibuffer");
+      }
       // to operand stage
       operands_.at(iw)->Input.push(trace, 1);
       ibuffer.pop();
@@ -389,12 +418,35 @@ void Core::execute() {
       if (dispatch->Outputs.at(iw).empty())
         continue;
       auto trace = dispatch->Outputs.at(iw).front();
+      if (event_trace_) {
+        event_trace_->stage(trace, "dispatch");
+      }
+      BT(Dispatch, trace_src_, trace->wid, trace->uuid, trace->PC, trace->pid);
       func_unit->Inputs.at(iw).push(trace, 2);
       dispatch->Outputs.at(iw).pop();
     }
   }
 }
 
+// floating-point operations per thread, fused multiply-adds count twice
+static uint32_t fpu_flops(FpuType fpu_type) {
+  switch (fpu_type) {
+  case FpuType::FADD:
+  case FpuType::FSUB:
+  case FpuType::FMUL:
+  case FpuType::FDIV:
+  case FpuType::FSQRT:
+    return 1;
+  case FpuType::FMADD:
+  case FpuType::FMSUB:
+  case FpuType::FNMADD:
+  case FpuType::FNMSUB:
+    return 2;
+  default:
+    return 0;
+  }
+}
+
 void Core::commit() {
   // process completed instructions
   for (uint32_t iw = 0; iw < ISSUE_WIDTH; ++iw) {
@@ -406,6 +458,9 @@ void Core::commit() {
     // advance to commit stage
     DT(3, "pipeline-commit: " << *trace);
     assert(trace->cid == core_id_);
+    if (event_trace_) {
+      event_trace_->stage(trace, "execute");
+    }
 
     // update scoreboard
     if (trace->eop) {
@@ -417,6 +472,16 @@ void Core::commit() {
       pending_instrs_.remove(trace);
       if (pending_instrs_.size() != orig_size) {
         perf_stats_.instrs += trace->tmask.count();
+        BT(Commit, trace_src_, trace->wid, trace->uuid, trace->PC, trace->tmask.count());
+        if (auto fpu_type = std::get_if<FpuType>(&trace->op_type)) {
+          perf_stats_.fpu_flops += fpu_flops(*fpu_type) * trace->tmask.count();
+        }
+        if (pc_profiler_) {
+          pc_profiler_->committed(trace);
+        }
+        if (event_trace_) {
+          event_trace_->committed(trace);
+        }
       #ifdef EXT_V_ENABLE
         if (std::get_if<VsetType>(&trace->op_type)
          || std::get_if<VlsType>(&trace->op_type)
@@ -33,6 +33,9 @@
 #include "dispatcher.h"
 #include "func_unit.h"
 #include "mem_coalescer.h"
+#include "pc_profiler.h"
+#include "mem_profiler.h"
+#include "event_trace.h"
 #include "VX_config.h"
 
 namespace vortex {
@@ -69,6 +72,7 @@ public:
     uint64_t stores;
     uint64_t ifetch_latency;
     uint64_t load_latency;
+    uint64_t fpu_flops;
 
     PerfStats()
       : cycles(0)
@@ -96,7 +100,38 @@ public:
       , stores(0)
       , ifetch_latency(0)
       , load_latency(0)
+      , fpu_flops(0)
     {}
+
+    PerfStats& operator+=(const PerfStats& rhs) {
+      this->cycles         += rhs.cycles;
+      this->instrs         += rhs.instrs;
+      this->sched_idle     += rhs.sched_idle;
+      this->sched_stalls   += rhs.sched_stalls;
+      this->ibuf_stalls    += rhs.ibuf_stalls;
+      this->scrb_stalls    += rhs.scrb_stalls;
+      this->opds_stalls    += rhs.opds_stalls;
+      this->scrb_alu       += rhs.scrb_alu;
+      this->scrb_fpu       += rhs.scrb_fpu;
+      this->scrb_lsu       += rhs.scrb_lsu;
+      this->scrb_sfu       += rhs.scrb_sfu;
+      this->scrb_csrs      += rhs.scrb_csrs;
+      this->scrb_wctl      += rhs.scrb_wctl;
+    #ifdef EXT_V_ENABLE
+      this->vinstrs        += rhs.vinstrs;
+      this->scrb_vpu       += rhs.scrb_vpu;
+    #endif
+    #ifdef EXT_TCU_ENABLE
+      this->scrb_tcu       += rhs.scrb_tcu;
+    #endif
+      this->ifetches       += rhs.ifetches;
+      this->loads          += rhs.loads;
+      this->stores         += rhs.stores;
+      this->ifetch_latency += rhs.ifetch_latency;
+      this->load_latency   += rhs.load_latency;
+      this->fpu_flops      += rhs.fpu_flops;
+      return *this;
+    }
   };
 
   std::vector<SimPort<MemReq>> icache_req_ports;
@@ -175,6 +210,35 @@ public:
     return trace_pool_;
   }
 
+  void set_pc_profiler(PcProfiler* profiler) {
+    pc_profiler_ = profiler;
+  }
+
+  void set_simt_profiler(SimtProfiler* profiler) {
+    emulator_.set_simt_profiler(profiler);
+  }
+
+  void set_mem_profiler(MemProfiler* profiler) {
+    mem_profiler_ = profiler;
+  }
+
+  MemProfiler* mem_profiler() const {
+    return mem_profiler_;
+  }
+
+  void set_event_trace(EventTrace* event_trace) {
+    event_trace_ = event_trace;
+  }
+
+  EventTrace* event_trace() const {
+    return event_trace_;
+  }
+
+  // binary trace source id
+  uint16_t trace_src() const {
+    return trace_src_;
+  }
+
   const PerfStats& perf_stats() const;
 
   int get_exitcode() const;
@@ -228,6 +292,12 @@ private:
 
   PoolAllocator<instr_trace_t, 64> trace_pool_;
 
+  PcProfiler* pc_profiler_;
+  MemProfiler* mem_profiler_;
+  EventTrace* event_trace_;
+
+  uint16_t trace_src_;
+
   friend class LsuUnit;
   friend class AluUnit;
   friend class FpuUnit;
@@ -13,6 +13,8 @@
 
 #pragma once
 
+#include "bin_trace.h"
+
 #ifndef DEBUG_LEVEL
 #define DEBUG_LEVEL 3
 #endif
@@ -79,6 +79,7 @@ Emulator::Emulator(const Arch &arch, const DCRS &dcrs, Core* core)
     , warps_(arch.num_warps(), arch.num_threads())
     , barriers_(arch.num_barriers(), 0)
     , ipdom_size_(arch.num_threads()-1)
+    , simt_profiler_(nullptr)
   #ifdef EXT_TCU_ENABLE
     , tensor_unit_(core->tensor_unit())
   #endif
@@ -184,15 +185,14 @@ instr_trace_t* Emulator::step() {
 
   // fetch next instruction if ibuffer is empty
   if (warp.ibuffer.empty()) {
-    uint64_t uuid = 0;
-  #ifndef NDEBUG
+    // generate unique universal instruction ID
+    // (also needed in release builds to attribute cache misses to PCs)
+    uint64_t uuid;
     {
-      // generate unique universal instruction ID
       uint32_t instr_uuid = warp.uuid++;
       uint32_t g_wid = core_->id() * arch_.num_warps() + scheduled_warp;
       uuid = (uint64_t(g_wid) << 32) | instr_uuid;
     }
-  #endif
 
     // Fetch
     auto instr_code = this->fetch(scheduled_warp, uuid);
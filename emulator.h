@@ -20,6 +20,7 @@
 #include <mem.h>
 #include "types.h"
 #include "instr.h"
+#include "simt_profiler.h"
 #ifdef EXT_TCU_ENABLE
 #include "tensor_unit.h"
 #endif
@@ -108,6 +109,10 @@ public:
 
   void dcache_write(const void* data, uint64_t addr, uint32_t size);
 
+  void set_simt_profiler(SimtProfiler* profiler) {
+    simt_profiler_ = profiler;
+  }
+
 private:
 
   uint32_t fetch(uint32_t wid, uint64_t uuid);
@@ -154,6 +159,7 @@ private:
   uint32_t    ipdom_size_;
   Word        csr_mscratch_;
   wspawn_t    wspawn_;
+  SimtProfiler* simt_profiler_;
 
 #ifdef EXT_TCU_ENABLE
   TensorUnit::Ptr tensor_unit_;
@@ -0,0 +1,186 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "event_trace.h"
+#include <sstream>
+
+using namespace vortex;
+
+static std::string hex(uint64_t value) {
+  std::ostringstream ss;
+  ss << "\"0x" << std::hex << value << "\"";
+  return ss.str();
+}
+
+EventTrace::EventTrace(const Arch& arch,
+                       const std::string& filename,
+                       uint64_t start_cycle,
+                       uint64_t end_cycle,
+                       const std::vector<uint32_t>& cores)
+  : ofs_(filename)
+  , first_(true)
+  , start_cycle_(start_cycle)
+  , end_cycle_(end_cycle)
+  , dram_pid_(arch.num_cores() * arch.num_clusters())
+  , mshr_tid_(arch.num_warps())
+  , cores_(dram_pid_, cores.empty())
+{
+  if (!ofs_) {
+    std::cerr << "Error: cannot open trace file: " << filename << std::endl;
+    return;
+  }
+  for (auto cid : cores) {
+    if (cid < cores_.size()) {
+      cores_.at(cid) = true;
+    }
+  }
+  ofs_ << "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"time_unit\":\"cycle\"},\"traceEvents\":[";
+  for (uint32_t cid = 0; cid < cores_.size(); ++cid) {
+    if (cores_.at(cid)) {
+      this->metadata(cid, "core" + std::to_string(cid));
+      this->thread_metadata(cid, mshr_tid_, "mshr");
+    }
+  }
+  this->metadata(dram_pid_, "dram");
+}
+
+EventTrace::~EventTrace() {
+  if (ofs_) {
+    ofs_ << "\n]}\n";
+  }
+}
+
+void EventTrace::begin_event() {
+  if (!first_)
+    ofs_ << ",";
+  ofs_ << "\n";
+  first_ = false;
+}
+
+void EventTrace::metadata(uint32_t pid, const std::string& name) {
+  this->begin_event();
+  ofs_ << "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":" << pid << ",\"args\":{\"name\":\"" << name << "\"}}";
+  this->begin_event();
+  ofs_ << "{\"ph\":\"M\",\"name\":\"process_sort_index\",\"pid\":" << pid << ",\"args\":{\"sort_index\":" << pid << "}}";
+}
+
+void EventTrace::thread_metadata(uint32_t pid, uint32_t tid, const std::string& name) {
+  this->begin_event();
+  ofs_ << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << pid << ",\"tid\":" << tid << ",\"args\":{\"name\":\"" << name << "\"}}";
+}
+
+void EventTrace::async(char ph,
+                       const char* cat,
+                       const std::string& name,
+                       uint64_t id,
+                       uint32_t pid,
+                       uint32_t tid,
+                       uint64_t ts,
+                       const std::string& args) {
+  if (!ofs_)
+    return;
+  this->begin_event();
+  ofs_ << "{\"ph\":\"" << ph << "\",\"cat\":\"" << cat << "\",\"name\":\"" << name << "\",\"id\":" << id
+       << ",\"pid\":" << pid << ",\"tid\":" << tid << ",\"ts\":" << ts;
+  if (!args.empty()) {
+    ofs_ << ",\"args\":{" << args << "}";
+  }
+  ofs_ << "}";
+}
+
+void EventTrace::instant(const char* cat, const std::string& name, uint32_t pid, uint64_t ts, const std::string& args) {
+  if (!ofs_)
+    return;
+  this->begin_event();
+  ofs_ << "{\"ph\":\"i\",\"s\":\"p\",\"cat\":\"" << cat << "\",\"name\":\"" << name
+       << "\",\"pid\":" << pid << ",\"tid\":0,\"ts\":" << ts;
+  if (!args.empty()) {
+    ofs_ << ",\"args\":{" << args << "}";
+  }
+  ofs_ << "}";
+}
+
+static std::string instr_name(const instr_trace_t* trace) {
+  std::ostringstream ss;
+  ss << trace->fu_type;
+  return ss.str();
+}
+
+void EventTrace::scheduled(const instr_trace_t* trace) {
+  if (!this->enabled(trace->cid, trace->issue_time))
+    return;
+  std::ostringstream args;
+  args << "\"pc\":" << hex(trace->PC)
+       << ",\"threads\":" << trace->tmask.count()
+       << ",\"uuid\":" << trace->uuid;
+  this->async('b', "pipeline", instr_name(trace), trace->uuid, trace->cid, trace->wid, trace->issue_time, args.str());
+}
+
+void EventTrace::stage(instr_trace_t* trace, const char* name) {
+  uint64_t now = SimPlatform::instance().cycles();
+  if (this->enabled(trace->cid, trace->issue_time)) {
+    this->span("pipeline", name, trace->uuid, trace->cid, trace->wid, trace->stage_time, now, "");
+  }
+  trace->stage_time = now;
+}
+
+void EventTrace::committed(const instr_trace_t* trace) {
+  if (!this->enabled(trace->cid, trace->issue_time))
+    return;
+  uint64_t now = SimPlatform::instance().cycles();
+  this->async('e', "pipeline", instr_name(trace), trace->uuid, trace->cid, trace->wid, now, "");
+}
+
+void EventTrace::mshr(const char* cache, uint32_t cid, uint64_t uuid, uint64_t addr, uint64_t alloc_cycle) {
+  uint64_t now = SimPlatform::instance().cycles();
+  if (!this->enabled(cid, alloc_cycle))
+    return;
+  std::ostringstream args;
+  args << "\"addr\":" << hex(addr) << ",\"uuid\":" << uuid;
+  this->span("cache", std::string(cache) + "-mshr", uuid, cid, mshr_tid_, alloc_cycle, now, args.str());
+}
+
+void EventTrace::dram_request(uint32_t port, const MemReq& req, uint64_t cycle) {
+  if (!this->enabled(req.cid, cycle))
+    return;
+  if (req.write) {
+    // writes are posted, there is no response to close a span
+    std::ostringstream args;
+    args << "\"addr\":" << hex(req.addr) << ",\"cid\":" << req.cid << ",\"port\":" << port;
+    this->instant("dram", "write", dram_pid_, cycle, args.str());
+    return;
+  }
+  uint64_t key = (uint64_t(port) << 32) | req.tag;
+  dram_reqs_[key] = dram_req_t{req.addr, req.cid, req.uuid, cycle};
+}
+
+void EventTrace::dram_response(uint32_t port, const MemRsp& rsp, uint64_t cycle) {
+  uint64_t key = (uint64_t(port) << 32) | rsp.tag;
+  auto it = dram_reqs_.find(key);
+  if (it == dram_reqs_.end())
+    return;
+  auto& req = it->second;
+  std::ostringstream args;
+  args << "\"addr\":" << hex(req.addr) << ",\"cid\":" << req.cid << ",\"uuid\":" << req.uuid;
+  this->span("dram", "read", key, dram_pid_, port, req.start, cycle, args.str());
+  dram_reqs_.erase(it);
+}
+
+void EventTrace::tcu(const instr_trace_t* trace, uint32_t latency) {
+  if (!this->enabled(trace->cid, trace->issue_time))
+    return;
+  uint64_t now = SimPlatform::instance().cycles();
+  std::ostringstream args;
+  args << "\"pc\":" << hex(trace->PC) << ",\"latency\":" << latency;
+  this->span("tcu", "wmma", trace->uuid, trace->cid, trace->wid, now, now + latency, args.str());
+}
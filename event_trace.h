@@ -0,0 +1,111 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "instr_trace.h"
+
+namespace vortex {
+
+// Structured event trace in the Chrome trace-event JSON format (loadable in
+// Perfetto and chrome://tracing). Each core is a process; instructions,
+// MSHR entries, DRAM reads and wmma steps are async spans keyed by their
+// uuid; warps are the threads of a core process and MSHR entries sit on a
+// track of their own. Timestamps are core cycles. Instructions are kept
+// when scheduled inside the cycle window on a selected core, memory events
+// when they start inside it; everything else is dropped at the source.
+class EventTrace {
+public:
+  // empty <cores> traces every core
+  EventTrace(const Arch& arch,
+             const std::string& filename,
+             uint64_t start_cycle,
+             uint64_t end_cycle,
+             const std::vector<uint32_t>& cores);
+  ~EventTrace();
+
+  bool enabled(uint32_t cid, uint64_t cycle) const {
+    return cycle >= start_cycle_ && cycle <= end_cycle_ && cid < cores_.size() && cores_.at(cid);
+  }
+
+  // open the whole-instruction span
+  void scheduled(const instr_trace_t* trace);
+
+  // close the instruction's current pipeline stage under <name> and start the next one
+  void stage(instr_trace_t* trace, const char* name);
+
+  // close the whole-instruction span
+  void committed(const instr_trace_t* trace);
+
+  // MSHR entry lifetime, miss allocation to fill response
+  void mshr(const char* cache, uint32_t cid, uint64_t uuid, uint64_t addr, uint64_t alloc_cycle);
+
+  void dram_request(uint32_t port, const MemReq& req, uint64_t cycle);
+
+  void dram_response(uint32_t port, const MemRsp& rsp, uint64_t cycle);
+
+  void tcu(const instr_trace_t* trace, uint32_t latency);
+
+private:
+
+  struct dram_req_t {
+    uint64_t addr;
+    uint32_t cid;
+    uint64_t uuid;
+    uint64_t start;
+  };
+
+  void async(char ph,
+             const char* cat,
+             const std::string& name,
+             uint64_t id,
+             uint32_t pid,
+             uint32_t tid,
+             uint64_t ts,
+             const std::string& args);
+
+  void span(const char* cat,
+            const std::string& name,
+            uint64_t id,
+            uint32_t pid,
+            uint32_t tid,
+            uint64_t start,
+            uint64_t end,
+            const std::string& args) {
+    this->async('b', cat, name, id, pid, tid, start, args);
+    this->async('e', cat, name, id, pid, tid, end, "");
+  }
+
+  void instant(const char* cat, const std::string& name, uint32_t pid, uint64_t ts, const std::string& args);
+
+  void metadata(uint32_t pid, const std::string& name);
+
+  void thread_metadata(uint32_t pid, uint32_t tid, const std::string& name);
+
+  void begin_event();
+
+  std::ofstream ofs_;
+  bool first_;
+  uint64_t start_cycle_;
+  uint64_t end_cycle_;
+  uint32_t dram_pid_;
+  uint32_t mshr_tid_;  // past the last warp id, so MSHR spans get their own track
+  std::vector<bool> cores_;
+  std::unordered_map<uint64_t, dram_req_t> dram_reqs_;
+};
+
+}
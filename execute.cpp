@@ -137,6 +137,10 @@ instr_trace_t* Emulator::execute(const Instr &instr, uint32_t wid) {
   trace->dst_reg  = rdest;
   trace->src_regs = {rsrc0, rsrc1, rsrc2};
 
+  if (simt_profiler_) {
+    simt_profiler_->instr(core_->id(), wid, warp.tmask, warp.ipdom_stack.size());
+  }
+
   std::vector<reg_data_t> rd_data(num_threads);
   std::vector<reg_data_t> rs1_data;
   std::vector<reg_data_t> rs2_data;
@@ -1338,6 +1342,9 @@ instr_trace_t* Emulator::execute(const Instr &instr, uint32_t wid) {
         }
 
         bool is_divergent = then_tmask.any() && else_tmask.any();
+        if (simt_profiler_) {
+          simt_profiler_->split(core_->id(), wid, warp.PC, is_divergent);
+        }
         if (is_divergent) {
           if (stack_size == ipdom_size_) {
             std::cout << "IPDOM stack is full! size=" << stack_size << ", PC=0x" << std::hex << warp.PC << std::dec << " (#" << trace->uuid << ")\n" << std::flush;
@@ -1370,6 +1377,9 @@ instr_trace_t* Emulator::execute(const Instr &instr, uint32_t wid) {
           if (warp.ipdom_stack.top().fallthrough) {
             next_tmask = warp.ipdom_stack.top().orig_tmask;
             warp.ipdom_stack.pop();
+            if (simt_profiler_) {
+              simt_profiler_->join(core_->id(), wid, true);
+            }
           } else {
             next_tmask = warp.ipdom_stack.top().else_tmask;
             next_pc = warp.ipdom_stack.top().PC;
@@ -1394,6 +1404,9 @@ instr_trace_t* Emulator::execute(const Instr &instr, uint32_t wid) {
         } else {
           next_tmask = ThreadMask(num_threads, rs2_data.at(thread_last).u);
         }
+        if (simt_profiler_) {
+          simt_profiler_->pred(core_->id(), wid, warp.PC, (pred != warp.tmask));
+        }
       } break;
       default:
         std::abort();
@@ -1415,7 +1428,7 @@ instr_trace_t* Emulator::execute(const Instr &instr, uint32_t wid) {
       case VlsType::VL:
       case VlsType::VLS:
       case VlsType::VLX: {
-        auto trace_data = std::make_shared<VecUnit::MemTraceData>(num_threads);
+        auto trace_data = std::make_shared<VecUnit::MemTraceData>(num_threads, core_->mem_profiler() != nullptr);
         trace->data = trace_data;
         for (uint32_t t = thread_start; t < num_threads; ++t) {
           if (!warp.tmask.test(t))
@@ -1427,7 +1440,7 @@ instr_trace_t* Emulator::execute(const Instr &instr, uint32_t wid) {
       case VlsType::VS:
       case VlsType::VSS:
       case VlsType::VSX: {
-        auto trace_data = std::make_shared<VecUnit::MemTraceData>(num_threads);
+        auto trace_data = std::make_shared<VecUnit::MemTraceData>(num_threads, core_->mem_profiler() != nullptr);
         trace->data = trace_data;
         for (uint32_t t = thread_start; t < num_threads; ++t) {
           if (!warp.tmask.test(t))
@@ -1458,7 +1471,22 @@ instr_trace_t* Emulator::execute(const Instr &instr, uint32_t wid) {
         auto trace_data = std::make_shared<TensorUnit::ExeTraceData>();
         trace->data = trace_data;
         assert(warp.tmask.count() == num_threads);
-        tensor_unit_->wmma(wid, tpuArgs.fmt_s, tpuArgs.fmt_d, tpuArgs.step_m, tpuArgs.step_n, rs1_data, rs2_data, rs3_data, rd_data, trace_data.get());
+        // a fused k-group is one micro-op: it also reads the A/B registers
+        // of the group's later k-steps, so they go on the scoreboard too.
+        auto& tcfg = tensor_unit_->config();
+        std::vector<std::vector<reg_data_t>> a_data(tcfg.k_fusion);
+        std::vector<std::vector<reg_data_t>> b_data(tcfg.k_fusion);
+        a_data.at(0) = std::move(rs1_data);
+        b_data.at(0) = std::move(rs2_data);
+        for (uint32_t s = 1; s < tcfg.k_fusion; ++s) {
+          RegOpd ra{RegType::Float, tcfg.a_reg(tpuArgs.step_m, tpuArgs.step_k + s)};
+          RegOpd rb{RegType::Float, tcfg.b_reg(tpuArgs.step_n, tpuArgs.step_k + s)};
+          fetch_registers(a_data.at(s), wid, 0, ra);
+          fetch_registers(b_data.at(s), wid, 1, rb);
+          trace->src_regs.push_back(ra);
+          trace->src_regs.push_back(rb);
+        }
+        tensor_unit_->wmma(wid, tpuArgs.fmt_s, tpuArgs.fmt_d, tpuArgs.step_m, tpuArgs.step_n, tpuArgs.step_k, a_data, b_data, rs3_data, rd_data, trace_data.get());
         rd_write = true;
       } break;
       default:
@@ -109,6 +109,7 @@ void AluUnit::tick() {
 FpuUnit::FpuUnit(const SimContext& ctx, Core* core) : FuncUnit(ctx, core, "fpu-unit") {}
 
 void FpuUnit::tick() {
+	auto& arch = core_->arch();
 	for (uint32_t iw = 0; iw < ISSUE_WIDTH; ++iw) {
 		auto& input = Inputs.at(iw);
 		if (input.empty())
@@ -133,18 +134,18 @@ void FpuUnit::tick() {
 		case FpuType::FMSUB:
 		case FpuType::FNMADD:
 		case FpuType::FNMSUB:
-			output.push(trace, LATENCY_FMA+delay);
+			output.push(trace, arch.fma_latency()+delay);
 			break;
 		case FpuType::FDIV:
-			output.push(trace, LATENCY_FDIV+delay);
+			output.push(trace, arch.fdiv_latency()+delay);
 			break;
 		case FpuType::FSQRT:
-			output.push(trace, LATENCY_FSQRT+delay);
+			output.push(trace, arch.fsqrt_latency()+delay);
 			break;
 		case FpuType::F2I:
 		case FpuType::I2F:
 		case FpuType::F2F:
-			output.push(trace, LATENCY_FCVT+delay);
+			output.push(trace, arch.fcvt_latency()+delay);
 			break;
 		default:
 			std::abort();
@@ -185,6 +186,7 @@ void LsuUnit::tick() {
 		DT(3, this->name() << "-mem-rsp: " << lsu_rsp);
 		auto& entry = state.pending_rd_reqs.at(lsu_rsp.tag);
 		auto trace = entry.trace;
+		BT(LsuRsp, core_->trace_src_, trace->wid, trace->uuid, trace->PC, lsu_rsp.mask.count());
 		assert(entry.count != 0);
 		entry.count -= lsu_rsp.mask.count(); // track remaining
 		if (entry.count == 0) {
@@ -194,6 +196,9 @@ void LsuUnit::tick() {
 			if (entry.eop) {
 				int iw = trace->wid % ISSUE_WIDTH;
 				Outputs.at(iw).push(trace, 1);
+				if (core_->pc_profiler_) {
+					core_->pc_profiler_->mem_response(trace);
+				}
 			}
 		}
 		pending_loads_ -= lsu_rsp.mask.count();
@@ -274,6 +279,9 @@ void LsuUnit::tick() {
 						for (auto addr : trace_data->mem_addrs.at(t)) {
 							pending_addrs_.push_back(addr);
 						}
+						if (core_->mem_profiler_) {
+							core_->mem_profiler_->access(core_->id(), trace->PC, is_write, trace_data->elem_addrs.at(t));
+						}
 					}
 				} else
 			#endif
@@ -284,6 +292,9 @@ void LsuUnit::tick() {
 							continue;
 						pending_addrs_.push_back(trace_data->mem_addrs.at(t));
 					}
+					if (core_->mem_profiler_) {
+						core_->mem_profiler_->access(core_->id(), trace->PC, is_write, pending_addrs_);
+					}
 				}
 				remain_addrs_ = pending_addrs_.size();
 			}
@@ -316,6 +327,10 @@ void LsuUnit::tick() {
 			// send memory request
 			core_->lmem_switch_.at(block_idx)->ReqIn.push(lsu_req);
 			DT(3, this->name() << "-mem-req: " << lsu_req);
+			BT(LsuReq, core_->trace_src_, trace->wid, trace->uuid, lsu_req.addrs.at(0), count | (uint32_t(is_write) << 31));
+			if (core_->pc_profiler_) {
+				core_->pc_profiler_->mem_request(trace);
+			}
 
 			// update stats
 			if (is_write) {
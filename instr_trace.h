@@ -78,6 +78,8 @@ public:
 
   uint64_t issue_time ;
 
+  uint64_t stage_time;  // entry into the current pipeline stage (event trace)
+
   instr_trace_t(uint64_t uuid, const Arch& arch)
     : uuid(uuid)
     , arch(arch)
@@ -96,6 +98,7 @@ public:
     , eop(true)
     , fetch_stall(false)
     , issue_time(SimPlatform::instance().cycles())
+    , stage_time(issue_time)
     , log_once_(false)
   {}
 
@@ -117,6 +120,7 @@ public:
     , eop(rhs.eop)
     , fetch_stall(rhs.fetch_stall)
     , issue_time(rhs.issue_time)
+    , stage_time(rhs.stage_time)
     , log_once_(false)
   {}
 
@@ -17,6 +17,7 @@
 #include <sstream>
 #include <fstream>
 #include <stdlib.h>
+#include <errno.h>
 #include <unistd.h>
 #include <sys/stat.h>
 #include "processor.h"
@@ -29,28 +30,64 @@
 using namespace vortex;
 
 static void show_usage() {
-   std::cout << "Usage: [-c <cores>] [-w <warps>] [-t <threads>] [-v: vector-test] [-s: stats] [-h: help] <program>" << std::endl;
+   std::cout << "Usage: [-C <config file>] [-o <param>=<value>] [-c <cores>] [-w <warps>] [-t <threads>] [-m <tcu tile MxNxK[:kfusion]>] [-v: vector-test] [-s: stats] [-j <stats json file>] [-i <sample interval>[:<csv file>]] [-p <profile file>] [-d <simt profile file>] [-a <memory profile file>] [-r <roofline plot .svg|.html>] [-T <trace json>] [-W <first>:<last> trace cycles] [-K <trace cores, e.g. 0,2-3>] [-b <debug trace>[:<components|all>[:<level>]]] [-e <elf file>] [-h: help] <program>" << std::endl;
 }
 
-uint32_t num_threads = NUM_THREADS;
-uint32_t num_warps = NUM_WARPS;
-uint32_t num_cores = NUM_CORES;
+// strict decimal/hex parse of a command-line number (no sign, no trailing text)
+static bool parse_number(const std::string& str, uint64_t* out) {
+  if (str.empty() || !isdigit((unsigned char)str[0]))
+    return false;
+  char* end = nullptr;
+  errno = 0;
+  auto value = strtoull(str.c_str(), &end, 0);
+  if (*end != '\0' || errno == ERANGE)
+    return false;
+  *out = value;
+  return true;
+}
+
+const char* config_file = nullptr;
+std::vector<std::string> config_params; // applied in order after the config file
 bool showStats = false;
+const char* stats_file = "stats.json";
+uint64_t sample_interval = 0;
+std::string sample_file = "samples.csv";
+const char* profile_file = nullptr;
+const char* simt_profile_file = nullptr;
+const char* mem_profile_file = nullptr;
+const char* roofline_file = nullptr;
+const char* trace_file = nullptr;
+uint64_t trace_start = 0;
+uint64_t trace_end = UINT64_MAX;
+std::vector<uint32_t> trace_cores;
+std::string debug_trace_file;
+std::string debug_trace_components = "all";
+uint32_t debug_trace_level = 2;
+const char* elf_file = nullptr;
 bool vector_test = false;
 const char* program = nullptr;
 
 static void parse_args(int argc, char **argv) {
   	int c;
-  	while ((c = getopt(argc, argv, "t:w:c:vsh")) != -1) {
+  	while ((c = getopt(argc, argv, "C:o:t:w:c:m:j:i:p:d:a:r:T:W:K:b:e:vsh")) != -1) {
     	switch (c) {
+      case 'C':
+        config_file = optarg;
+        break;
+      case 'o':
+        config_params.push_back(optarg);
+        break;
       case 't':
-        num_threads = atoi(optarg);
+        config_params.push_back(std::string("threads=") + optarg);
         break;
       case 'w':
-        num_warps = atoi(optarg);
+        config_params.push_back(std::string("warps=") + optarg);
         break;
 		  case 'c':
-        num_cores = atoi(optarg);
+        config_params.push_back(std::string("cores=") + optarg);
+        break;
+      case 'm':
+        config_params.push_back(std::string("tcu.tile=") + optarg);
         break;
       case 'v':
         vector_test = true;
@@ -58,6 +95,95 @@ static void parse_args(int argc, char **argv) {
       case 's':
         showStats = true;
         break;
+      case 'j':
+        stats_file = optarg;
+        break;
+      case 'i': {
+        std::string arg(optarg);
+        auto sep = arg.find(':');
+        if (!parse_number(arg.substr(0, sep), &sample_interval) || sample_interval == 0) {
+          std::cerr << "Error: invalid sample interval: " << arg << std::endl;
+          show_usage();
+          exit(-1);
+        }
+        if (sep != std::string::npos) {
+          sample_file = arg.substr(sep + 1);
+        }
+      } break;
+      case 'p':
+        profile_file = optarg;
+        break;
+      case 'd':
+        simt_profile_file = optarg;
+        break;
+      case 'a':
+        mem_profile_file = optarg;
+        break;
+      case 'r':
+        roofline_file = optarg;
+        break;
+      case 'T':
+        trace_file = optarg;
+        break;
+      case 'W': {
+        std::string arg(optarg);
+        auto sep = arg.find(':');
+        bool ok = (sep != std::string::npos);
+        if (ok && sep != 0) {
+          ok = parse_number(arg.substr(0, sep), &trace_start);
+        }
+        if (ok && sep + 1 < arg.size()) {
+          ok = parse_number(arg.substr(sep + 1), &trace_end);
+        }
+        if (!ok || trace_start > trace_end) {
+          std::cerr << "Error: invalid trace window: " << arg << std::endl;
+          show_usage();
+          exit(-1);
+        }
+      } break;
+      case 'K': {
+        std::stringstream ss(optarg);
+        std::string item;
+        while (std::getline(ss, item, ',')) {
+          auto sep = item.find('-');
+          uint64_t first, last;
+          bool ok = parse_number(item.substr(0, sep), &first);
+          if (sep == std::string::npos) {
+            last = first;
+          } else {
+            ok = ok && parse_number(item.substr(sep + 1), &last);
+          }
+          if (!ok || first > last || last >= MAX_NUM_CORES) {
+            std::cerr << "Error: invalid trace cores: " << optarg << std::endl;
+            show_usage();
+            exit(-1);
+          }
+          for (uint32_t cid = first; cid <= last; ++cid) {
+            trace_cores.push_back(cid);
+          }
+        }
+      } break;
+      case 'b': {
+        std::string arg(optarg);
+        auto sep = arg.find(':');
+        debug_trace_file = arg.substr(0, sep);
+        if (sep != std::string::npos) {
+          auto sep2 = arg.find(':', sep + 1);
+          debug_trace_components = arg.substr(sep + 1, sep2 - sep - 1);
+          if (sep2 != std::string::npos) {
+            uint64_t level = 0;
+            if (!parse_number(arg.substr(sep2 + 1), &level) || level > UINT32_MAX) {
+              std::cerr << "Error: invalid debug trace level: " << arg << std::endl;
+              show_usage();
+              exit(-1);
+            }
+            debug_trace_level = level;
+          }
+        }
+      } break;
+      case 'e':
+        elf_file = optarg;
+        break;
     	case 'h':
       	show_usage();
       	exit(0);
@@ -84,7 +210,17 @@ int main(int argc, char **argv) {
 
   {
     // create processor configuation
-    Arch arch(num_threads, num_warps, num_cores);
+    Arch arch(NUM_THREADS, NUM_WARPS, NUM_CORES);
+    if (config_file && !arch.load_config(config_file)) {
+      return -1;
+    }
+    for (auto& param : config_params) {
+      if (!arch.set_param(param))
+        return -1;
+    }
+    if (!arch.validate()) {
+      return -1;
+    }
 
     // create memory module
     RAM ram(0, MEM_PAGE_SIZE);
@@ -95,6 +231,35 @@ int main(int argc, char **argv) {
     // attach memory module
     processor.attach_ram(&ram);
 
+    if (sample_interval != 0) {
+      processor.enable_sampling(sample_file.c_str(), sample_interval);
+    }
+
+    if (elf_file && !processor.load_symbols(elf_file)) {
+      return -1;
+    }
+
+    if (profile_file) {
+      processor.enable_profiling(profile_file);
+    }
+
+    if (simt_profile_file) {
+      processor.enable_simt_profiling(simt_profile_file);
+    }
+
+    if (mem_profile_file) {
+      processor.enable_mem_profiling(mem_profile_file);
+    }
+
+    if (!debug_trace_file.empty()
+     && !processor.enable_debug_trace(debug_trace_file.c_str(), debug_trace_components.c_str(), debug_trace_level)) {
+      return -1;
+    }
+
+    if (trace_file) {
+      processor.enable_event_trace(trace_file, trace_start, trace_end, trace_cores);
+    }
+
 	  // setup base DCRs
     const uint64_t startup_addr(STARTUP_ADDR);
     processor.dcr_write(VX_DCR_BASE_STARTUP_ADDR0, startup_addr & 0xffffffff);
@@ -126,6 +291,14 @@ int main(int argc, char **argv) {
     // else continue as normal
     processor.run();
 
+    if (showStats) {
+      processor.show_stats(stats_file);
+    }
+
+    if (roofline_file) {
+      processor.show_roofline(program, roofline_file);
+    }
+
     // read exitcode from @MPM.1
     ram.read(&exitcode, (IO_MPM_ADDR + 8), 4);
   }
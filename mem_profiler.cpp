@@ -0,0 +1,238 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mem_profiler.h"
+#include "symbol_table.h"
+#include "constants.h"
+#include <iomanip>
+#include <algorithm>
+#include <string.h>
+
+using namespace vortex;
+
+static const char* pattern_name(uint32_t pattern) {
+  switch (pattern) {
+  case MemProfiler::Broadcast:    return "broadcast";
+  case MemProfiler::UnitStride:   return "unit";
+  case MemProfiler::Strided:      return "strided";
+  case MemProfiler::Gather:       return "gather";
+  case MemProfiler::BankConflict: return "conflict";
+  default: return "?";
+  }
+}
+
+MemProfiler::pc_stats_t::pc_stats_t()
+  : is_shared(false)
+  , requests(0)
+  , stores(0)
+  , lanes(0)
+  , lines(0)
+  , max_lines(0)
+  , conflict_degree(0)
+  , max_conflict(0)
+  , cold(0)
+{
+  memset(pattern, 0, sizeof(pattern));
+  memset(reuse, 0, sizeof(reuse));
+}
+
+MemProfiler::MemProfiler(const Arch& arch)
+  : line_bits_(log2ceil(L1_LINE_SIZE))
+  , word_bits_(log2ceil(LSU_WORD_SIZE))
+  , num_lmem_banks_(arch.lmem_num_banks())
+  , cores_(arch.num_cores() * arch.num_clusters())
+{}
+
+void MemProfiler::reset() {
+  for (auto& core : cores_) {
+    core.clock = 0;
+    core.last_use.clear();
+  }
+  pcs_.clear();
+}
+
+void MemProfiler::access(uint32_t cid, Word pc, bool is_write, const std::vector<mem_addr_size_t>& addrs) {
+  if (addrs.empty())
+    return;
+  auto addr_type = get_addr_type(addrs.at(0).addr);
+  if (addr_type == AddrType::IO)
+    return;
+
+  auto& entry = pcs_[pc];
+  entry.is_shared = (addr_type == AddrType::Shared);
+  ++entry.requests;
+  entry.stores += is_write;
+  entry.lanes  += addrs.size();
+
+  // classify the lane address sequence
+  uint32_t pattern = Broadcast;
+  if (addrs.size() > 1) {
+    int64_t stride = int64_t(addrs.at(1).addr - addrs.at(0).addr);
+    bool constant = true;
+    for (size_t i = 2; i < addrs.size() && constant; ++i) {
+      constant = (int64_t(addrs.at(i).addr - addrs.at(i-1).addr) == stride);
+    }
+    if (!constant) {
+      pattern = Gather;
+    } else if (stride == 0) {
+      pattern = Broadcast;
+    } else if (stride == int64_t(addrs.at(0).size)) {
+      pattern = UnitStride;
+    } else {
+      pattern = Strided;
+      ++entry.strides[stride];
+    }
+  }
+
+  if (entry.is_shared) {
+    // distinct words per bank serialize; identical words are broadcast
+    lines_.clear();
+    for (auto& a : addrs) {
+      lines_.push_back(a.addr >> word_bits_);
+    }
+    std::sort(lines_.begin(), lines_.end());
+    lines_.erase(std::unique(lines_.begin(), lines_.end()), lines_.end());
+    std::vector<uint32_t> bank_words(num_lmem_banks_, 0);
+    uint32_t degree = 1;
+    for (auto word : lines_) {
+      degree = std::max(degree, ++bank_words.at(word & (num_lmem_banks_ - 1)));
+    }
+    entry.conflict_degree += degree;
+    entry.max_conflict = std::max(entry.max_conflict, degree);
+    if (degree > 1) {
+      pattern = BankConflict;
+    }
+  } else {
+    lines_.clear();
+    for (auto& a : addrs) {
+      lines_.push_back(a.addr >> line_bits_);
+    }
+    std::sort(lines_.begin(), lines_.end());
+    lines_.erase(std::unique(lines_.begin(), lines_.end()), lines_.end());
+    entry.lines += lines_.size();
+    entry.max_lines = std::max<uint32_t>(entry.max_lines, lines_.size());
+
+    // reuse distance in line accesses since the previous touch on this core
+    auto& core = cores_.at(cid);
+    for (auto line : lines_) {
+      auto it = core.last_use.find(line);
+      if (it == core.last_use.end()) {
+        ++entry.cold;
+        core.last_use.emplace(line, core.clock);
+      } else {
+        uint64_t distance = core.clock - it->second;
+        uint32_t bin = std::min<uint32_t>(63 - __builtin_clzll(distance + 1), REUSE_BINS - 1);
+        ++entry.reuse[bin];
+        it->second = core.clock;
+      }
+      ++core.clock;
+    }
+  }
+
+  ++entry.pattern[pattern];
+}
+
+static double ratio(uint64_t num, uint64_t den) {
+  return den ? (double(num) / den) : 0.0;
+}
+
+void MemProfiler::write_report(std::ostream& os, const SymbolTable* symbols) const {
+  // costliest first: cache lines touched (or serialized bank cycles)
+  auto cost = [](const pc_stats_t& s) {
+    return s.is_shared ? s.conflict_degree : s.lines;
+  };
+  std::vector<std::pair<Word, const pc_stats_t*>> sorted;
+  uint64_t totals[PatternCount] = {0};
+  for (auto& it : pcs_) {
+    sorted.emplace_back(it.first, &it.second);
+    for (uint32_t p = 0; p < PatternCount; ++p) {
+      totals[p] += it.second.pattern[p];
+    }
+  }
+  std::sort(sorted.begin(), sorted.end(), [&](const auto& a, const auto& b) {
+    auto ca = cost(*a.second), cb = cost(*b.second);
+    return (ca != cb) ? (ca > cb) : (a.first < b.first);
+  });
+
+  auto flags = os.flags();
+  os << std::fixed << std::setprecision(1);
+
+  os << "# memory access patterns:";
+  for (uint32_t p = 0; p < PatternCount; ++p) {
+    os << " " << pattern_name(p) << "=" << totals[p];
+  }
+  os << std::endl;
+  os << "# lines/req: L1 lines touched per request (global) or bank conflict degree (local)" << std::endl;
+  os << "# reuse: share of line touches reused within 2^k line accesses on the same core; cold: first touches" << std::endl;
+  os << std::setw(12) << "pc"
+     << std::setw(7)  << "space"
+     << std::setw(10) << "requests"
+     << std::setw(8)  << "lanes"
+     << std::setw(11) << "pattern"
+     << std::setw(10) << "lines/req"
+     << std::setw(6)  << "max"
+     << std::setw(8)  << "cold%"
+     << std::setw(8)  << "<2^4%"
+     << std::setw(8)  << "<2^10%"
+     << "  detail" << std::endl;
+
+  for (auto& it : sorted) {
+    auto& s = *it.second;
+    uint32_t dominant = 0;
+    for (uint32_t p = 1; p < PatternCount; ++p) {
+      if (s.pattern[p] > s.pattern[dominant])
+        dominant = p;
+    }
+    uint64_t touches = s.cold, near = 0, mid = 0;
+    for (uint32_t b = 0; b < REUSE_BINS; ++b) {
+      touches += s.reuse[b];
+      if (b < 4) near += s.reuse[b];
+      if (b < 10) mid += s.reuse[b];
+    }
+    os << "  0x" << std::hex << std::setw(8) << std::setfill('0') << it.first << std::dec << std::setfill(' ')
+       << std::setw(7)  << (s.is_shared ? "local" : "global")
+       << std::setw(10) << s.requests
+       << std::setw(8)  << ratio(s.lanes, s.requests)
+       << std::setw(11) << pattern_name(dominant)
+       << std::setw(10) << ratio(s.is_shared ? s.conflict_degree : s.lines, s.requests)
+       << std::setw(6)  << (s.is_shared ? s.max_conflict : s.max_lines);
+    if (s.is_shared) {
+      os << std::setw(8) << "-" << std::setw(8) << "-" << std::setw(8) << "-";
+    } else {
+      os << std::setw(8) << (100.0 * ratio(s.cold, touches))
+         << std::setw(8) << (100.0 * ratio(near, touches))
+         << std::setw(8) << (100.0 * ratio(mid, touches));
+    }
+    os << "  " << (s.stores ? "st" : "ld");
+    for (uint32_t p = 0; p < PatternCount; ++p) {
+      if (s.pattern[p] != 0 && p != dominant) {
+        os << " " << pattern_name(p) << "=" << s.pattern[p];
+      }
+    }
+    if (!s.strides.empty()) {
+      auto top = std::max_element(s.strides.begin(), s.strides.end(), [](const auto& a, const auto& b) {
+        return a.second < b.second;
+      });
+      os << " stride=" << top->first;
+    }
+    if (symbols) {
+      auto sym = symbols->symbol(it.first);
+      if (!sym.empty()) {
+        os << " " << sym;
+      }
+    }
+    os << std::endl;
+  }
+
+  os.flags(flags);
+}
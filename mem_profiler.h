@@ -0,0 +1,85 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include "types.h"
+#include "arch.h"
+
+namespace vortex {
+
+class SymbolTable;
+
+// Classifies the address pattern of every memory instruction leaving the LSU
+// and accumulates per-PC line footprint, reuse distance and local-memory bank
+// conflict statistics. Scalar requests are classified across their lanes;
+// vector requests per thread, on the element stream before line merging.
+class MemProfiler {
+public:
+  enum Pattern {
+    Broadcast,    // all lanes hit the same address
+    UnitStride,   // consecutive lanes access consecutive elements
+    Strided,      // constant stride other than the element size
+    Gather,       // no constant stride
+    BankConflict, // local memory access serialized on a bank
+    PatternCount
+  };
+
+  // reuse distance bins: log2 of the number of line accesses since the last touch
+  static constexpr uint32_t REUSE_BINS = 24;
+
+  MemProfiler(const Arch& arch);
+
+  void reset();
+
+  void access(uint32_t cid, Word pc, bool is_write, const std::vector<mem_addr_size_t>& addrs);
+
+  void write_report(std::ostream& os, const SymbolTable* symbols = nullptr) const;
+
+private:
+
+  struct pc_stats_t {
+    bool     is_shared;
+    uint64_t requests;
+    uint64_t stores;
+    uint64_t lanes;
+    uint64_t pattern[PatternCount];
+    std::map<int64_t, uint64_t> strides;
+    uint64_t lines;
+    uint32_t max_lines;
+    uint64_t conflict_degree;
+    uint32_t max_conflict;
+    uint64_t cold;
+    uint64_t reuse[REUSE_BINS];
+
+    pc_stats_t();
+  };
+
+  struct core_state_t {
+    uint64_t clock; // line accesses seen by this core
+    std::unordered_map<uint64_t, uint64_t> last_use;
+  };
+
+  uint32_t line_bits_;
+  uint32_t word_bits_;
+  uint32_t num_lmem_banks_;
+  std::vector<core_state_t> cores_;
+  std::unordered_map<Word, pc_stats_t> pcs_;
+  std::vector<uint64_t> lines_; // scratch
+};
+
+}
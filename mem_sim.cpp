@@ -30,6 +30,7 @@ private:
 	MemCrossBar::Ptr mem_xbar_;
 	DramSim   dram_sim_;
 	mutable PerfStats perf_stats_;
+	uint16_t  trace_src_;
 	struct DramCallbackArgs {
 		MemSim::Impl* memsim;
 		MemReq request;
@@ -41,6 +42,7 @@ public:
 		: simobject_(simobject)
 		, config_(config)
 		, dram_sim_(config.num_banks, config.block_size, config.clock_ratio)
+		, trace_src_(BinTrace::instance().intern(simobject->name()))
 	{
 		char sname[100];
 		snprintf(sname, 100, "%s-xbar", simobject->name().c_str());
@@ -89,6 +91,7 @@ public:
 						MemRsp mem_rsp{rsp_args->request.tag, rsp_args->request.cid, rsp_args->request.uuid};
 						rsp_args->memsim->mem_xbar_->RspOut.at(rsp_args->bank_id).push(mem_rsp, 1);
 						DT(3, rsp_args->memsim->simobject_->name() << "-mem-rsp" << rsp_args->bank_id << ": " << mem_rsp);
+						BT(DramRsp, rsp_args->memsim->trace_src_, 0, mem_rsp.uuid, rsp_args->request.addr, rsp_args->request.tag);
 					}
 					delete rsp_args;
 				},
@@ -96,6 +99,7 @@ public:
 			);
 
 			DT(3, simobject_->name() << "-mem-req" << i << ": " << mem_req);
+			BT(DramReq, trace_src_, 0, mem_req.uuid, mem_req.addr, mem_req.write);
 			mem_xbar_->ReqOut.at(i).pop();
 		}
 	}
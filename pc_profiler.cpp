@@ -0,0 +1,161 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "pc_profiler.h"
+#include <iomanip>
+#include <algorithm>
+#include <vector>
+
+using namespace vortex;
+
+PcProfiler::PcProfiler(const Arch& arch)
+  : num_threads_(arch.num_threads())
+{}
+
+void PcProfiler::reset() {
+  pcs_.clear();
+  inflight_.clear();
+}
+
+void PcProfiler::decoded(const instr_trace_t* trace) {
+  pcs_[trace->PC].fetch_cycles += SimPlatform::instance().cycles() - trace->issue_time;
+}
+
+void PcProfiler::mem_request(const instr_trace_t* trace) {
+  // only the first request of a multi-request instruction starts the clock
+  inflight_.emplace(trace->uuid, inflight_t{trace->PC, SimPlatform::instance().cycles()});
+}
+
+void PcProfiler::mem_response(const instr_trace_t* trace) {
+  auto it = inflight_.find(trace->uuid);
+  if (it == inflight_.end())
+    return;
+  auto& entry = pcs_[trace->PC];
+  ++entry.mem_ops;
+  entry.mem_latency += SimPlatform::instance().cycles() - it->second.start;
+}
+
+void PcProfiler::committed(const instr_trace_t* trace) {
+  auto& entry = pcs_[trace->PC];
+  ++entry.issues;
+  entry.threads += trace->tmask.count();
+  entry.latency += SimPlatform::instance().cycles() - trace->issue_time;
+  inflight_.erase(trace->uuid);
+}
+
+void PcProfiler::cache_miss(uint32_t level, uint64_t uuid, bool write) {
+  // stores retire before their misses resolve, so only loads are attributed
+  if (write)
+    return;
+  auto it = inflight_.find(uuid);
+  if (it == inflight_.end())
+    return;
+  auto& entry = pcs_[it->second.pc];
+  if (level == 1) {
+    ++entry.l1_misses;
+  } else {
+    ++entry.l2_misses;
+  }
+}
+
+static double ratio(uint64_t num, uint64_t den) {
+  return den ? (double(num) / den) : 0.0;
+}
+
+void PcProfiler::write_report(std::ostream& os, const SymbolTable* symbols) const {
+  std::vector<std::pair<uint64_t, const pc_stats_t*>> sorted;
+  pc_stats_t total;
+  for (auto& it : pcs_) {
+    sorted.emplace_back(it.first, &it.second);
+    auto& pc = it.second;
+    total.issues       += pc.issues;
+    total.fetch_cycles += pc.fetch_cycles;
+    total.ibuf_stalls  += pc.ibuf_stalls;
+    total.scrb_cycles  += pc.scrb_cycles;
+    total.l1_misses    += pc.l1_misses;
+    total.l2_misses    += pc.l2_misses;
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+    auto sa = a.second->stall_cycles(), sb = b.second->stall_cycles();
+    return (sa != sb) ? (sa > sb) : (a.first < b.first);
+  });
+
+  std::unordered_map<uint64_t, std::string> lines;
+  if (symbols) {
+    std::vector<uint64_t> pcs;
+    for (auto& it : sorted) {
+      pcs.push_back(it.first);
+    }
+    lines = symbols->source_lines(pcs);
+  }
+
+  auto flags = os.flags();
+  os << "# per-PC profile: " << sorted.size() << " PCs, " << total.issues << " warp instructions, "
+     << total.stall_cycles() << " stall cycles, " << total.l1_misses << " L1 misses, " << total.l2_misses << " L2 misses" << std::endl;
+  os << "# stall%: share of all stall cycles; fetch: schedule->ibuffer cycles; ibuf: ibuffer-full cycles" << std::endl;
+  os << "# scrb: scoreboard cycles [blocking producer unit %]; mem.lat: avg load latency" << std::endl;
+  os << std::setw(12) << "pc"
+     << std::setw(10) << "issues"
+     << std::setw(8)  << "simt%"
+     << std::setw(8)  << "stall%"
+     << std::setw(10) << "fetch"
+     << std::setw(10) << "ibuf"
+     << std::setw(10) << "scrb"
+     << std::setw(10) << "mem.lat"
+     << std::setw(9)  << "l1.miss"
+     << std::setw(9)  << "l2.miss"
+     << "  symbol" << std::endl;
+
+  os << std::fixed << std::setprecision(1);
+  for (auto& it : sorted) {
+    auto& pc = *it.second;
+    os << "  0x" << std::hex << std::setw(8) << std::setfill('0') << it.first << std::dec << std::setfill(' ')
+       << std::setw(10) << pc.issues
+       << std::setw(8)  << (100.0 * ratio(pc.threads, pc.issues * num_threads_))
+       << std::setw(8)  << (100.0 * ratio(pc.stall_cycles(), total.stall_cycles()))
+       << std::setw(10) << pc.fetch_cycles
+       << std::setw(10) << pc.ibuf_stalls
+       << std::setw(10) << pc.scrb_cycles
+       << std::setw(10) << ratio(pc.mem_latency, pc.mem_ops)
+       << std::setw(9)  << pc.l1_misses
+       << std::setw(9)  << pc.l2_misses;
+    if (symbols) {
+      auto sym = symbols->symbol(it.first);
+      if (!sym.empty()) {
+        os << "  " << sym;
+      }
+    }
+    auto line = lines.find(it.first);
+    if (line != lines.end()) {
+      os << " (" << line->second << ")";
+    }
+    uint64_t scrb_total = 0;
+    for (uint32_t fu = 0; fu < (uint32_t)FUType::Count; ++fu) {
+      scrb_total += pc.scrb_stalls[fu];
+    }
+    if (scrb_total != 0) {
+      os << " [";
+      bool first = true;
+      for (uint32_t fu = 0; fu < (uint32_t)FUType::Count; ++fu) {
+        if (pc.scrb_stalls[fu] == 0)
+          continue;
+        if (!first) os << ", ";
+        os << (FUType)fu << "=" << (100.0 * ratio(pc.scrb_stalls[fu], scrb_total)) << "%";
+        first = false;
+      }
+      os << "]";
+    }
+    os << std::endl;
+  }
+  os.flags(flags);
+}
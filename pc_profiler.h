@@ -0,0 +1,94 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <iostream>
+#include <unordered_map>
+#include <string.h>
+#include "instr_trace.h"
+#include "symbol_table.h"
+
+namespace vortex {
+
+// Per static instruction (PC) accounting of issue counts, pipeline stalls,
+// memory latency and cache misses, aggregated over all cores and warps.
+class PcProfiler {
+public:
+  struct pc_stats_t {
+    uint64_t issues;        // committed warp instructions
+    uint64_t threads;       // committed thread instructions
+    uint64_t latency;       // schedule -> commit cycles
+    uint64_t fetch_cycles;  // schedule -> ibuffer cycles (ibuffer empty behind it)
+    uint64_t ibuf_stalls;   // decode blocked on a full ibuffer
+    uint64_t scrb_cycles;   // cycles blocked at the scoreboard
+    uint64_t scrb_stalls[(int)FUType::Count]; // blocking producers by unit
+    uint64_t mem_ops;       // completed loads
+    uint64_t mem_latency;   // first request -> last response cycles
+    uint64_t l1_misses;
+    uint64_t l2_misses;
+
+    pc_stats_t() {
+      memset(this, 0, sizeof(pc_stats_t));
+    }
+
+    uint64_t stall_cycles() const {
+      return fetch_cycles + ibuf_stalls + scrb_cycles;
+    }
+  };
+
+  PcProfiler(const Arch& arch);
+
+  void reset();
+
+  void ibuf_stall(const instr_trace_t* trace) {
+    ++pcs_[trace->PC].ibuf_stalls;
+  }
+
+  void decoded(const instr_trace_t* trace);
+
+  void scrb_stall(const instr_trace_t* trace, FUType fu_type, bool first) {
+    auto& entry = pcs_[trace->PC];
+    entry.scrb_cycles += first;
+    ++entry.scrb_stalls[(int)fu_type];
+  }
+
+  void mem_request(const instr_trace_t* trace);
+
+  void mem_response(const instr_trace_t* trace);
+
+  void committed(const instr_trace_t* trace);
+
+  // cache miss listener: level 1 = L1 dcache, 2 = L2
+  void cache_miss(uint32_t level, uint64_t uuid, bool write);
+
+  const std::unordered_map<uint64_t, pc_stats_t>& pcs() const {
+    return pcs_;
+  }
+
+  // sorted per-PC report, hottest (most stall cycles) first
+  void write_report(std::ostream& os, const SymbolTable* symbols = nullptr) const;
+
+private:
+
+  struct inflight_t {
+    uint64_t pc;
+    uint64_t start;
+  };
+
+  uint32_t num_threads_;
+  std::unordered_map<uint64_t, pc_stats_t> pcs_;
+  std::unordered_map<uint64_t, inflight_t> inflight_;
+};
+
+}
@@ -0,0 +1,460 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "perf_report.h"
+#include <algorithm>
+#include <iomanip>
+
+using namespace vortex;
+
+static double ratio(uint64_t num, uint64_t den) {
+  return den ? (double(num) / den) : 0.0;
+}
+
+static double percent(uint64_t num, uint64_t den) {
+  return 100.0 * ratio(num, den);
+}
+
+static uint64_t mem_bytes(const ProcessorImpl::PerfStats& perf) {
+  return (perf.mem_reads + perf.mem_writes) * MEM_BLOCK_SIZE;
+}
+
+static PerfReport::CoreStats collect_core(const Core::Ptr& core) {
+  PerfReport::CoreStats stats;
+  stats.id   = core->id();
+  stats.core = core->perf_stats();
+  stats.lmem = core->local_mem()->perf_stats();
+  for (uint32_t b = 0; b < NUM_LSU_BLOCKS; ++b) {
+    stats.coalescer += core->mem_coalescer(b)->perf_stats();
+  }
+#ifdef EXT_TCU_ENABLE
+  stats.tcu = core->tensor_unit()->perf_stats();
+#endif
+#ifdef EXT_V_ENABLE
+  stats.vpu = core->vec_unit()->perf_stats();
+#endif
+  return stats;
+}
+
+static void accumulate(PerfReport::CoreStats& dst, const PerfReport::CoreStats& src) {
+  dst.core      += src.core;
+  dst.lmem      += src.lmem;
+  dst.coalescer += src.coalescer;
+#ifdef EXT_TCU_ENABLE
+  dst.tcu       += src.tcu;
+#endif
+#ifdef EXT_V_ENABLE
+  dst.vpu       += src.vpu;
+#endif
+}
+
+PerfReport::PerfReport(const ProcessorImpl& processor)
+  : arch_(processor.arch())
+  , num_sockets_(0)
+#ifdef EXT_TCU_ENABLE
+  , tcu_step_macs_(0)
+#endif
+{
+  totals_.cycles = 0;
+  totals_.cores.id = 0;
+  totals_.processor = processor.perf_stats();
+
+  for (auto& cluster : processor.clusters()) {
+    ClusterStats cluster_stats;
+    cluster_stats.id   = cluster->id();
+    cluster_stats.perf = cluster->perf_stats();
+    cluster_stats.core_totals.id = cluster_stats.id;
+    totals_.l2cache += cluster_stats.perf.l2cache;
+    for (auto& socket : cluster->sockets()) {
+      SocketStats socket_stats;
+      socket_stats.id   = socket->id();
+      socket_stats.perf = socket->perf_stats();
+      socket_stats.core_totals.id = socket_stats.id;
+      totals_.icache += socket_stats.perf.icache;
+      totals_.dcache += socket_stats.perf.dcache;
+      ++num_sockets_;
+      for (auto& core : socket->cores()) {
+      #ifdef EXT_TCU_ENABLE
+        auto& tcu = core->tensor_unit()->config();
+        tcu_step_macs_ += uint64_t(tcu.tcM) * tcu.tcN * tcu.tcK;
+      #endif
+        auto core_stats = collect_core(core);
+        totals_.cycles = std::max<uint64_t>(totals_.cycles, core_stats.core.cycles);
+        accumulate(totals_.cores, core_stats);
+        accumulate(socket_stats.core_totals, core_stats);
+        socket_stats.cores.push_back(core_stats);
+      }
+      accumulate(cluster_stats.core_totals, socket_stats.core_totals);
+      cluster_stats.sockets.push_back(socket_stats);
+    }
+    clusters_.push_back(cluster_stats);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static void print_core(std::ostream& os, const std::string& name, const PerfReport::CoreStats& stats) {
+  auto& perf = stats.core;
+  os << "PERF: " << name << ": instrs=" << perf.instrs
+     << ", cycles=" << perf.cycles
+     << ", IPC=" << ratio(perf.instrs, perf.cycles) << std::endl;
+  os << "PERF: " << name << ": scheduler idle=" << perf.sched_idle << " (" << percent(perf.sched_idle, perf.cycles) << "%)"
+     << ", scheduler stalls=" << perf.sched_stalls << " (" << percent(perf.sched_stalls, perf.cycles) << "%)"
+     << ", ibuffer stalls=" << perf.ibuf_stalls << " (" << percent(perf.ibuf_stalls, perf.cycles) << "%)"
+     << ", operands stalls=" << perf.opds_stalls << " (" << percent(perf.opds_stalls, perf.cycles) << "%)" << std::endl;
+  os << "PERF: " << name << ": scoreboard stalls=" << perf.scrb_stalls << " (" << percent(perf.scrb_stalls, perf.cycles) << "%)"
+     << " [alu=" << percent(perf.scrb_alu, perf.scrb_stalls) << "%"
+     << ", fpu=" << percent(perf.scrb_fpu, perf.scrb_stalls) << "%"
+     << ", lsu=" << percent(perf.scrb_lsu, perf.scrb_stalls) << "%"
+     << ", sfu=" << percent(perf.scrb_sfu, perf.scrb_stalls) << "%"
+     << ", csrs=" << percent(perf.scrb_csrs, perf.scrb_stalls) << "%"
+     << ", wctl=" << percent(perf.scrb_wctl, perf.scrb_stalls) << "%"
+  #ifdef EXT_V_ENABLE
+     << ", vpu=" << percent(perf.scrb_vpu, perf.scrb_stalls) << "%"
+  #endif
+  #ifdef EXT_TCU_ENABLE
+     << ", tcu=" << percent(perf.scrb_tcu, perf.scrb_stalls) << "%"
+  #endif
+     << "]" << std::endl;
+  os << "PERF: " << name << ": ifetches=" << perf.ifetches
+     << ", ifetch latency=" << ratio(perf.ifetch_latency, perf.ifetches) << " cycles"
+     << ", loads=" << perf.loads
+     << ", load latency=" << ratio(perf.load_latency, perf.loads) << " cycles"
+     << ", stores=" << perf.stores
+     << ", coalescer misses=" << stats.coalescer.misses << std::endl;
+  os << "PERF: " << name << ": lmem reads=" << stats.lmem.reads
+     << ", lmem writes=" << stats.lmem.writes
+     << ", lmem bank stalls=" << stats.lmem.bank_stalls
+     << " (utilization=" << (100.0 - percent(stats.lmem.bank_stalls, stats.lmem.reads + stats.lmem.writes)) << "%)" << std::endl;
+#ifdef EXT_TCU_ENABLE
+  os << "PERF: " << name << ": tcu wmmas=" << stats.tcu.wmmas
+     << ", macs=" << stats.tcu.macs
+     << ", macs/cycle=" << ratio(stats.tcu.macs, perf.cycles)
+     << ", utilization=" << percent(stats.tcu.busy_cycles, perf.cycles) << "%" << std::endl;
+#endif
+#ifdef EXT_V_ENABLE
+  os << "PERF: " << name << ": vpu instrs=" << perf.vinstrs
+     << ", reads=" << stats.vpu.reads
+     << ", writes=" << stats.vpu.writes
+     << ", stalls=" << stats.vpu.stalls
+     << ", dependent stalls=" << stats.vpu.dep_stalls
+     << ", utilization=" << percent(stats.vpu.busy_cycles, perf.cycles) << "%"
+     << ", lane efficiency=" << percent(stats.vpu.lane_cycles, stats.vpu.lane_slots) << "%" << std::endl;
+#endif
+}
+
+static void print_cache(std::ostream& os, const std::string& name, const CacheSim::PerfStats& perf) {
+  os << "PERF: " << name << ": reads=" << perf.reads
+     << ", writes=" << perf.writes
+     << ", read misses=" << perf.read_misses << " (hit ratio=" << (100.0 - percent(perf.read_misses, perf.reads)) << "%)"
+     << ", write misses=" << perf.write_misses << " (hit ratio=" << (100.0 - percent(perf.write_misses, perf.writes)) << "%)"
+     << ", bank stalls=" << perf.bank_stalls
+     << ", mshr stalls=" << perf.mshr_stalls << std::endl;
+}
+
+void PerfReport::print(std::ostream& os) const {
+  auto flags = os.flags();
+  auto precision = os.precision();
+  os << std::fixed << std::setprecision(3);
+
+  // a level's sum is only printed when it differs from the level below
+  for (auto& cluster : clusters_) {
+    for (auto& socket : cluster.sockets) {
+      for (auto& core : socket.cores) {
+        print_core(os, "core" + std::to_string(core.id), core);
+      }
+      if (socket.cores.size() > 1) {
+        print_core(os, "cluster" + std::to_string(cluster.id) + ".socket" + std::to_string(socket.id), socket.core_totals);
+      }
+    }
+    if (cluster.sockets.size() > 1) {
+      print_core(os, "cluster" + std::to_string(cluster.id), cluster.core_totals);
+    }
+  }
+  if (arch_.num_cores() * arch_.num_clusters() > 1) {
+    print_core(os, "total", totals_.cores);
+  }
+
+  print_cache(os, "icache", totals_.icache);
+  print_cache(os, "dcache", totals_.dcache);
+  if (arch_.l2cache().enabled) {
+    print_cache(os, "l2cache", totals_.l2cache);
+  }
+  if (arch_.l3cache().enabled) {
+    print_cache(os, "l3cache", totals_.processor.l3cache);
+  }
+
+  auto& proc = totals_.processor;
+  os << "PERF: memory: reads=" << proc.mem_reads
+     << ", writes=" << proc.mem_writes
+     << ", latency=" << ratio(proc.mem_latency, proc.mem_reads) << " cycles"
+     << ", bank stalls=" << proc.memsim.bank_stalls
+     << ", bandwidth=" << ratio(mem_bytes(proc), totals_.cycles) << " bytes/cycle" << std::endl;
+
+  os.flags(flags);
+  os.precision(precision);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// minimal streaming JSON emitter
+class JsonWriter {
+public:
+  JsonWriter(std::ostream& os) : os_(os), first_(true), depth_(0) {}
+
+  void begin_object(const char* key = nullptr) {
+    this->open(key, '{');
+  }
+
+  void end_object() {
+    this->close('}');
+  }
+
+  void begin_array(const char* key) {
+    this->open(key, '[');
+  }
+
+  void end_array() {
+    this->close(']');
+  }
+
+  void field(const char* key, uint64_t value) {
+    this->key(key);
+    os_ << value;
+  }
+
+  void field(const char* key, double value) {
+    this->key(key);
+    os_ << value;
+  }
+
+private:
+  void key(const char* key) {
+    if (!first_)
+      os_ << ",";
+    os_ << "\n" << std::string(depth_ * 2, ' ');
+    if (key)
+      os_ << "\"" << key << "\": ";
+    first_ = false;
+  }
+
+  void open(const char* key, char c) {
+    if (depth_ != 0)
+      this->key(key);
+    os_ << c;
+    first_ = true;
+    ++depth_;
+  }
+
+  void close(char c) {
+    --depth_;
+    os_ << "\n" << std::string(depth_ * 2, ' ') << c;
+    first_ = false;
+    if (depth_ == 0)
+      os_ << "\n";
+  }
+
+  std::ostream& os_;
+  bool first_;
+  uint32_t depth_;
+};
+
+}
+
+static void write_cache(JsonWriter& js, const char* name, const CacheSim::PerfStats& perf) {
+  js.begin_object(name);
+  js.field("reads", perf.reads);
+  js.field("writes", perf.writes);
+  js.field("read_misses", perf.read_misses);
+  js.field("write_misses", perf.write_misses);
+  js.field("evictions", perf.evictions);
+  js.field("bank_stalls", perf.bank_stalls);
+  js.field("mshr_stalls", perf.mshr_stalls);
+  js.field("read_hit_ratio", 1.0 - ratio(perf.read_misses, perf.reads));
+  js.field("write_hit_ratio", 1.0 - ratio(perf.write_misses, perf.writes));
+  js.end_object();
+}
+
+static void write_core(JsonWriter& js, const char* key, const PerfReport::CoreStats& stats) {
+  auto& perf = stats.core;
+  js.begin_object(key);
+  js.field("id", uint64_t(stats.id));
+  js.field("cycles", perf.cycles);
+  js.field("instrs", perf.instrs);
+  js.field("ipc", ratio(perf.instrs, perf.cycles));
+  js.field("fpu_flops", perf.fpu_flops);
+
+  js.begin_object("stalls");
+  js.field("sched_idle", perf.sched_idle);
+  js.field("sched", perf.sched_stalls);
+  js.field("ibuffer", perf.ibuf_stalls);
+  js.field("operands", perf.opds_stalls);
+  js.field("scoreboard", perf.scrb_stalls);
+  js.begin_object("scoreboard_units");
+  js.field("alu", perf.scrb_alu);
+  js.field("fpu", perf.scrb_fpu);
+  js.field("lsu", perf.scrb_lsu);
+  js.field("sfu", perf.scrb_sfu);
+  js.field("csrs", perf.scrb_csrs);
+  js.field("wctl", perf.scrb_wctl);
+#ifdef EXT_V_ENABLE
+  js.field("vpu", perf.scrb_vpu);
+#endif
+#ifdef EXT_TCU_ENABLE
+  js.field("tcu", perf.scrb_tcu);
+#endif
+  js.end_object();
+  js.end_object();
+
+  js.begin_object("memory");
+  js.field("ifetches", perf.ifetches);
+  js.field("loads", perf.loads);
+  js.field("stores", perf.stores);
+  js.field("ifetch_latency", ratio(perf.ifetch_latency, perf.ifetches));
+  js.field("load_latency", ratio(perf.load_latency, perf.loads));
+  js.field("coalescer_misses", stats.coalescer.misses);
+  js.end_object();
+
+  js.begin_object("lmem");
+  js.field("reads", stats.lmem.reads);
+  js.field("writes", stats.lmem.writes);
+  js.field("bank_stalls", stats.lmem.bank_stalls);
+  js.end_object();
+
+#ifdef EXT_TCU_ENABLE
+  js.begin_object("tcu");
+  js.field("wmmas", stats.tcu.wmmas);
+  js.field("macs", stats.tcu.macs);
+  js.field("latency", stats.tcu.latency);
+  js.field("busy_cycles", stats.tcu.busy_cycles);
+  js.field("macs_per_cycle", ratio(stats.tcu.macs, perf.cycles));
+  js.field("utilization", ratio(stats.tcu.busy_cycles, perf.cycles));
+  js.end_object();
+#endif
+
+#ifdef EXT_V_ENABLE
+  js.begin_object("vpu");
+  js.field("instrs", perf.vinstrs);
+  js.field("reads", stats.vpu.reads);
+  js.field("writes", stats.vpu.writes);
+  js.field("stalls", stats.vpu.stalls);
+  js.field("dep_stalls", stats.vpu.dep_stalls);
+  js.field("busy_cycles", stats.vpu.busy_cycles);
+  js.field("lane_cycles", stats.vpu.lane_cycles);
+  js.field("lane_slots", stats.vpu.lane_slots);
+  js.field("flops", stats.vpu.flops);
+  js.field("utilization", ratio(stats.vpu.busy_cycles, perf.cycles));
+  js.field("lane_efficiency", ratio(stats.vpu.lane_cycles, stats.vpu.lane_slots));
+  js.end_object();
+#endif
+
+  js.end_object();
+}
+
+static void write_cache_config(JsonWriter& js, const char* name, const cache_params_t& cache) {
+  js.begin_object(name);
+  js.field("enabled", uint64_t(cache.enabled));
+  js.field("size", uint64_t(cache.size));
+  js.field("ways", uint64_t(cache.num_ways));
+  js.field("banks", uint64_t(cache.num_banks));
+  js.field("mshr", uint64_t(cache.mshr_size));
+  js.field("writeback", uint64_t(cache.writeback));
+  js.field("latency", uint64_t(cache.latency));
+  js.end_object();
+}
+
+void PerfReport::write_json(std::ostream& os) const {
+  JsonWriter js(os);
+  js.begin_object();
+
+  js.begin_object("config");
+  js.field("num_clusters", uint64_t(arch_.num_clusters()));
+  js.field("num_cores", uint64_t(arch_.num_cores()));
+  js.field("num_warps", uint64_t(arch_.num_warps()));
+  js.field("num_threads", uint64_t(arch_.num_threads()));
+  js.field("socket_size", uint64_t(arch_.socket_size()));
+  js.field("num_sockets", uint64_t(num_sockets_));
+  js.field("icaches_per_socket", uint64_t(NUM_ICACHES));
+  js.field("dcaches_per_socket", uint64_t(NUM_DCACHES));
+  js.field("ibuf_size", uint64_t(arch_.ibuf_size()));
+  js.field("lmem_banks", uint64_t(arch_.lmem_num_banks()));
+  js.field("mem_banks", uint64_t(arch_.mem_num_banks()));
+  js.field("mem_clock_ratio", double(arch_.mem_clock_ratio()));
+#ifdef EXT_TCU_ENABLE
+  js.field("tcu_step_macs", tcu_step_macs_);
+#endif
+#ifdef EXT_V_ENABLE
+  js.field("vpu_lanes", uint64_t(arch_.vpu_num_lanes()));
+  js.field("vpu_lane_width", uint64_t(arch_.vpu_lane_width()));
+  js.field("vpu_chaining", uint64_t(arch_.vpu_chaining()));
+#endif
+  write_cache_config(js, "icache", arch_.icache());
+  write_cache_config(js, "dcache", arch_.dcache());
+  write_cache_config(js, "l2cache", arch_.l2cache());
+  write_cache_config(js, "l3cache", arch_.l3cache());
+  js.end_object();
+
+  auto& proc = totals_.processor;
+  js.begin_object("summary");
+  js.field("cycles", totals_.cycles);
+  js.field("instrs", totals_.cores.core.instrs);
+  js.field("ipc", ratio(totals_.cores.core.instrs, totals_.cycles));
+  js.field("mem_bandwidth", ratio(mem_bytes(proc), totals_.cycles));
+  js.end_object();
+
+  write_core(js, "cores", totals_.cores);
+
+  js.begin_object("caches");
+  write_cache(js, "icache", totals_.icache);
+  write_cache(js, "dcache", totals_.dcache);
+  write_cache(js, "l2cache", totals_.l2cache);
+  write_cache(js, "l3cache", proc.l3cache);
+  js.end_object();
+
+  js.begin_object("memory");
+  js.field("reads", proc.mem_reads);
+  js.field("writes", proc.mem_writes);
+  js.field("bank_stalls", proc.memsim.bank_stalls);
+  js.field("latency", ratio(proc.mem_latency, proc.mem_reads));
+  js.field("bytes", mem_bytes(proc));
+  js.end_object();
+
+  js.begin_array("clusters");
+  for (auto& cluster : clusters_) {
+    js.begin_object();
+    js.field("id", uint64_t(cluster.id));
+    write_core(js, "core_totals", cluster.core_totals);
+    write_cache(js, "l2cache", cluster.perf.l2cache);
+    js.begin_array("sockets");
+    for (auto& socket : cluster.sockets) {
+      js.begin_object();
+      js.field("id", uint64_t(socket.id));
+      write_core(js, "core_totals", socket.core_totals);
+      write_cache(js, "icache", socket.perf.icache);
+      write_cache(js, "dcache", socket.perf.dcache);
+      js.begin_array("cores");
+      for (auto& core : socket.cores) {
+        write_core(js, nullptr, core);
+      }
+      js.end_array();
+      js.end_object();
+    }
+    js.end_array();
+    js.end_object();
+  }
+  js.end_array();
+
+  js.end_object();
+}
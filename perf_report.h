@@ -0,0 +1,89 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include "processor_impl.h"
+
+namespace vortex {
+
+// Host-side snapshot of every performance counter in the processor,
+// collected by walking the cluster -> socket -> core hierarchy.
+class PerfReport {
+public:
+  struct CoreStats {
+    uint32_t id;
+    Core::PerfStats core;
+    LocalMem::PerfStats lmem;
+    MemCoalescer::PerfStats coalescer;
+  #ifdef EXT_TCU_ENABLE
+    TensorUnit::PerfStats tcu;
+  #endif
+  #ifdef EXT_V_ENABLE
+    VecUnit::PerfStats vpu;
+  #endif
+  };
+
+  struct SocketStats {
+    uint32_t id;
+    Socket::PerfStats perf;
+    CoreStats core_totals;  // summed over the socket's cores, like Totals::cores
+    std::vector<CoreStats> cores;
+  };
+
+  struct ClusterStats {
+    uint32_t id;
+    Cluster::PerfStats perf;
+    CoreStats core_totals;  // summed over the cluster's cores, like Totals::cores
+    std::vector<SocketStats> sockets;
+  };
+
+  // processor-wide totals
+  struct Totals {
+    uint64_t cycles;   // elapsed cycles, i.e. the slowest core's
+    CoreStats cores;   // summed over cores, cycles included: ratios are per core-cycle
+    CacheSim::PerfStats icache;
+    CacheSim::PerfStats dcache;
+    CacheSim::PerfStats l2cache;
+    ProcessorImpl::PerfStats processor;
+  };
+
+  PerfReport(const ProcessorImpl& processor);
+
+  const Totals& totals() const {
+    return totals_;
+  }
+
+  const std::vector<ClusterStats>& clusters() const {
+    return clusters_;
+  }
+
+  // human-readable summary
+  void print(std::ostream& os) const;
+
+  // machine-readable dump for dashboards
+  void write_json(std::ostream& os) const;
+
+private:
+  const Arch& arch_;
+  std::vector<ClusterStats> clusters_;
+  Totals totals_;
+  uint32_t num_sockets_;
+#ifdef EXT_TCU_ENABLE
+  uint64_t tcu_step_macs_;  // multipliers summed over every core's step shape
+#endif
+};
+
+}
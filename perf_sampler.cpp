@@ -0,0 +1,118 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "perf_sampler.h"
+#include "processor_impl.h"
+
+using namespace vortex;
+
+PerfSampler::PerfSampler(const ProcessorImpl& processor, const std::string& filename, uint64_t interval)
+  : processor_(processor)
+  , ofs_(filename)
+  , interval_(interval)
+{
+  if (!ofs_) {
+    std::cout << "Error: cannot open sample file: " << filename << std::endl;
+    std::abort();
+  }
+  if (interval_ == 0) {
+    std::cout << "Error: invalid sampling interval" << std::endl;
+    std::abort();
+  }
+  num_cores_ = processor.arch().num_cores() * processor.arch().num_clusters();
+  ofs_ << "cycle,instrs,ipc,sched_idle,scrb_stalls,loads,stores"
+       << ",dcache_reads,dcache_misses,l2cache_misses,lmem_reads,lmem_writes"
+       << ",mem_reads,mem_writes,mem_bw,tcu_macs,tcu_busy,vpu_busy" << std::endl;
+  this->reset();
+}
+
+PerfSampler::~PerfSampler() {
+  ofs_.flush();
+}
+
+void PerfSampler::reset() {
+  next_sample_ = interval_;
+  last_cycle_ = 0;
+  last_ = counters_t();
+}
+
+PerfSampler::counters_t PerfSampler::read_counters() const {
+  counters_t c = counters_t();
+  auto proc_perf = processor_.perf_stats();
+  c.mem_reads  = proc_perf.mem_reads;
+  c.mem_writes = proc_perf.mem_writes;
+  for (auto& cluster : processor_.clusters()) {
+    c.l2cache_misses += cluster->perf_stats().l2cache.read_misses;
+    for (auto& socket : cluster->sockets()) {
+      auto dcache = socket->perf_stats().dcache;
+      c.dcache_reads  += dcache.reads;
+      c.dcache_misses += dcache.read_misses + dcache.write_misses;
+      for (auto& core : socket->cores()) {
+        auto& perf = core->perf_stats();
+        c.instrs      += perf.instrs;
+        c.sched_idle  += perf.sched_idle;
+        c.scrb_stalls += perf.scrb_stalls;
+        c.loads       += perf.loads;
+        c.stores      += perf.stores;
+        auto& lmem = core->local_mem()->perf_stats();
+        c.lmem_reads  += lmem.reads;
+        c.lmem_writes += lmem.writes;
+      #ifdef EXT_TCU_ENABLE
+        auto& tcu = core->tensor_unit()->perf_stats();
+        c.tcu_busy += tcu.busy_cycles;
+        c.tcu_macs += tcu.macs;
+      #endif
+      #ifdef EXT_V_ENABLE
+        c.vpu_busy += core->vec_unit()->perf_stats().busy_cycles;
+      #endif
+      }
+    }
+  }
+  return c;
+}
+
+void PerfSampler::sample(uint64_t cycle) {
+  auto cur = this->read_counters();
+  double cycles = double(cycle - last_cycle_);
+  double core_cycles = cycles * num_cores_;
+  uint64_t mem_bytes = ((cur.mem_reads - last_.mem_reads) + (cur.mem_writes - last_.mem_writes)) * MEM_BLOCK_SIZE;
+  ofs_ << cycle
+       << "," << (cur.instrs - last_.instrs)
+       << "," << ((cur.instrs - last_.instrs) / cycles)
+       << "," << (cur.sched_idle - last_.sched_idle)
+       << "," << (cur.scrb_stalls - last_.scrb_stalls)
+       << "," << (cur.loads - last_.loads)
+       << "," << (cur.stores - last_.stores)
+       << "," << (cur.dcache_reads - last_.dcache_reads)
+       << "," << (cur.dcache_misses - last_.dcache_misses)
+       << "," << (cur.l2cache_misses - last_.l2cache_misses)
+       << "," << (cur.lmem_reads - last_.lmem_reads)
+       << "," << (cur.lmem_writes - last_.lmem_writes)
+       << "," << (cur.mem_reads - last_.mem_reads)
+       << "," << (cur.mem_writes - last_.mem_writes)
+       << "," << (mem_bytes / cycles)
+       << "," << (cur.tcu_macs - last_.tcu_macs)
+       << "," << ((cur.tcu_busy - last_.tcu_busy) / core_cycles)
+       << "," << ((cur.vpu_busy - last_.vpu_busy) / core_cycles)
+       << "\n";
+  last_ = cur;
+  last_cycle_ = cycle;
+  next_sample_ = cycle + interval_;
+}
+
+void PerfSampler::finalize(uint64_t cycle) {
+  if (cycle > last_cycle_) {
+    this->sample(cycle);
+  }
+  ofs_.flush();
+}
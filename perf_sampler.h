@@ -0,0 +1,75 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <stdint.h>
+
+namespace vortex {
+
+class ProcessorImpl;
+
+// Periodic counter sampler: every <interval> cycles it appends the per-interval
+// deltas of a fixed set of processor-wide counters as one CSV row.
+class PerfSampler {
+public:
+  PerfSampler(const ProcessorImpl& processor, const std::string& filename, uint64_t interval);
+  ~PerfSampler();
+
+  void reset();
+
+  void tick(uint64_t cycle) {
+    if (cycle >= next_sample_) {
+      this->sample(cycle);
+    }
+  }
+
+  // flush the trailing partial interval
+  void finalize(uint64_t cycle);
+
+private:
+
+  struct counters_t {
+    uint64_t instrs;
+    uint64_t sched_idle;
+    uint64_t scrb_stalls;
+    uint64_t loads;
+    uint64_t stores;
+    uint64_t dcache_reads;
+    uint64_t dcache_misses;
+    uint64_t l2cache_misses;
+    uint64_t lmem_reads;
+    uint64_t lmem_writes;
+    uint64_t mem_reads;
+    uint64_t mem_writes;
+    uint64_t tcu_busy;
+    uint64_t tcu_macs;
+    uint64_t vpu_busy;
+  };
+
+  counters_t read_counters() const;
+
+  void sample(uint64_t cycle);
+
+  const ProcessorImpl& processor_;
+  std::ofstream ofs_;
+  uint64_t interval_;
+  uint64_t next_sample_;
+  uint64_t last_cycle_;
+  uint32_t num_cores_;
+  counters_t last_;
+};
+
+}
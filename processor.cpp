@@ -13,6 +13,10 @@
 
 #include "processor.h"
 #include "processor_impl.h"
+#include "perf_report.h"
+#include "roofline.h"
+#include "bin_trace.h"
+#include <fstream>
 
 using namespace vortex;
 
@@ -26,10 +30,10 @@ ProcessorImpl::ProcessorImpl(const Arch& arch)
 
   // create memory simulator
   memsim_ = MemSim::Create("dram", MemSim::Config{
-    PLATFORM_MEMORY_NUM_BANKS,
+    arch.mem_num_banks(),
     L3_MEM_PORTS,
     MEM_BLOCK_SIZE,
-    MEM_CLOCK_RATIO
+    arch.mem_clock_ratio()
   });
 
   // create clusters
@@ -38,20 +42,21 @@ ProcessorImpl::ProcessorImpl(const Arch& arch)
   }
 
   // create L3 cache
+  auto& l3 = arch.l3cache();
   l3cache_ = CacheSim::Create("l3cache", CacheSim::Config{
-    !L3_ENABLED,
-    log2ceil(L3_CACHE_SIZE),  // C
+    !l3.enabled,
+    uint8_t(log2ceil(l3.size)), // C
     log2ceil(MEM_BLOCK_SIZE), // L
     log2ceil(L2_LINE_SIZE),   // W
-    log2ceil(L3_NUM_WAYS),    // A
-    log2ceil(L3_NUM_BANKS),   // B
+    uint8_t(log2ceil(l3.num_ways)), // A
+    uint8_t(log2ceil(l3.num_banks)), // B
     XLEN,                     // address bits
     L3_NUM_REQS,              // request size
     L3_MEM_PORTS,             // memory ports
-    L3_WRITEBACK,             // write-back
+    l3.writeback,             // write-back
     false,                    // write response
-    L3_MSHR_SIZE,             // mshr size
-    2,                        // pipeline latency
+    uint16_t(l3.mshr_size),   // mshr size
+    uint8_t(l3.latency),      // pipeline latency
     }
   );
 
@@ -71,15 +76,19 @@ ProcessorImpl::ProcessorImpl(const Arch& arch)
 
   // set up memory profiling
   for (uint32_t i = 0; i < L3_MEM_PORTS; ++i) {
-    memsim_->MemReqPorts.at(i).tx_callback([&](const MemReq& req, uint64_t cycle){
-      __unused (cycle);
+    memsim_->MemReqPorts.at(i).tx_callback([&, i](const MemReq& req, uint64_t cycle){
       perf_mem_reads_  += !req.write;
       perf_mem_writes_ += req.write;
       perf_mem_pending_reads_ += !req.write;
+      if (event_trace_) {
+        event_trace_->dram_request(i, req, cycle);
+      }
     });
-    memsim_->MemRspPorts.at(i).tx_callback([&](const MemRsp&, uint64_t cycle){
-      __unused (cycle);
+    memsim_->MemRspPorts.at(i).tx_callback([&, i](const MemRsp& rsp, uint64_t cycle){
       --perf_mem_pending_reads_;
+      if (event_trace_) {
+        event_trace_->dram_response(i, rsp, cycle);
+      }
     });
   }
 
@@ -100,6 +109,7 @@ ProcessorImpl::ProcessorImpl(const Arch& arch)
 }
 
 ProcessorImpl::~ProcessorImpl() {
+  BinTrace::instance().close();
   SimPlatform::instance().finalize();
 }
 
@@ -116,14 +126,41 @@ void ProcessorImpl::set_satp(uint64_t satp) {
 }
 #endif
 
+template <typename Profiler>
+static void write_profile(const Profiler& profiler, const std::string& filename, const SymbolTable& symbols) {
+  std::ofstream ofs(filename);
+  if (!ofs) {
+    std::cerr << "Error: cannot open profile file: " << filename << std::endl;
+    return;
+  }
+  profiler.write_report(ofs, symbols.empty() ? nullptr : &symbols);
+}
+
 int ProcessorImpl::run() {
   SimPlatform::instance().reset();
   this->reset();
 
   bool done;
   int exitcode = 0;
+  uint64_t cycles = 0;
+  if (sampler_) {
+    sampler_->reset();
+  }
+  if (pc_profiler_) {
+    pc_profiler_->reset();
+  }
+  if (simt_profiler_) {
+    simt_profiler_->reset();
+  }
+  if (mem_profiler_) {
+    mem_profiler_->reset();
+  }
   do {
     SimPlatform::instance().tick();
+    ++cycles;
+    if (sampler_) {
+      sampler_->tick(cycles);
+    }
     done = true;
     for (auto cluster : clusters_) {
       if (cluster->running()) {
@@ -135,6 +172,20 @@ int ProcessorImpl::run() {
     perf_mem_latency_ += perf_mem_pending_reads_;
   } while (!done);
 
+  if (sampler_) {
+    sampler_->finalize(cycles);
+  }
+
+  if (pc_profiler_) {
+    write_profile(*pc_profiler_, pc_profile_file_, symbols_);
+  }
+  if (simt_profiler_) {
+    write_profile(*simt_profiler_, simt_profile_file_, symbols_);
+  }
+  if (mem_profiler_) {
+    write_profile(*mem_profiler_, mem_profile_file_, symbols_);
+  }
+
   return exitcode;
 }
 
@@ -149,6 +200,81 @@ void ProcessorImpl::dcr_write(uint32_t addr, uint32_t value) {
   dcrs_.write(addr, value);
 }
 
+void ProcessorImpl::enable_sampling(const std::string& filename, uint64_t interval) {
+  sampler_ = std::make_unique<PerfSampler>(*this, filename, interval);
+}
+
+bool ProcessorImpl::load_symbols(const std::string& elf_file) {
+  return symbols_.load(elf_file);
+}
+
+void ProcessorImpl::enable_profiling(const std::string& report_file) {
+  pc_profiler_ = std::make_unique<PcProfiler>(arch_);
+  pc_profile_file_ = report_file;
+  auto profiler = pc_profiler_.get();
+  for (auto& cluster : clusters_) {
+    cluster->l2cache()->set_miss_callback([profiler](uint32_t, uint64_t uuid, bool write) {
+      profiler->cache_miss(2, uuid, write);
+    });
+    for (auto& socket : cluster->sockets()) {
+      socket->dcaches()->set_miss_callback([profiler](uint32_t, uint64_t uuid, bool write) {
+        profiler->cache_miss(1, uuid, write);
+      });
+      for (auto& core : socket->cores()) {
+        core->set_pc_profiler(profiler);
+      }
+    }
+  }
+}
+
+void ProcessorImpl::enable_simt_profiling(const std::string& report_file) {
+  simt_profiler_ = std::make_unique<SimtProfiler>(arch_);
+  simt_profile_file_ = report_file;
+  for (auto& cluster : clusters_) {
+    for (auto& socket : cluster->sockets()) {
+      for (auto& core : socket->cores()) {
+        core->set_simt_profiler(simt_profiler_.get());
+      }
+    }
+  }
+}
+
+void ProcessorImpl::enable_mem_profiling(const std::string& report_file) {
+  mem_profiler_ = std::make_unique<MemProfiler>(arch_);
+  mem_profile_file_ = report_file;
+  for (auto& cluster : clusters_) {
+    for (auto& socket : cluster->sockets()) {
+      for (auto& core : socket->cores()) {
+        core->set_mem_profiler(mem_profiler_.get());
+      }
+    }
+  }
+}
+
+void ProcessorImpl::enable_event_trace(const std::string& filename,
+                                       uint64_t start_cycle,
+                                       uint64_t end_cycle,
+                                       const std::vector<uint32_t>& cores) {
+  event_trace_ = std::make_unique<EventTrace>(arch_, filename, start_cycle, end_cycle, cores);
+  auto event_trace = event_trace_.get();
+  l3cache_->set_fill_callback([event_trace](uint32_t cid, uint64_t uuid, uint64_t addr, uint64_t alloc_cycle) {
+    event_trace->mshr("l3", cid, uuid, addr, alloc_cycle);
+  });
+  for (auto& cluster : clusters_) {
+    cluster->l2cache()->set_fill_callback([event_trace](uint32_t cid, uint64_t uuid, uint64_t addr, uint64_t alloc_cycle) {
+      event_trace->mshr("l2", cid, uuid, addr, alloc_cycle);
+    });
+    for (auto& socket : cluster->sockets()) {
+      socket->dcaches()->set_fill_callback([event_trace](uint32_t cid, uint64_t uuid, uint64_t addr, uint64_t alloc_cycle) {
+        event_trace->mshr("l1", cid, uuid, addr, alloc_cycle);
+      });
+      for (auto& core : socket->cores()) {
+        core->set_event_trace(event_trace);
+      }
+    }
+  }
+}
+
 ProcessorImpl::PerfStats ProcessorImpl::perf_stats() const {
   ProcessorImpl::PerfStats perf;
   perf.mem_reads   = perf_mem_reads_;
@@ -196,6 +322,77 @@ void Processor::dcr_write(uint32_t addr, uint32_t value) {
   return impl_->dcr_write(addr, value);
 }
 
+void Processor::enable_sampling(const char* filename, uint64_t interval) {
+  impl_->enable_sampling(filename, interval);
+}
+
+bool Processor::load_symbols(const char* elf_file) {
+  return impl_->load_symbols(elf_file);
+}
+
+void Processor::enable_profiling(const char* report_file) {
+  impl_->enable_profiling(report_file);
+}
+
+void Processor::enable_simt_profiling(const char* report_file) {
+  impl_->enable_simt_profiling(report_file);
+}
+
+void Processor::enable_mem_profiling(const char* report_file) {
+  impl_->enable_mem_profiling(report_file);
+}
+
+void Processor::enable_event_trace(const char* filename,
+                                   uint64_t start_cycle,
+                                   uint64_t end_cycle,
+                                   const std::vector<uint32_t>& cores) {
+  impl_->enable_event_trace(filename, start_cycle, end_cycle, cores);
+}
+
+bool Processor::enable_debug_trace(const char* filename, const char* components, uint32_t level) {
+  return BinTrace::instance().open(filename, components, level);
+}
+
+void Processor::show_stats(const char* json_file) const {
+  PerfReport report(*impl_);
+  report.print(std::cout);
+  if (json_file) {
+    std::ofstream ofs(json_file);
+    if (!ofs) {
+      std::cerr << "Error: cannot open stats file: " << json_file << std::endl;
+      return;
+    }
+    report.write_json(ofs);
+  }
+}
+
+void Processor::show_roofline(const char* kernel, const char* plot_file) const {
+  Roofline roofline(*impl_, kernel);
+  roofline.print(std::cout);
+  if (plot_file) {
+    std::string filename(plot_file);
+    auto dot = filename.find_last_of('.');
+    auto stem = filename.substr(0, dot);
+    bool is_html = (dot != std::string::npos && filename.substr(dot) == ".html");
+    std::ofstream ofs(filename);
+    if (!ofs) {
+      std::cerr << "Error: cannot open roofline file: " << filename << std::endl;
+      return;
+    }
+    if (is_html) {
+      roofline.write_html(ofs);
+    } else {
+      roofline.write_svg(ofs);
+    }
+    std::ofstream csv(stem + ".csv");
+    if (!csv) {
+      std::cerr << "Error: cannot open roofline file: " << stem << ".csv" << std::endl;
+      return;
+    }
+    roofline.write_csv(csv);
+  }
+}
+
 #ifdef VM_ENABLE
 int16_t Processor::set_satp_by_addr(uint64_t base_addr) {
   uint16_t asid = 0;
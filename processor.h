@@ -14,6 +14,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <vector>
 #include <VX_config.h>
 #include <mem.h>
 
@@ -36,6 +37,39 @@ public:
   int run();
 
   void dcr_write(uint32_t addr, uint32_t value);
+
+  // append counter deltas to a CSV file every <interval> cycles
+  void enable_sampling(const char* filename, uint64_t interval);
+
+  // kernel ELF used to symbolize the profile reports
+  bool load_symbols(const char* elf_file);
+
+  // write a per-PC hotspot profile at the end of the run
+  void enable_profiling(const char* report_file);
+
+  // write a SIMT efficiency and divergence report at the end of the run
+  void enable_simt_profiling(const char* report_file);
+
+  // write a memory access pattern report at the end of the run
+  void enable_mem_profiling(const char* report_file);
+
+  // write a Chrome trace-event (Perfetto) JSON of the pipeline, caches, DRAM and TCU;
+  // only cycles in [start_cycle, end_cycle] and the listed cores (all if empty) are kept
+  void enable_event_trace(const char* filename,
+                          uint64_t start_cycle,
+                          uint64_t end_cycle,
+                          const std::vector<uint32_t>& cores);
+
+  // binary debug trace of the listed components (comma list or "all") up to
+  // <level>, decoded offline with scripts/decode_trace.py
+  bool enable_debug_trace(const char* filename, const char* components, uint32_t level);
+
+  // print the end-of-run statistics and optionally dump them as JSON
+  void show_stats(const char* json_file = nullptr) const;
+
+  // print the roofline summary and optionally plot it (.svg or .html) next to a .csv of the data points
+  void show_roofline(const char* kernel, const char* plot_file = nullptr) const;
+
 #ifdef VM_ENABLE
   bool is_satp_unset();
   uint8_t get_satp_mode();
@@ -18,6 +18,7 @@
 #include "constants.h"
 #include "dcrs.h"
 #include "cluster.h"
+#include "perf_sampler.h"
 
 namespace vortex {
 
@@ -40,12 +41,35 @@ public:
 
   void dcr_write(uint32_t addr, uint32_t value);
 
+  void enable_sampling(const std::string& filename, uint64_t interval);
+
+  bool load_symbols(const std::string& elf_file);
+
+  void enable_profiling(const std::string& report_file);
+
+  void enable_simt_profiling(const std::string& report_file);
+
+  void enable_mem_profiling(const std::string& report_file);
+
+  void enable_event_trace(const std::string& filename,
+                          uint64_t start_cycle,
+                          uint64_t end_cycle,
+                          const std::vector<uint32_t>& cores);
+
 #ifdef VM_ENABLE
   void set_satp(uint64_t satp);
 #endif
 
   PerfStats perf_stats() const;
 
+  const std::vector<std::shared_ptr<Cluster>>& clusters() const {
+    return clusters_;
+  }
+
+  const Arch& arch() const {
+    return arch_;
+  }
+
 private:
 
   void reset();
@@ -55,6 +79,15 @@ private:
   DCRS dcrs_;
   MemSim::Ptr memsim_;
   CacheSim::Ptr l3cache_;
+  std::unique_ptr<PerfSampler> sampler_;
+  SymbolTable symbols_;
+  std::unique_ptr<PcProfiler> pc_profiler_;
+  std::string pc_profile_file_;
+  std::unique_ptr<SimtProfiler> simt_profiler_;
+  std::string simt_profile_file_;
+  std::unique_ptr<MemProfiler> mem_profiler_;
+  std::string mem_profile_file_;
+  std::unique_ptr<EventTrace> event_trace_;
   uint64_t perf_mem_reads_;
   uint64_t perf_mem_writes_;
   uint64_t perf_mem_latency_;
@@ -0,0 +1,337 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "roofline.h"
+#include <algorithm>
+#include <iomanip>
+#include <cmath>
+
+using namespace vortex;
+
+static double ratio(double num, double den) {
+  return (den != 0) ? (num / den) : 0.0;
+}
+
+Roofline::Roofline(const ProcessorImpl& processor, const std::string& kernel)
+  : kernel_(kernel)
+{
+  PerfReport report(processor);
+  auto& totals = report.totals();
+  auto& arch = processor.arch();
+  cycles_ = totals.cycles;
+
+  uint32_t num_cores = arch.num_cores() * arch.num_clusters();
+  uint32_t num_clusters = report.clusters().size();
+  uint32_t num_sockets = 0;
+  for (auto& cluster : report.clusters()) {
+    num_sockets += cluster.sockets.size();
+  }
+
+  // compute roofs: every lane retiring one operation per cycle, FMAs counting twice
+  compute_roofs_.push_back({"fpu", 2.0 * num_cores * NUM_FPU_BLOCKS * NUM_FPU_LANES});
+#ifdef EXT_V_ENABLE
+  // the vector counters count one operation per 32-bit element of each active thread
+  compute_roofs_.push_back({"vpu", double(num_cores) * ISSUE_WIDTH * (arch.vpu_datapath_width() / 32)});
+#endif
+#ifdef EXT_TCU_ENABLE
+  // one wmma step per issue slice per cycle of each core's own step shape;
+  // the packing factor follows the formats the kernel actually used (fp16
+  // when it issued none)
+  uint64_t peak_step_macs = 0, issued_step_macs = 0, issued_macs = 0;
+  for (auto& cluster : processor.clusters()) {
+    for (auto& socket : cluster->sockets()) {
+      for (auto& core : socket->cores()) {
+        auto& tcu = core->tensor_unit()->config();
+        auto& perf = core->tensor_unit()->perf_stats();
+        uint64_t step_macs = uint64_t(tcu.tcM) * tcu.tcN * tcu.tcK;
+        peak_step_macs += step_macs;
+        issued_step_macs += perf.wmmas * step_macs;
+        issued_macs += perf.macs;
+      }
+    }
+  }
+  double ops_per_word = issued_step_macs ? ratio(issued_macs, issued_step_macs) : 2.0;
+  compute_roofs_.push_back({"tcu", 2.0 * ISSUE_WIDTH * peak_step_macs * ops_per_word});
+#endif
+
+  // memory roofs: one block per bank (or channel) per cycle
+  if (arch.dcache().enabled) {
+    memory_roofs_.push_back({"l1", double(num_sockets) * NUM_DCACHES * arch.dcache().num_banks * DCACHE_WORD_SIZE});
+  }
+  if (arch.l2cache().enabled) {
+    memory_roofs_.push_back({"l2", double(num_clusters) * arch.l2cache().num_banks * L1_LINE_SIZE});
+  }
+  memory_roofs_.push_back({"dram", double(std::min<uint32_t>(arch.mem_num_banks(), L3_MEM_PORTS)) * MEM_BLOCK_SIZE});
+
+  unit_flops_.emplace_back("fpu", totals.cores.core.fpu_flops);
+#ifdef EXT_V_ENABLE
+  unit_flops_.emplace_back("vpu", totals.cores.vpu.flops);
+#endif
+#ifdef EXT_TCU_ENABLE
+  unit_flops_.emplace_back("tcu", 2 * totals.cores.tcu.macs);
+#endif
+  uint64_t total_flops = 0;
+  for (auto& unit : unit_flops_) {
+    total_flops += unit.second;
+  }
+  auto units = unit_flops_;
+  units.emplace_back("total", total_flops);
+
+  auto& dcache = totals.dcache;
+  auto& l2cache = totals.l2cache;
+  auto& proc = totals.processor;
+  std::vector<std::pair<std::string, uint64_t>> levels;
+  levels.emplace_back("l1", (dcache.reads + dcache.writes) * DCACHE_WORD_SIZE);
+  levels.emplace_back("l2", (l2cache.reads + l2cache.writes) * L1_LINE_SIZE);
+  levels.emplace_back("dram", (proc.mem_reads + proc.mem_writes) * MEM_BLOCK_SIZE);
+
+  for (auto& unit : units) {
+    if (unit.second == 0)
+      continue;
+    for (auto& level : levels) {
+      if (level.second == 0 || !this->memory_roof(level.first))
+        continue;
+      points_.push_back({unit.first, level.first, unit.second, level.second,
+                         ratio(unit.second, level.second), ratio(unit.second, cycles_)});
+    }
+  }
+}
+
+const Roofline::Ceiling* Roofline::compute_roof(const std::string& unit) const {
+  for (auto& roof : compute_roofs_) {
+    if (roof.name == unit)
+      return &roof;
+  }
+  return nullptr;
+}
+
+const Roofline::Ceiling* Roofline::memory_roof(const std::string& level) const {
+  for (auto& roof : memory_roofs_) {
+    if (roof.name == level)
+      return &roof;
+  }
+  return nullptr;
+}
+
+void Roofline::print(std::ostream& os) const {
+  auto flags = os.flags();
+  auto precision = os.precision();
+  os << std::fixed << std::setprecision(3);
+
+  // achieved rate of each unit against its own roof; the unit doing the
+  // most work decides the verdict, whether or not any traffic was seen
+  const std::pair<std::string, uint64_t>* dominant = nullptr;
+  for (auto& roof : compute_roofs_) {
+    uint64_t flops = 0;
+    for (auto& unit : unit_flops_) {
+      if (unit.first == roof.name) {
+        flops = unit.second;
+        if (flops != 0 && (!dominant || flops > dominant->second)) {
+          dominant = &unit;
+        }
+        break;
+      }
+    }
+    os << "PERF: roofline: " << roof.name << " flops=" << flops
+       << ", FLOP/cycle=" << ratio(flops, cycles_)
+       << " (peak=" << roof.peak << ", " << (100.0 * ratio(ratio(flops, cycles_), roof.peak)) << "%)" << std::endl;
+  }
+
+  bool traffic = false;
+  for (auto& point : points_) {
+    if (point.unit != "total")
+      continue;
+    auto roof = this->memory_roof(point.level);
+    os << "PERF: roofline: " << point.level << " bytes=" << point.bytes
+       << ", bandwidth=" << ratio(point.bytes, cycles_) << " bytes/cycle"
+       << " (peak=" << roof->peak << ", " << (100.0 * ratio(ratio(point.bytes, cycles_), roof->peak)) << "%)"
+       << ", intensity=" << point.intensity << " FLOP/byte" << std::endl;
+    traffic = true;
+  }
+
+  if (!dominant) {
+    os << "PERF: roofline: kernel=" << kernel_ << " performed no floating-point work" << std::endl;
+  } else {
+    // the lowest roof under the kernel's intensity at any level is the limiter
+    double attainable = this->compute_roof(dominant->first)->peak;
+    double achieved = ratio(dominant->second, cycles_);
+    std::string bound = dominant->first + " compute";
+    for (auto& point : points_) {
+      if (point.unit != "total")
+        continue;
+      double roof = this->memory_roof(point.level)->peak * point.intensity;
+      if (roof < attainable) {
+        attainable = roof;
+        bound = point.level + " bandwidth";
+      }
+    }
+    os << "PERF: roofline: kernel=" << kernel_ << " is " << bound << " bound"
+       << " (" << (traffic ? "" : "no memory traffic, ") << "attainable=" << attainable << " FLOP/cycle"
+       << ", achieved=" << achieved << " FLOP/cycle"
+       << ", " << (100.0 * ratio(achieved, attainable)) << "%)" << std::endl;
+  }
+
+  os.flags(flags);
+  os.precision(precision);
+}
+
+void Roofline::write_csv(std::ostream& os) const {
+  os << "kernel,unit,level,flops,bytes,cycles,intensity,flops_per_cycle" << std::endl;
+  for (auto& point : points_) {
+    os << kernel_ << "," << point.unit << "," << point.level << ","
+       << point.flops << "," << point.bytes << "," << cycles_ << ","
+       << point.intensity << "," << point.perf << std::endl;
+  }
+  os << std::endl;
+  os << "ceiling,type,peak" << std::endl;
+  for (auto& roof : compute_roofs_) {
+    os << roof.name << ",flops_per_cycle," << roof.peak << std::endl;
+  }
+  for (auto& roof : memory_roofs_) {
+    os << roof.name << ",bytes_per_cycle," << roof.peak << std::endl;
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static const char* level_color(const std::string& level) {
+  if (level == "l1")
+    return "#1f77b4";
+  if (level == "l2")
+    return "#ff7f0e";
+  return "#d62728";
+}
+
+void Roofline::write_svg(std::ostream& os) const {
+  const double W = 720, H = 480;
+  const double left = 70, right = 20, top = 40, bottom = 50;
+  const double pw = W - left - right, ph = H - top - bottom;
+
+  double max_compute = 0, max_bw = 0;
+  for (auto& roof : compute_roofs_) {
+    max_compute = std::max(max_compute, roof.peak);
+  }
+  for (auto& roof : memory_roofs_) {
+    max_bw = std::max(max_bw, roof.peak);
+  }
+
+  // decade-aligned axes spanning the ridge points and the data
+  double x_lo = 1e30, x_hi = 1e-30, y_lo = 1e30, y_hi = max_compute;
+  for (auto& roof : memory_roofs_) {
+    double ridge = max_compute / roof.peak;
+    x_lo = std::min(x_lo, ridge);
+    x_hi = std::max(x_hi, ridge);
+  }
+  for (auto& point : points_) {
+    x_lo = std::min(x_lo, point.intensity);
+    x_hi = std::max(x_hi, point.intensity);
+    y_lo = std::min(y_lo, point.perf);
+  }
+  y_lo = std::min(y_lo, max_compute);
+  for (auto& roof : compute_roofs_) {
+    y_lo = std::min(y_lo, roof.peak);
+  }
+  int x0 = int(std::floor(std::log10(x_lo))) - 1;
+  int x1 = int(std::ceil(std::log10(x_hi))) + 1;
+  int y0 = int(std::floor(std::log10(y_lo))) - 1;
+  int y1 = int(std::ceil(std::log10(y_hi))) + 1;
+
+  auto X = [&](double v) {
+    return left + (std::log10(v) - x0) / (x1 - x0) * pw;
+  };
+  auto Y = [&](double v) {
+    double l = std::max(std::log10(v), double(y0));
+    return top + ph - (l - y0) / (y1 - y0) * ph;
+  };
+
+  auto flags = os.flags();
+  auto precision = os.precision();
+  os << std::setprecision(4);
+
+  os << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << W << "\" height=\"" << H
+     << "\" font-family=\"sans-serif\" font-size=\"11\">" << std::endl;
+  os << "<rect width=\"100%\" height=\"100%\" fill=\"white\"/>" << std::endl;
+  os << "<text x=\"" << (W / 2) << "\" y=\"20\" text-anchor=\"middle\" font-size=\"14\">Roofline: " << kernel_ << "</text>" << std::endl;
+
+  // decade grid
+  for (int e = x0; e <= x1; ++e) {
+    double x = X(std::pow(10.0, e));
+    os << "<line x1=\"" << x << "\" y1=\"" << top << "\" x2=\"" << x << "\" y2=\"" << (top + ph) << "\" stroke=\"#ddd\"/>" << std::endl;
+    os << "<text x=\"" << x << "\" y=\"" << (top + ph + 15) << "\" text-anchor=\"middle\">1e" << e << "</text>" << std::endl;
+  }
+  for (int e = y0; e <= y1; ++e) {
+    double y = Y(std::pow(10.0, e));
+    os << "<line x1=\"" << left << "\" y1=\"" << y << "\" x2=\"" << (left + pw) << "\" y2=\"" << y << "\" stroke=\"#ddd\"/>" << std::endl;
+    os << "<text x=\"" << (left - 5) << "\" y=\"" << (y + 4) << "\" text-anchor=\"end\">1e" << e << "</text>" << std::endl;
+  }
+  os << "<rect x=\"" << left << "\" y=\"" << top << "\" width=\"" << pw << "\" height=\"" << ph << "\" fill=\"none\" stroke=\"black\"/>" << std::endl;
+  os << "<text x=\"" << (left + pw / 2) << "\" y=\"" << (H - 10) << "\" text-anchor=\"middle\">arithmetic intensity (FLOP/byte)</text>" << std::endl;
+  os << "<text x=\"15\" y=\"" << (top + ph / 2) << "\" text-anchor=\"middle\" transform=\"rotate(-90 15 " << (top + ph / 2) << ")\">FLOP/cycle</text>" << std::endl;
+
+  // bandwidth roofs rise until they meet the highest compute roof
+  double x_min = std::pow(10.0, x0), x_max = std::pow(10.0, x1);
+  for (auto& roof : memory_roofs_) {
+    double ridge = max_compute / roof.peak;
+    os << "<line x1=\"" << X(x_min) << "\" y1=\"" << Y(roof.peak * x_min)
+       << "\" x2=\"" << X(ridge) << "\" y2=\"" << Y(max_compute)
+       << "\" stroke=\"" << level_color(roof.name) << "\" stroke-width=\"2\"/>" << std::endl;
+    double lx = std::max(x_min, std::pow(10.0, y0) / roof.peak) * 1.5;
+    os << "<text x=\"" << X(lx) << "\" y=\"" << (Y(roof.peak * lx) - 6) << "\" fill=\"" << level_color(roof.name) << "\">"
+       << roof.name << " " << roof.peak << " B/cycle</text>" << std::endl;
+  }
+
+  // compute roofs start at the ridge of the widest bandwidth roof
+  for (auto& roof : compute_roofs_) {
+    double start = (max_bw != 0) ? (roof.peak / max_bw) : x_min;
+    os << "<line x1=\"" << X(start) << "\" y1=\"" << Y(roof.peak) << "\" x2=\"" << X(x_max) << "\" y2=\"" << Y(roof.peak)
+       << "\" stroke=\"black\" stroke-width=\"2\"" << (roof.peak < max_compute ? " stroke-dasharray=\"6,4\"" : "") << "/>" << std::endl;
+    os << "<text x=\"" << (left + pw - 5) << "\" y=\"" << (Y(roof.peak) - 5) << "\" text-anchor=\"end\">"
+       << roof.name << " " << roof.peak << " FLOP/cycle</text>" << std::endl;
+  }
+
+  for (auto& point : points_) {
+    double x = X(point.intensity), y = Y(point.perf);
+    os << "<circle cx=\"" << x << "\" cy=\"" << y << "\" r=\"5\" fill=\"" << level_color(point.level) << "\""
+       << (point.unit == "total" ? "" : " fill-opacity=\"0.4\"") << ">"
+       << "<title>" << point.unit << " vs " << point.level << ": " << point.intensity << " FLOP/byte, "
+       << point.perf << " FLOP/cycle</title></circle>" << std::endl;
+    os << "<text x=\"" << (x + 7) << "\" y=\"" << (y + 4) << "\">" << point.unit << "</text>" << std::endl;
+  }
+
+  os << "</svg>" << std::endl;
+
+  os.flags(flags);
+  os.precision(precision);
+}
+
+void Roofline::write_html(std::ostream& os) const {
+  os << "<!DOCTYPE html>" << std::endl;
+  os << "<html><head><meta charset=\"utf-8\"><title>Roofline: " << kernel_ << "</title></head><body>" << std::endl;
+  this->write_svg(os);
+  os << "<table border=\"1\" cellpadding=\"4\" cellspacing=\"0\">" << std::endl;
+  os << "<tr><th>unit</th><th>level</th><th>flops</th><th>bytes</th><th>FLOP/byte</th><th>FLOP/cycle</th></tr>" << std::endl;
+  for (auto& point : points_) {
+    os << "<tr><td>" << point.unit << "</td><td>" << point.level << "</td><td>" << point.flops
+       << "</td><td>" << point.bytes << "</td><td>" << point.intensity << "</td><td>" << point.perf << "</td></tr>" << std::endl;
+  }
+  os << "</table>" << std::endl;
+  os << "<p>cycles=" << cycles_;
+  for (auto& roof : compute_roofs_) {
+    os << ", " << roof.name << " peak=" << roof.peak << " FLOP/cycle";
+  }
+  for (auto& roof : memory_roofs_) {
+    os << ", " << roof.name << " peak=" << roof.peak << " bytes/cycle";
+  }
+  os << "</p>" << std::endl;
+  os << "</body></html>" << std::endl;
+}
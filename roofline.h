@@ -0,0 +1,83 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "perf_report.h"
+
+namespace vortex {
+
+// Hierarchical roofline of the last run: achieved FLOP/cycle per compute
+// unit against the traffic seen at each memory level, with the ceilings
+// derived from the active configuration. Rates are per core clock cycle.
+class Roofline {
+public:
+  // a horizontal compute roof (FLOP/cycle) or a slanted bandwidth roof (bytes/cycle)
+  struct Ceiling {
+    std::string name;
+    double      peak;
+  };
+
+  struct Point {
+    std::string unit;      // compute unit, or "total"
+    std::string level;     // memory level the intensity is measured against
+    uint64_t    flops;
+    uint64_t    bytes;
+    double      intensity; // FLOP/byte
+    double      perf;      // FLOP/cycle
+  };
+
+  Roofline(const ProcessorImpl& processor, const std::string& kernel);
+
+  const std::vector<Ceiling>& compute_roofs() const {
+    return compute_roofs_;
+  }
+
+  const std::vector<Ceiling>& memory_roofs() const {
+    return memory_roofs_;
+  }
+
+  const std::vector<Point>& points() const {
+    return points_;
+  }
+
+  // "PERF: roofline" summary with the limiting roof
+  void print(std::ostream& os) const;
+
+  // one row per data point followed by the ceilings
+  void write_csv(std::ostream& os) const;
+
+  // log-log roofline chart
+  void write_svg(std::ostream& os) const;
+
+  // standalone page with the chart and the data point table
+  void write_html(std::ostream& os) const;
+
+private:
+
+  const Ceiling* compute_roof(const std::string& unit) const;
+
+  const Ceiling* memory_roof(const std::string& level) const;
+
+  std::string kernel_;
+  uint64_t cycles_;
+  std::vector<Ceiling> compute_roofs_;
+  std::vector<Ceiling> memory_roofs_;
+  std::vector<std::pair<std::string, uint64_t>> unit_flops_; // per compute unit, traffic or not
+  std::vector<Point> points_;
+};
+
+}
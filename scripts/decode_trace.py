@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+# Copyright © 2019-2023
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Decode the binary debug trace produced by the simulator's -b option to text.
+# usage: decode_trace.py trace.bin [--events cache:cache-miss,...] [--uuid N] [--from C] [--to C]
+
+import argparse
+import struct
+import sys
+
+RECORD = struct.Struct("<QQQIHBB")
+
+def read_str(data, pos):
+  (size,) = struct.unpack_from("<H", data, pos)
+  pos += 2
+  return data[pos:pos + size].decode(), pos + size
+
+def load(filename):
+  with open(filename, "rb") as f:
+    data = f.read()
+  if data[:4] != b"VXBT":
+    sys.exit("error: %s is not a binary trace" % filename)
+  version, record_size, num_events = struct.unpack_from("<III", data, 4)
+  if version != 1 or record_size != RECORD.size:
+    sys.exit("error: unsupported trace version %d (record size %d)" % (version, record_size))
+  pos = 16
+  events = []
+  for _ in range(num_events):
+    name, pos = read_str(data, pos)
+    events.append(name)
+
+  # the source name trailer is missing when the run did not shut down cleanly
+  sources = []
+  end = len(data)
+  if data[-4:] == b"VXND":
+    (offset,) = struct.unpack_from("<Q", data, len(data) - 12)
+    if data[offset:offset + 4] == b"VXSR":
+      (count,) = struct.unpack_from("<I", data, offset + 4)
+      spos = offset + 8
+      for _ in range(count):
+        name, spos = read_str(data, spos)
+        sources.append(name)
+      end = offset
+  end -= (end - pos) % RECORD.size
+  return data, pos, end, events, sources
+
+def main():
+  parser = argparse.ArgumentParser(description="decode a simulator binary trace")
+  parser.add_argument("trace", help="trace file")
+  parser.add_argument("--events", help="comma list of event names to keep (e.g. commit,cache:cache-miss)")
+  parser.add_argument("--uuid", type=int, help="only records of this instruction")
+  parser.add_argument("--from", dest="start", type=int, default=0, help="first cycle")
+  parser.add_argument("--to", dest="end", type=int, default=None, help="last cycle")
+  args = parser.parse_args()
+
+  data, pos, end, events, sources = load(args.trace)
+  keep = None
+  if args.events:
+    wanted = set(args.events.split(","))
+    keep = {i for i, name in enumerate(events) if name in wanted or name.split(":")[1] in wanted}
+
+  out = sys.stdout
+  for cycle, uuid, addr, arg, src, event, wid in RECORD.iter_unpack(data[pos:end]):
+    if cycle < args.start or (args.end is not None and cycle > args.end):
+      continue
+    if keep is not None and event not in keep:
+      continue
+    if args.uuid is not None and uuid != args.uuid:
+      continue
+    name = events[event] if event < len(events) else "event%d" % event
+    source = sources[src] if src < len(sources) else "src%d" % src
+    out.write("%10d: %-22s %-32s wid=%d, addr=0x%x, arg=%d (#%d)\n" % (cycle, name, source, wid, addr, arg, uuid))
+
+if __name__ == "__main__":
+  main()
@@ -0,0 +1,248 @@
+#!/usr/bin/env python3
+# Copyright © 2019-2023
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Design-space exploration driver. Sweeps the cross product of runtime
+# parameters (the simulator's -o keys) over a set of kernels, running one
+# simulator process per host core. Finished runs are appended to
+# <out>/results.jsonl, so rerunning the same command resumes an interrupted
+# sweep. The summary ranks every design point by geomean cycles against a
+# modeled area proxy and marks the Pareto-optimal ones.
+#
+# usage: dse.py --simx ./simx -k vecadd.bin -k sgemm.bin \
+#          -p cores=1,2,4 -p dcache.size=8192,16384 -p mem.banks=2,4 -o sweep
+
+import argparse
+import csv
+import hashlib
+import itertools
+import json
+import math
+import os
+import subprocess
+import sys
+import time
+from concurrent.futures import ThreadPoolExecutor, as_completed
+
+# Area proxy coefficients, in KB-of-SRAM equivalents. They only have to rank
+# design points consistently, not predict silicon; override with --area-model.
+AREA_MODEL = {
+  "core":      16.0,  # fixed per-core pipeline logic
+  "lane":      2.0,   # per thread lane (ALU/FPU/LSU datapath)
+  "regfile":   1.0,   # per KB of general-purpose registers
+  "cache":     1.0,   # per KB of cache data array
+  "mshr":      0.1,   # per MSHR entry
+  "tcu_mac":   0.5,   # per tensor core multiplier (per core)
+  "mem_bank":  8.0,   # per DRAM channel controller
+}
+
+CACHES = ["icache", "dcache", "l2cache", "l3cache"]
+
+def parse_space(items):
+  space = {}
+  for item in items:
+    key, sep, values = item.partition("=")
+    if not sep or not values:
+      raise SystemExit("error: expected <param>=<v1>,<v2>,...: " + item)
+    space[key.strip()] = [v.strip() for v in values.split(",")]
+  return space
+
+def design_points(space):
+  keys = sorted(space.keys())
+  for values in itertools.product(*(space[k] for k in keys)):
+    yield dict(zip(keys, values))
+
+def point_id(params):
+  text = ",".join("%s=%s" % (k, params[k]) for k in sorted(params))
+  return hashlib.sha1(text.encode()).hexdigest()[:12]
+
+def run_id(params, kernel):
+  # the path hash keeps same-named kernels from different directories apart
+  name = os.path.splitext(os.path.basename(kernel))[0]
+  return point_id(params) + "-" + name + "-" + hashlib.sha1(kernel.encode()).hexdigest()[:8]
+
+def load_results(filename):
+  results = {}
+  if os.path.exists(filename):
+    with open(filename) as f:
+      for line in f:
+        line = line.strip()
+        if not line:
+          continue
+        try:
+          entry = json.loads(line)
+        except json.JSONDecodeError:
+          continue  # torn last line of an interrupted sweep
+        results[entry["id"]] = entry
+  return results
+
+def run_one(args, params, kernel):
+  rid = run_id(params, kernel)
+  rundir = os.path.join(args.out, rid)
+  os.makedirs(rundir, exist_ok=True)
+  cmd = [args.simx, "-s", "-j", "stats.json"]
+  if args.config:
+    cmd += ["-C", args.config]
+  for key in sorted(params):
+    cmd += ["-o", "%s=%s" % (key, params[key])]
+  cmd.append(kernel)
+
+  entry = {"id": rid, "point": point_id(params), "kernel": kernel, "params": params}
+  start = time.time()
+  try:
+    with open(os.path.join(rundir, "run.log"), "w") as log:
+      proc = subprocess.run(cmd, cwd=rundir, stdout=log, stderr=subprocess.STDOUT, timeout=args.timeout)
+    entry["exitcode"] = proc.returncode
+  except subprocess.TimeoutExpired:
+    entry["exitcode"] = None
+  entry["seconds"] = round(time.time() - start, 3)
+
+  stats_file = os.path.join(rundir, "stats.json")
+  if entry["exitcode"] == 0 and os.path.exists(stats_file):
+    with open(stats_file) as f:
+      stats = json.load(f)
+    entry["status"] = "ok"
+    entry["summary"] = stats["summary"]
+    entry["config"] = stats["config"]
+  else:
+    entry["status"] = "timeout" if entry["exitcode"] is None else "failed"
+  return entry
+
+def area(config, model):
+  cores = config["num_clusters"] * config["num_cores"]
+  threads = config["num_threads"]
+  warps = config["num_warps"]
+  sockets = config["num_sockets"]
+  a = cores * (model["core"] + threads * model["lane"])
+  a += cores * model["regfile"] * warps * threads * 32 * 4 / 1024
+  for name in CACHES:
+    cache = config[name]
+    if not cache["enabled"]:
+      continue
+    # l1 caches are shared per socket, l2 per cluster, l3 once
+    count = {"icache": sockets * config["icaches_per_socket"],
+             "dcache": sockets * config["dcaches_per_socket"],
+             "l2cache": config["num_clusters"], "l3cache": 1}[name]
+    a += count * (model["cache"] * cache["size"] / 1024 + model["mshr"] * cache["mshr"])
+  # multipliers of every core's resolved tcu step shape, as the simulator
+  # reports them (absent in builds without the tensor core)
+  macs = config.get("tcu_step_macs", 0)
+  a += model["tcu_mac"] * macs
+  a += model["mem_bank"] * config["mem_banks"]
+  return a
+
+def pareto(rows):
+  # minimize both area and cycles
+  front = set()
+  for i, r in enumerate(rows):
+    dominated = any(o["area"] <= r["area"] and o["cycles"] <= r["cycles"]
+                    and (o["area"] < r["area"] or o["cycles"] < r["cycles"])
+                    for o in rows)
+    if not dominated:
+      front.add(i)
+  return front
+
+def summarize(args, space, kernels, results):
+  model = dict(AREA_MODEL)
+  if args.area_model:
+    with open(args.area_model) as f:
+      model.update(json.load(f))
+
+  rows = []
+  for params in design_points(space):
+    entries = [results.get(run_id(params, k)) for k in kernels]
+    if not all(e and e["status"] == "ok" for e in entries):
+      continue
+    cycles = [e["summary"]["cycles"] for e in entries]
+    row = dict(params)
+    row["point"] = point_id(params)
+    row["cycles"] = math.exp(sum(math.log(max(c, 1)) for c in cycles) / len(cycles))
+    row["ipc"] = sum(e["summary"]["ipc"] for e in entries) / len(entries)
+    row["area"] = area(entries[0]["config"], model)
+    rows.append(row)
+
+  if not rows:
+    print("no complete design points")
+    return
+  front = pareto(rows)
+  for i, row in enumerate(rows):
+    row["pareto"] = int(i in front)
+  rows.sort(key=lambda r: (r["area"], r["cycles"]))
+
+  keys = sorted(space.keys())
+  fields = ["point"] + keys + ["area", "cycles", "ipc", "pareto"]
+  with open(os.path.join(args.out, "summary.csv"), "w", newline="") as f:
+    writer = csv.DictWriter(f, fieldnames=fields)
+    writer.writeheader()
+    for row in rows:
+      writer.writerow({k: (round(row[k], 3) if isinstance(row[k], float) else row[k]) for k in fields})
+
+  widths = [max(len(k), 12) for k in keys]
+  print("Pareto front (%d of %d points):" % (len(front), len(rows)))
+  print("  ".join(k.ljust(w) for k, w in zip(keys, widths)) + "  %10s  %12s  %6s" % ("area", "cycles", "ipc"))
+  for row in rows:
+    if row["pareto"]:
+      print("  ".join(str(row[k]).ljust(w) for k, w in zip(keys, widths))
+            + "  %10.1f  %12.0f  %6.3f" % (row["area"], row["cycles"], row["ipc"]))
+
+def main():
+  parser = argparse.ArgumentParser(description="parallel design-space exploration over simulator runtime parameters")
+  parser.add_argument("--simx", default="./simx", help="simulator binary")
+  parser.add_argument("-k", "--kernel", action="append", required=True, help="kernel image (repeatable)")
+  parser.add_argument("-p", "--param", action="append", default=[], help="<param>=<v1>,<v2>,... (repeatable)")
+  parser.add_argument("-C", "--config", default=None, help="base config file passed to every run")
+  parser.add_argument("-o", "--out", default="dse", help="output directory")
+  parser.add_argument("-j", "--jobs", type=int, default=os.cpu_count(), help="parallel runs (default: host cores)")
+  parser.add_argument("--timeout", type=float, default=None, help="per-run timeout in seconds")
+  parser.add_argument("--retry-failed", action="store_true", help="rerun points that failed or timed out")
+  parser.add_argument("--area-model", default=None, help="JSON file overriding the area coefficients")
+  parser.add_argument("--summary-only", action="store_true", help="only rebuild the summary from results.jsonl")
+  args = parser.parse_args()
+
+  args.simx = os.path.abspath(args.simx)
+  if args.config:
+    args.config = os.path.abspath(args.config)
+  kernels = [os.path.abspath(k) for k in args.kernel]
+  space = parse_space(args.param)
+  os.makedirs(args.out, exist_ok=True)
+  results_file = os.path.join(args.out, "results.jsonl")
+  results = load_results(results_file)
+
+  if not args.summary_only:
+    def done(entry):
+      return entry and (entry["status"] == "ok" or not args.retry_failed)
+    jobs = [(params, kernel) for params in design_points(space) for kernel in kernels
+            if not done(results.get(run_id(params, kernel)))]
+    total = len(jobs)
+    print("%d runs queued, %d already recorded" % (total, len(results)))
+
+    # the main thread is the only writer, one line per finished run
+    with open(results_file, "a") as out, ThreadPoolExecutor(max_workers=args.jobs) as pool:
+      futures = [pool.submit(run_one, args, params, kernel) for params, kernel in jobs]
+      try:
+        for count, future in enumerate(as_completed(futures), 1):
+          entry = future.result()
+          results[entry["id"]] = entry
+          out.write(json.dumps(entry) + "\n")
+          out.flush()
+          print("[%d/%d] %s %s (%.1fs)" % (count, total, entry["id"], entry["status"], entry["seconds"]))
+      except KeyboardInterrupt:
+        for future in futures:
+          future.cancel()
+        print("interrupted, rerun the same command to resume", file=sys.stderr)
+        raise SystemExit(1)
+
+  summarize(args, space, kernels, results)
+
+if __name__ == "__main__":
+  main()
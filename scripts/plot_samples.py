@@ -0,0 +1,67 @@
+#!/usr/bin/env python3
+# Copyright © 2019-2023
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Plot the interval samples produced by the simulator's -i option.
+# usage: plot_samples.py samples.csv [-o samples.png]
+
+import argparse
+import csv
+
+import matplotlib
+matplotlib.use("Agg")
+import matplotlib.pyplot as plt
+
+SERIES = [
+  ("ipc",      "IPC"),
+  ("mem_bw",   "DRAM bandwidth (bytes/cycle)"),
+  ("tcu_busy", "TCU busy"),
+  ("vpu_busy", "VPU busy"),
+]
+
+def load(filename):
+  with open(filename) as f:
+    rows = list(csv.DictReader(f))
+  data = {key: [float(row[key]) for row in rows] for key in rows[0].keys()} if rows else {}
+  return data
+
+def main():
+  parser = argparse.ArgumentParser(description="plot simulator interval samples")
+  parser.add_argument("csv", help="samples file")
+  parser.add_argument("-o", "--output", default=None, help="output image (default: <csv>.png)")
+  args = parser.parse_args()
+
+  data = load(args.csv)
+  if not data:
+    raise SystemExit("error: no samples in " + args.csv)
+
+  # skip units that were compiled out or never used
+  series = [(key, label) for key, label in SERIES if any(data.get(key, []))]
+  if not series:
+    print("no activity to plot in " + args.csv)
+    return
+
+  fig, axes = plt.subplots(len(series), 1, sharex=True, figsize=(10, 2.5 * len(series)), squeeze=False)
+  for ax, (key, label) in zip(axes[:, 0], series):
+    ax.step(data["cycle"], data[key], where="post")
+    ax.set_ylabel(label)
+    ax.grid(True, alpha=0.3)
+  axes[-1, 0].set_xlabel("cycle")
+  fig.tight_layout()
+
+  output = args.output or (args.csv.rsplit(".", 1)[0] + ".png")
+  fig.savefig(output)
+  print("saved " + output)
+
+if __name__ == "__main__":
+  main()
@@ -0,0 +1,152 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "simt_profiler.h"
+#include "symbol_table.h"
+#include <iomanip>
+#include <algorithm>
+
+using namespace vortex;
+
+SimtProfiler::SimtProfiler(const Arch& arch)
+  : num_threads_(arch.num_threads())
+  , num_warps_(arch.num_warps())
+  , warps_(arch.num_warps() * arch.num_cores() * arch.num_clusters())
+  , occupancy_hist_(arch.num_threads() + 1)
+  , depth_hist_(arch.num_threads()) // ipdom stack holds at most num_threads-1 entries
+{
+  this->reset();
+}
+
+void SimtProfiler::reset() {
+  for (auto& warp : warps_) {
+    warp.instrs = 0;
+    warp.threads = 0;
+    warp.max_depth = 0;
+    warp.splits.clear();
+  }
+  std::fill(occupancy_hist_.begin(), occupancy_hist_.end(), 0);
+  std::fill(depth_hist_.begin(), depth_hist_.end(), 0);
+  branches_.clear();
+}
+
+void SimtProfiler::split(uint32_t cid, uint32_t wid, Word pc, bool divergent) {
+  auto& branch = branches_[pc];
+  ++branch.execs;
+  if (!divergent)
+    return;
+  ++branch.divergent;
+  auto& warp = warps_.at(cid * num_warps_ + wid);
+  warp.splits.push_back({pc, SimPlatform::instance().cycles()});
+  warp.max_depth = std::max<uint32_t>(warp.max_depth, warp.splits.size());
+}
+
+void SimtProfiler::join(uint32_t cid, uint32_t wid, bool reconverged) {
+  if (!reconverged)
+    return;
+  auto& warp = warps_.at(cid * num_warps_ + wid);
+  if (warp.splits.empty())
+    return; // diverged before profiling started
+  auto& split = warp.splits.back();
+  auto& branch = branches_[split.pc];
+  ++branch.reconverged;
+  branch.reconv_cycles += SimPlatform::instance().cycles() - split.cycle;
+  warp.splits.pop_back();
+}
+
+void SimtProfiler::pred(uint32_t cid, uint32_t wid, Word pc, bool divergent) {
+  __unused (cid);
+  __unused (wid);
+  auto& branch = branches_[pc];
+  branch.is_pred = true;
+  ++branch.execs;
+  branch.divergent += divergent;
+}
+
+static double ratio(uint64_t num, uint64_t den) {
+  return den ? (double(num) / den) : 0.0;
+}
+
+void SimtProfiler::write_report(std::ostream& os, const SymbolTable* symbols) const {
+  uint64_t instrs = 0, threads = 0;
+  for (auto& warp : warps_) {
+    instrs  += warp.instrs;
+    threads += warp.threads;
+  }
+
+  auto flags = os.flags();
+  os << std::fixed << std::setprecision(1);
+
+  os << "# SIMT efficiency: " << (100.0 * ratio(threads, instrs * num_threads_)) << "% ("
+     << threads << " thread instructions over " << instrs << " warp instructions, " << num_threads_ << " lanes)" << std::endl;
+
+  os << "# active lanes histogram" << std::endl;
+  for (uint32_t i = 1; i < occupancy_hist_.size(); ++i) {
+    os << std::setw(6) << i << std::setw(14) << occupancy_hist_.at(i)
+       << std::setw(8) << (100.0 * ratio(occupancy_hist_.at(i), instrs)) << "%" << std::endl;
+  }
+
+  os << "# divergence depth histogram (ipdom stack depth per instruction)" << std::endl;
+  uint32_t max_depth = 0;
+  for (uint32_t i = 0; i < depth_hist_.size(); ++i) {
+    if (depth_hist_.at(i) != 0)
+      max_depth = i;
+  }
+  for (uint32_t i = 0; i <= max_depth; ++i) {
+    os << std::setw(6) << i << std::setw(14) << depth_hist_.at(i)
+       << std::setw(8) << (100.0 * ratio(depth_hist_.at(i), instrs)) << "%" << std::endl;
+  }
+
+  os << "# per-warp efficiency" << std::endl;
+  os << std::setw(8) << "warp" << std::setw(14) << "instrs" << std::setw(8) << "simt%" << std::setw(10) << "max.depth" << std::endl;
+  for (uint32_t i = 0; i < warps_.size(); ++i) {
+    auto& warp = warps_.at(i);
+    if (warp.instrs == 0)
+      continue;
+    os << std::setw(8) << i
+       << std::setw(14) << warp.instrs
+       << std::setw(8) << (100.0 * ratio(warp.threads, warp.instrs * num_threads_))
+       << std::setw(10) << warp.max_depth << std::endl;
+  }
+
+  // most divergent branches first
+  std::vector<std::pair<Word, const branch_stats_t*>> sorted;
+  for (auto& it : branches_) {
+    sorted.emplace_back(it.first, &it.second);
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+    return (a.second->divergent != b.second->divergent) ? (a.second->divergent > b.second->divergent) : (a.first < b.first);
+  });
+
+  os << "# per-branch divergence (split/pred by PC); reconv: avg cycles from split to reconvergence" << std::endl;
+  os << std::setw(12) << "pc" << std::setw(6) << "type" << std::setw(12) << "execs"
+     << std::setw(12) << "divergent" << std::setw(8) << "rate%" << std::setw(10) << "reconv" << "  symbol" << std::endl;
+  for (auto& it : sorted) {
+    auto& branch = *it.second;
+    os << "  0x" << std::hex << std::setw(8) << std::setfill('0') << it.first << std::dec << std::setfill(' ')
+       << std::setw(6) << (branch.is_pred ? "pred" : "split")
+       << std::setw(12) << branch.execs
+       << std::setw(12) << branch.divergent
+       << std::setw(8) << (100.0 * ratio(branch.divergent, branch.execs))
+       << std::setw(10) << ratio(branch.reconv_cycles, branch.reconverged);
+    if (symbols) {
+      auto sym = symbols->symbol(it.first);
+      if (!sym.empty()) {
+        os << "  " << sym;
+      }
+    }
+    os << std::endl;
+  }
+
+  os.flags(flags);
+}
@@ -0,0 +1,84 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include "types.h"
+#include "arch.h"
+
+namespace vortex {
+
+class SymbolTable;
+
+// SIMT efficiency and control divergence statistics, fed by the emulator's
+// split/join/pred handling and by every executed warp instruction.
+class SimtProfiler {
+public:
+  SimtProfiler(const Arch& arch);
+
+  void reset();
+
+  // executed warp instruction with its active mask and ipdom stack depth
+  void instr(uint32_t cid, uint32_t wid, const ThreadMask& tmask, uint32_t depth) {
+    auto& warp = warps_.at(cid * num_warps_ + wid);
+    uint32_t active = tmask.count();
+    ++warp.instrs;
+    warp.threads += active;
+    ++occupancy_hist_.at(active);
+    ++depth_hist_.at(std::min<uint32_t>(depth, depth_hist_.size() - 1));
+  }
+
+  void split(uint32_t cid, uint32_t wid, Word pc, bool divergent);
+
+  // reconverged: the ipdom entry was popped and the original mask restored
+  void join(uint32_t cid, uint32_t wid, bool reconverged);
+
+  void pred(uint32_t cid, uint32_t wid, Word pc, bool divergent);
+
+  void write_report(std::ostream& os, const SymbolTable* symbols = nullptr) const;
+
+private:
+
+  struct split_t {
+    Word     pc;
+    uint64_t cycle;
+  };
+
+  struct warp_stats_t {
+    uint64_t instrs;
+    uint64_t threads;
+    uint32_t max_depth;
+    std::vector<split_t> splits; // open divergent regions
+  };
+
+  struct branch_stats_t {
+    bool     is_pred;
+    uint64_t execs;
+    uint64_t divergent;
+    uint64_t reconverged;
+    uint64_t reconv_cycles;
+  };
+
+  uint32_t num_threads_;
+  uint32_t num_warps_;
+  std::vector<warp_stats_t> warps_;
+  std::vector<uint64_t> occupancy_hist_; // by active lanes
+  std::vector<uint64_t> depth_hist_;     // by ipdom stack depth
+  std::map<Word, branch_stats_t> branches_;
+};
+
+}
@@ -29,40 +29,42 @@ Socket::Socket(const SimContext& ctx,
   , cores_(arch.socket_size())
 {
   auto cores_per_socket = cores_.size();
+  auto& icache = arch.icache();
+  auto& dcache = arch.dcache();
 
   char sname[100];
   snprintf(sname, 100, "%s-icaches", this->name().c_str());
   icaches_ = CacheCluster::Create(sname, cores_per_socket, NUM_ICACHES, CacheSim::Config{
-    !ICACHE_ENABLED,
-    log2ceil(ICACHE_SIZE),  // C
+    !icache.enabled,
+    uint8_t(log2ceil(icache.size)), // C
     log2ceil(L1_LINE_SIZE), // L
     log2ceil(sizeof(uint32_t)), // W
-    log2ceil(ICACHE_NUM_WAYS),// A
-    log2ceil(1),            // B
+    uint8_t(log2ceil(icache.num_ways)), // A
+    uint8_t(log2ceil(icache.num_banks)), // B
     XLEN,                   // address bits
     1,                      // number of inputs
     ICACHE_MEM_PORTS,       // memory ports
-    false,                  // write-back
+    icache.writeback,       // write-back
     false,                  // write response
-    ICACHE_MSHR_SIZE,       // mshr size
-    2,                      // pipeline latency
+    uint16_t(icache.mshr_size), // mshr size
+    uint8_t(icache.latency), // pipeline latency
   });
 
   snprintf(sname, 100, "%s-dcaches", this->name().c_str());
   dcaches_ = CacheCluster::Create(sname, cores_per_socket, NUM_DCACHES, CacheSim::Config{
-    !DCACHE_ENABLED,
-    log2ceil(DCACHE_SIZE),  // C
+    !dcache.enabled,
+    uint8_t(log2ceil(dcache.size)), // C
     log2ceil(L1_LINE_SIZE), // L
     log2ceil(DCACHE_WORD_SIZE), // W
-    log2ceil(DCACHE_NUM_WAYS),// A
-    log2ceil(DCACHE_NUM_BANKS), // B
+    uint8_t(log2ceil(dcache.num_ways)), // A
+    uint8_t(log2ceil(dcache.num_banks)), // B
     XLEN,                   // address bits
     DCACHE_NUM_REQS,        // number of inputs
     L1_MEM_PORTS,           // memory ports
-    DCACHE_WRITEBACK,       // write-back
+    dcache.writeback,       // write-back
     false,                  // write response
-    DCACHE_MSHR_SIZE,       // mshr size
-    2,                      // pipeline latency
+    uint16_t(dcache.mshr_size), // mshr size
+    uint8_t(dcache.latency), // pipeline latency
   });
 
   // find overlap
@@ -51,6 +51,14 @@ public:
     return cluster_;
   }
 
+  const std::vector<Core::Ptr>& cores() const {
+    return cores_;
+  }
+
+  const CacheCluster::Ptr& dcaches() const {
+    return dcaches_;
+  }
+
   void reset();
 
   void tick();
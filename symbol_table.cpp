@@ -0,0 +1,213 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "symbol_table.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <elf.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+using namespace vortex;
+
+// true if [offset, offset + size) lies within an image of image_size bytes
+static bool in_bounds(uint64_t offset, uint64_t size, uint64_t image_size) {
+  return offset <= image_size && size <= (image_size - offset);
+}
+
+// copy a T out of the image: ELF offsets come from the file, so they are
+// neither trusted to be in range nor to be aligned for T.
+template <typename T>
+static bool read_at(const std::vector<char>& image, uint64_t offset, T* out) {
+  if (!in_bounds(offset, sizeof(T), image.size()))
+    return false;
+  memcpy(out, image.data() + offset, sizeof(T));
+  return true;
+}
+
+template <typename Ehdr, typename Shdr, typename Sym>
+static void parse_symbols(const std::vector<char>& image, std::vector<std::pair<Sym, std::string>>* out) {
+  Ehdr ehdr;
+  if (!read_at(image, 0, &ehdr)
+   || ehdr.e_shoff == 0
+   || ehdr.e_shentsize != sizeof(Shdr)
+   || !in_bounds(ehdr.e_shoff, uint64_t(ehdr.e_shnum) * sizeof(Shdr), image.size()))
+    return;
+  auto section = [&](uint32_t index, Shdr* shdr) {
+    return read_at(image, ehdr.e_shoff + uint64_t(index) * sizeof(Shdr), shdr);
+  };
+  for (uint32_t i = 0; i < ehdr.e_shnum; ++i) {
+    Shdr shdr, strtab;
+    if (!section(i, &shdr)
+     || shdr.sh_type != SHT_SYMTAB
+     || shdr.sh_link >= ehdr.e_shnum
+     || !section(shdr.sh_link, &strtab)
+     || !in_bounds(shdr.sh_offset, shdr.sh_size, image.size())
+     || !in_bounds(strtab.sh_offset, strtab.sh_size, image.size()))
+      continue;
+    auto strs = image.data() + strtab.sh_offset;
+    for (uint64_t j = 0, n = shdr.sh_size / sizeof(Sym); j < n; ++j) {
+      Sym sym;
+      read_at(image, shdr.sh_offset + j * sizeof(Sym), &sym);
+      if (sym.st_name >= strtab.sh_size || sym.st_shndx == SHN_UNDEF)
+        continue;
+      auto type = (sizeof(Sym) == sizeof(Elf32_Sym)) ? ELF32_ST_TYPE(sym.st_info) : ELF64_ST_TYPE(sym.st_info);
+      if (type != STT_FUNC && type != STT_NOTYPE)
+        continue;
+      // the name must be terminated inside its string table
+      const char* name = strs + sym.st_name;
+      size_t max_len = strtab.sh_size - sym.st_name;
+      size_t len = strnlen(name, max_len);
+      if (len == 0 || len == max_len || name[0] == '$')
+        continue; // skip unterminated names and mapping symbols
+      out->emplace_back(sym, std::string(name, len));
+    }
+  }
+}
+
+SymbolTable::SymbolTable() {}
+
+bool SymbolTable::load(const std::string& elf_file) {
+  std::ifstream ifs(elf_file, std::ios::binary);
+  if (!ifs) {
+    std::cout << "Error: cannot open ELF file: " << elf_file << std::endl;
+    return false;
+  }
+  std::vector<char> image((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+  if (image.size() < EI_NIDENT || memcmp(image.data(), ELFMAG, SELFMAG) != 0) {
+    std::cout << "Error: not an ELF file: " << elf_file << std::endl;
+    return false;
+  }
+
+  symbols_.clear();
+  if (image[EI_CLASS] == ELFCLASS32) {
+    std::vector<std::pair<Elf32_Sym, std::string>> syms;
+    parse_symbols<Elf32_Ehdr, Elf32_Shdr, Elf32_Sym>(image, &syms);
+    for (auto& sym : syms) {
+      symbols_.push_back({sym.first.st_value, sym.first.st_size, sym.second});
+    }
+  } else {
+    std::vector<std::pair<Elf64_Sym, std::string>> syms;
+    parse_symbols<Elf64_Ehdr, Elf64_Shdr, Elf64_Sym>(image, &syms);
+    for (auto& sym : syms) {
+      symbols_.push_back({sym.first.st_value, sym.first.st_size, sym.second});
+    }
+  }
+
+  // sort by address, preferring sized (function) symbols at the same address
+  std::sort(symbols_.begin(), symbols_.end(), [](const symbol_t& a, const symbol_t& b) {
+    return (a.addr != b.addr) ? (a.addr < b.addr) : (a.size > b.size);
+  });
+
+  elf_file_ = elf_file;
+  return true;
+}
+
+std::string SymbolTable::symbol(uint64_t pc) const {
+  auto it = std::upper_bound(symbols_.begin(), symbols_.end(), pc, [](uint64_t addr, const symbol_t& sym) {
+    return addr < sym.addr;
+  });
+  if (it == symbols_.begin())
+    return "";
+  --it;
+  // walk back to the first symbol at this address
+  while (it != symbols_.begin() && std::prev(it)->addr == it->addr) {
+    --it;
+  }
+  if (it->size != 0 && pc >= it->addr + it->size)
+    return "";
+  std::stringstream ss;
+  ss << it->name << "+0x" << std::hex << (pc - it->addr);
+  return ss.str();
+}
+
+std::unordered_map<uint64_t, std::string> SymbolTable::source_lines(const std::vector<uint64_t>& pcs) const {
+  std::unordered_map<uint64_t, std::string> lines;
+  if (elf_file_.empty() || pcs.empty())
+    return lines;
+
+  const char* tool = getenv("VX_ADDR2LINE");
+  if (tool == nullptr) {
+    tool = "riscv64-unknown-elf-addr2line";
+  }
+
+  // addr2line prints one "file:line" per input address, in order
+  static constexpr uint32_t BATCH_SIZE = 256;
+  for (size_t i = 0; i < pcs.size(); i += BATCH_SIZE) {
+    // the ELF path is user input: pass it as an argument, never through a shell
+    size_t n = std::min<size_t>(BATCH_SIZE, pcs.size() - i);
+    std::vector<std::string> args{tool, "-e", elf_file_};
+    for (size_t j = 0; j < n; ++j) {
+      std::stringstream ss;
+      ss << "0x" << std::hex << pcs.at(i + j);
+      args.push_back(ss.str());
+    }
+    std::vector<char*> argv;
+    for (auto& arg : args) {
+      argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    int fds[2];
+    if (pipe(fds) != 0)
+      return lines;
+    pid_t pid = fork();
+    if (pid < 0) {
+      close(fds[0]);
+      close(fds[1]);
+      return lines;
+    }
+    if (pid == 0) {
+      dup2(fds[1], STDOUT_FILENO);
+      int null_fd = open("/dev/null", O_WRONLY);
+      if (null_fd >= 0) {
+        dup2(null_fd, STDERR_FILENO);
+      }
+      close(fds[0]);
+      close(fds[1]);
+      execvp(argv[0], argv.data());
+      _exit(127);
+    }
+    close(fds[1]);
+    auto pipe = fdopen(fds[0], "r");
+    if (pipe == nullptr) {
+      close(fds[0]);
+      waitpid(pid, nullptr, 0);
+      return lines;
+    }
+    char buf[1024];
+    size_t j = 0;
+    while (j < n && fgets(buf, sizeof(buf), pipe)) {
+      std::string line(buf);
+      line.erase(line.find_last_not_of("\r\n") + 1);
+      if (line.compare(0, 2, "??") != 0) {
+        // strip directories to keep the report narrow
+        auto slash = line.find_last_of('/');
+        lines[pcs.at(i + j)] = (slash != std::string::npos) ? line.substr(slash + 1) : line;
+      }
+      ++j;
+    }
+    fclose(pipe);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (!(WIFEXITED(status) && WEXITSTATUS(status) == 0) && j == 0)
+      return lines; // tool not available
+  }
+  return lines;
+}
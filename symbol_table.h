@@ -0,0 +1,54 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <stdint.h>
+
+namespace vortex {
+
+// Resolves kernel PCs to function symbols using the ELF symbol table.
+// Source lines are resolved through addr2line (override the tool with the
+// VX_ADDR2LINE environment variable) when the ELF has debug info.
+class SymbolTable {
+public:
+  SymbolTable();
+
+  bool load(const std::string& elf_file);
+
+  bool empty() const {
+    return symbols_.empty();
+  }
+
+  // "name+0xoffset", or an empty string if the PC is not covered
+  std::string symbol(uint64_t pc) const;
+
+  // resolve source lines for a batch of PCs; returns "file:line" per PC
+  std::unordered_map<uint64_t, std::string> source_lines(const std::vector<uint64_t>& pcs) const;
+
+private:
+
+  struct symbol_t {
+    uint64_t    addr;
+    uint64_t    size;
+    std::string name;
+  };
+
+  std::string elf_file_;
+  std::vector<symbol_t> symbols_;
+};
+
+}
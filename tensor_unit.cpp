@@ -87,11 +87,11 @@ template <typename It, typename Ot>
 struct FEDP {
   using itype = typename It::dtype;
   using otype = typename Ot::dtype;
-  static uint32_t eval(const reg_data_t *a_row, const reg_data_t *b_col, uint32_t c_val) {
+  static uint32_t eval(const reg_data_t *a_row, const reg_data_t *b_col, uint32_t c_val, uint32_t tcK) {
   constexpr uint32_t i_ratio = sizeof(uint32_t) / sizeof(itype);
   static_assert(i_ratio * sizeof(itype) == sizeof(uint32_t), "FEDP: tcK * i_ratio must be <= 32");
   auto acc = bit_cast<otype>(c_val);
-  for (uint32_t z = 0; z < cfg::tcK; ++z) {
+  for (uint32_t z = 0; z < tcK; ++z) {
     auto a = reinterpret_cast<const itype *>(&a_row[z].u32);
     auto b = reinterpret_cast<const itype *>(&b_col[z].u32);
     for (uint32_t i = 0; i < i_ratio; ++i) {
@@ -104,9 +104,9 @@ struct FEDP {
 
 template <>
 struct FEDP<vt::int4, vt::int32>{
-  static uint32_t eval(const reg_data_t *a_row, const reg_data_t *b_col, uint32_t c_val) {
+  static uint32_t eval(const reg_data_t *a_row, const reg_data_t *b_col, uint32_t c_val, uint32_t tcK) {
     auto acc = bit_cast<int32_t>(c_val);
-    for (uint32_t z = 0; z < cfg::tcK; ++z) {
+    for (uint32_t z = 0; z < tcK; ++z) {
       auto a = a_row[z].u32;
       auto b = b_col[z].u32;
       for (uint32_t i = 0; i < 8; ++i) { // 8 * 4 bits = 32 bits
@@ -127,9 +127,9 @@ struct FEDP<vt::int4, vt::int32>{
 
 template <>
 struct FEDP<vt::uint4, vt::int32>{
-  static uint32_t eval(const reg_data_t *a_row, const reg_data_t *b_col, uint32_t c_val) {
+  static uint32_t eval(const reg_data_t *a_row, const reg_data_t *b_col, uint32_t c_val, uint32_t tcK) {
     auto acc = bit_cast<int32_t>(c_val);
-    for (uint32_t z = 0; z < cfg::tcK; ++z) {
+    for (uint32_t z = 0; z < tcK; ++z) {
       auto a = a_row[z].u32;
       auto b = b_col[z].u32;
       for (uint32_t i = 0; i < 8; ++i) { // 8 * 4 bits = 32 bits
@@ -142,7 +142,7 @@ struct FEDP<vt::uint4, vt::int32>{
   }
 };
 
-using PFN_FEDP = uint32_t (*)(const reg_data_t*, const reg_data_t*, uint32_t);
+using PFN_FEDP = uint32_t (*)(const reg_data_t*, const reg_data_t*, uint32_t, uint32_t);
 
 static PFN_FEDP select_FEDP(uint32_t IT, uint32_t OT) {
   switch (OT) {
@@ -196,12 +196,101 @@ static PFN_FEDP select_FEDP(uint32_t IT, uint32_t OT) {
   }
 }
 
+static uint32_t fmt_ops_per_word(uint32_t fmt) {
+  switch (fmt) {
+  case vt::fp16::id:
+  case vt::bf16::id:
+    return 2;
+  case vt::int8::id:
+  case vt::uint8::id:
+    return 4;
+  case vt::int4::id:
+  case vt::uint4::id:
+    return 8;
+  default:
+    return 1;
+  }
+}
+
+bool TensorUnit::resolve_config(uint32_t tcM, uint32_t tcN, uint32_t tcK, uint32_t k_fusion, Config* config) {
+  // the warp fragment and its register count are fixed by the WMMA register
+  // ABI; the step shape decides how the fragment is spread over the lanes.
+  uint32_t tileM = cfg::tcM * cfg::m_steps;
+  uint32_t tileN = cfg::tcN * cfg::n_steps;
+  uint32_t tileK = cfg::tcK * cfg::k_steps;
+
+  Config c;
+  c.tcM = tcM;
+  c.tcN = tcN;
+  c.tcK = tcK;
+  c.k_fusion = k_fusion;
+  if (tcM == 0 || tcN == 0 || tcK == 0 || k_fusion == 0
+   || (tileM % tcM) != 0
+   || (tileN % tcN) != 0
+   || (tileK % tcK) != 0
+   || (NUM_THREADS % (tcM * tcK)) != 0
+   || (NUM_THREADS % (tcN * tcK)) != 0
+   || (tcM * tcN) > NUM_THREADS)
+    return false;
+  c.m_steps = tileM / tcM;
+  c.n_steps = tileN / tcN;
+  c.k_steps = tileK / tcK;
+  c.a_block_size = tcM * tcK;
+  c.a_sub_blocks = NUM_THREADS / c.a_block_size;
+  c.b_block_size = tcN * tcK;
+  c.b_sub_blocks = NUM_THREADS / c.b_block_size;
+  if ((c.m_steps % c.a_sub_blocks) != 0
+   || ((c.k_steps * c.n_steps) % c.b_sub_blocks) != 0
+   || (c.m_steps * c.n_steps) > (cfg::m_steps * cfg::n_steps) // C registers
+   || c.m_steps > IntrTcuArgs::MAX_STEPS
+   || c.n_steps > IntrTcuArgs::MAX_STEPS
+   || c.k_steps > IntrTcuArgs::MAX_STEPS
+   || (c.k_steps % k_fusion) != 0)
+    return false;
+  c.ra_base = 0;
+  c.rb_base = (cfg::NRB == 4) ? 28 : 10;
+  c.rc_base = (cfg::NRB == 4) ? 10 : 24;
+  *config = c;
+  return true;
+}
+
+bool TensorUnit::resolve_config(const Arch& arch, Config* config) {
+  uint32_t tcM = arch.tcu_tile_m() ? arch.tcu_tile_m() : cfg::tcM;
+  uint32_t tcN = arch.tcu_tile_n() ? arch.tcu_tile_n() : cfg::tcN;
+  uint32_t tcK = arch.tcu_tile_k() ? arch.tcu_tile_k() : cfg::tcK;
+  uint32_t k_fusion = arch.tcu_k_fusion() ? arch.tcu_k_fusion() : 1;
+  // nothing in the instruction stream says which lane layout the kernel used,
+  // so a step shape the kernel was not built for is rejected up front rather
+  // than left to produce a wrong product.
+  uint32_t kM = arch.tcu_kernel_tile_m() ? arch.tcu_kernel_tile_m() : cfg::tcM;
+  uint32_t kN = arch.tcu_kernel_tile_n() ? arch.tcu_kernel_tile_n() : cfg::tcN;
+  uint32_t kK = arch.tcu_kernel_tile_k() ? arch.tcu_kernel_tile_k() : cfg::tcK;
+  if (tcM != kM || tcN != kN || tcK != kK)
+    return false;
+  return resolve_config(tcM, tcN, tcK, k_fusion, config);
+}
+
+static TensorUnit::Config make_config(const Arch& arch) {
+  TensorUnit::Config c;
+  if (!TensorUnit::resolve_config(arch, &c)) {
+    std::cout << "Error: unsupported tensor core tile: " << arch.tcu_tile_m() << "x" << arch.tcu_tile_n()
+              << "x" << arch.tcu_tile_k() << ", k_fusion=" << arch.tcu_k_fusion()
+              << ", kernel tile " << arch.tcu_kernel_tile_m() << "x" << arch.tcu_kernel_tile_n()
+              << "x" << arch.tcu_kernel_tile_k() << " (0 = " << cfg::tcM << "x" << cfg::tcN << "x" << cfg::tcK
+              << ", fragment " << (cfg::tcM * cfg::m_steps) << "x" << (cfg::tcN * cfg::n_steps)
+              << "x" << (cfg::tcK * cfg::k_steps) << ", threads=" << NUM_THREADS << ")!" << std::endl;
+    std::abort();
+  }
+  return c;
+}
+
 class TensorUnit::Impl {
 public:
   Impl(TensorUnit* simobject, const Arch& arch, Core* core)
     : simobject_(simobject)
     , core_(core)
     , arch_(arch)
+    , config_(make_config(arch))
     , perf_stats_()
   {
     //--
@@ -216,6 +305,7 @@ public:
   }
 
   void tick() {
+    bool busy = false;
     for (uint32_t iw = 0; iw < ISSUE_WIDTH; ++iw) {
       auto& input = simobject_->Inputs.at(iw);
       if (input.empty())
@@ -224,16 +314,26 @@ public:
       auto tcu_type = std::get<TcuType>(trace->op_type);
       int delay = 0;
       switch (tcu_type) {
-      case TcuType::WMMA:
-        delay = 4;
-        break;
+      case TcuType::WMMA: {
+        auto trace_data = std::dynamic_pointer_cast<ExeTraceData>(trace->data);
+        delay = trace_data->latency;
+      } break;
       default:
         std::abort();
       }
-      simobject_->Outputs.at(iw).push(trace, 2 + delay);
+      perf_stats_.latency += delay;
+      ++perf_stats_.wmmas;
+      uint32_t latency = 2 + delay;
+      if (core_->event_trace()) {
+        core_->event_trace()->tcu(trace, latency);
+      }
+      BT(Wmma, core_->trace_src(), trace->wid, trace->uuid, trace->PC, latency);
+      busy = true;
+      simobject_->Outputs.at(iw).push(trace, latency);
       DT(3, simobject_->name() << ": op=" << tcu_type << ", " << *trace);
       input.pop();
     }
+    perf_stats_.busy_cycles += busy;
   }
 
   void wmma(uint32_t wid,
@@ -241,42 +341,59 @@ public:
             uint32_t fmt_d,
             uint32_t step_m,
             uint32_t step_n,
-            const std::vector<reg_data_t>& rs1_data,
-            const std::vector<reg_data_t>& rs2_data,
-            const std::vector<reg_data_t>& rs3_data,
+            uint32_t step_k,
+            const std::vector<std::vector<reg_data_t>>& a_data,
+            const std::vector<std::vector<reg_data_t>>& b_data,
+            const std::vector<reg_data_t>& c_data,
             std::vector<reg_data_t>& rd_data,
             ExeTraceData* trace_data) {
-    __unused(wid);
-    __unused(trace_data);
+    __unused(wid, step_k);
+    assert(a_data.size() == config_.k_fusion && b_data.size() == config_.k_fusion);
 
     auto fedp = select_FEDP(fmt_s, fmt_d);
 
-    uint32_t a_off = (step_m % cfg::a_sub_blocks) * cfg::a_block_size;
-    uint32_t b_off = (step_n % cfg::b_sub_blocks) * cfg::b_block_size;
-
-    for (uint32_t i = 0; i < cfg::tcM; ++i) {
-      for (uint32_t j = 0; j < cfg::tcN; ++j) {
-        auto a_row = rs1_data.data() + a_off + i * cfg::tcK;
-        auto b_col = rs2_data.data() + b_off + j * cfg::tcK;
-        auto c_val = rs3_data.at(i * cfg::tcN + j).u32;
-        auto d_val = fedp(a_row, b_col, c_val);
-        rd_data.at(i * cfg::tcN + j).u64 = nan_box(d_val);
-
-        DTH(3, "FEDP: wid=" << wid << ", i=" << i << ", j=" << j << ", m=" << step_m << ", n=" << step_n << ", a_row={" << std::hex);
-        for (uint32_t q = 0; q < cfg::tcK; ++q) {
-          if (q) DTN(3, ", ");
-          DTN(3, "0x" << a_row[q].u32);
+    uint32_t tcM = config_.tcM;
+    uint32_t tcN = config_.tcN;
+    uint32_t tcK = config_.tcK;
+    uint32_t a_off = (step_m % config_.a_sub_blocks) * config_.a_block_size;
+    uint32_t b_off = (step_n % config_.b_sub_blocks) * config_.b_block_size;
+
+    // multiplier + adder tree over the step depth; the fused k-steps then
+    // stream through it one per cycle, accumulating in place.
+    uint32_t tree_depth = log2ceil(tcK * fmt_ops_per_word(fmt_s));
+    trace_data->latency = 2 + tree_depth + (config_.k_fusion - 1);
+    perf_stats_.macs += tcM * tcN * tcK * fmt_ops_per_word(fmt_s) * config_.k_fusion;
+
+    for (uint32_t i = 0; i < tcM; ++i) {
+      for (uint32_t j = 0; j < tcN; ++j) {
+        auto d_val = c_data.at(i * tcN + j).u32;
+        for (uint32_t s = 0; s < config_.k_fusion; ++s) {
+          auto a_row = a_data.at(s).data() + a_off + i * tcK;
+          auto b_col = b_data.at(s).data() + b_off + j * tcK;
+          auto c_val = d_val;
+          d_val = fedp(a_row, b_col, c_val, tcK);
+
+          DTH(3, "FEDP: wid=" << wid << ", i=" << i << ", j=" << j << ", m=" << step_m << ", n=" << step_n << ", k=" << (step_k + s) << ", a_row={" << std::hex);
+          for (uint32_t q = 0; q < tcK; ++q) {
+            if (q) DTN(3, ", ");
+            DTN(3, "0x" << a_row[q].u32);
+          }
+          DTN(3, "}, b_col={");
+          for (uint32_t q = 0; q < tcK; ++q) {
+            if (q) DTN(3, ", ");
+            DTN(3, "0x" << b_col[q].u32);
+          }
+          DTN(3, "}, c_val=0x" << c_val << ", d_val=0x" << d_val << std::dec << std::endl);
         }
-        DTN(3, "}, b_col={");
-        for (uint32_t q = 0; q < cfg::tcK; ++q) {
-          if (q) DTN(3, ", ");
-          DTN(3, "0x" << b_col[q].u32);
-        }
-        DTN(3, "}, c_val=0x" << c_val << ", d_val=0x" << d_val << std::dec << std::endl);
+        rd_data.at(i * tcN + j).u64 = nan_box(d_val);
       }
     }
   }
 
+  const Config& config() const {
+    return config_;
+  }
+
   const PerfStats& perf_stats() const {
     return perf_stats_;
   }
@@ -286,6 +403,7 @@ private:
   TensorUnit*   simobject_;
   Core*         core_;
   Arch          arch_;
+  Config        config_;
   PerfStats     perf_stats_;
 };
 
@@ -295,7 +413,7 @@ op_string_t vortex::op_string(TcuType tcu_type, IntrTcuArgs args) {
   switch (tcu_type) {
   case TcuType::WMMA:
     return {"WMMA." + std::string(vt::fmt_string(args.fmt_s)) + "." + std::string(vt::fmt_string(args.fmt_d))
-             + "." + std::to_string(args.step_m) + "." + std::to_string(args.step_n), ""};
+             + "." + std::to_string(args.step_m) + "." + std::to_string(args.step_n) + "." + std::to_string(args.step_k), ""};
   default:
     std::abort();
   }
@@ -322,6 +440,10 @@ void TensorUnit::tick() {
   impl_->tick();
 }
 
+const TensorUnit::Config &TensorUnit::config() const {
+	return impl_->config();
+}
+
 const TensorUnit::PerfStats &TensorUnit::perf_stats() const {
 	return impl_->perf_stats();
 }
@@ -331,10 +453,11 @@ void TensorUnit::wmma(uint32_t wid,
                       uint32_t fmt_d,
                       uint32_t step_m,
                       uint32_t step_n,
-                      const std::vector<reg_data_t>& rs1_data,
-                      const std::vector<reg_data_t>& rs2_data,
-                      const std::vector<reg_data_t>& rs3_data,
+                      uint32_t step_k,
+                      const std::vector<std::vector<reg_data_t>>& a_data,
+                      const std::vector<std::vector<reg_data_t>>& b_data,
+                      const std::vector<reg_data_t>& c_data,
                       std::vector<reg_data_t>& rd_data,
                       ExeTraceData* trace_data) {
-  impl_->wmma(wid, fmt_s, fmt_d, step_m, step_n, rs1_data, rs2_data, rs3_data, rd_data, trace_data);
+  impl_->wmma(wid, fmt_s, fmt_d, step_m, step_n, step_k, a_data, b_data, c_data, rd_data, trace_data);
 }
\ No newline at end of file
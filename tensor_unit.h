@@ -27,17 +27,67 @@ public:
 
   struct ExeTraceData : public ITraceData {
     using Ptr = std::shared_ptr<ExeTraceData>;
+    uint32_t latency;
+    ExeTraceData() : latency(0) {}
   };
 
+  // WMMA geometry resolved at construction (tensor_cfg.h defaults + Arch overrides).
+  // The fragment size and register footprint are fixed, but the lane layout of
+  // the A/B/C fragments follows the step shape: kernels must be built for it.
+  struct Config {
+    uint32_t tcM;          // step rows
+    uint32_t tcN;          // step columns
+    uint32_t tcK;          // step depth in 32-bit words
+    uint32_t m_steps;
+    uint32_t n_steps;
+    uint32_t k_steps;
+    uint32_t a_block_size;
+    uint32_t a_sub_blocks;
+    uint32_t b_block_size;
+    uint32_t b_sub_blocks;
+    uint32_t ra_base;      // first A/B/C fragment registers
+    uint32_t rb_base;
+    uint32_t rc_base;
+    uint32_t k_fusion;     // k-steps accumulated in place by one wmma micro-op
+
+    // fragment registers of step (m, n, k)
+    uint32_t a_reg(uint32_t m, uint32_t k) const {
+      return ra_base + (m / a_sub_blocks) * k_steps + k;
+    }
+    uint32_t b_reg(uint32_t n, uint32_t k) const {
+      return rb_base + (k * n_steps + n) / b_sub_blocks;
+    }
+    uint32_t c_reg(uint32_t m, uint32_t n) const {
+      return rc_base + m * n_steps + n;
+    }
+  };
+
+  // derive the step counts and register blocking of a step shape;
+  // returns false if the shape does not tile the WMMA fragment.
+  static bool resolve_config(uint32_t tcM, uint32_t tcN, uint32_t tcK, uint32_t k_fusion, Config* config);
+
+  // resolve the step shape configured in <arch>; also returns false if it
+  // differs from the shape the kernel laid its fragments out for.
+  static bool resolve_config(const Arch& arch, Config* config);
+
 	struct PerfStats {
 		uint64_t latency;
+		uint64_t wmmas;       // issued wmma micro-ops (one per fused k-group)
+		uint64_t macs;        // multiply-accumulates performed
+		uint64_t busy_cycles; // cycles with at least one wmma issued
 
 		PerfStats()
 			: latency(0)
+			, wmmas(0)
+			, macs(0)
+			, busy_cycles(0)
 		{}
 
 		PerfStats& operator+=(const PerfStats& rhs) {
-			this->latency += rhs.latency;
+			this->latency     += rhs.latency;
+			this->wmmas       += rhs.wmmas;
+			this->macs        += rhs.macs;
+			this->busy_cycles += rhs.busy_cycles;
 			return *this;
 		}
 	};
@@ -52,17 +102,22 @@ public:
 
   virtual void tick();
 
+	// a_data/b_data hold the A/B registers of the k_fusion steps starting at
+	// step_k; they are accumulated in k order onto c_data.
 	void wmma(uint32_t wid,
 			 	    uint32_t fmt_s,
 						uint32_t fmt_d,
 			 	    uint32_t step_m,
 						uint32_t step_n,
-	          const std::vector<reg_data_t>& rs1_data,
-					  const std::vector<reg_data_t>& rs2_data,
-					  const std::vector<reg_data_t>& rs3_data,
+						uint32_t step_k,
+	          const std::vector<std::vector<reg_data_t>>& a_data,
+					  const std::vector<std::vector<reg_data_t>>& b_data,
+					  const std::vector<reg_data_t>& c_data,
 					  std::vector<reg_data_t>& rd_data,
 					  ExeTraceData* trace_data);
 
+	const Config& config() const;
+
 	const PerfStats& perf_stats() const;
 
 private:
@@ -0,0 +1,80 @@
+#include "energy_model.h"
+#include "../pre_conv/pre_conv.h"
+#include <random>
+
+namespace otc {
+
+namespace {
+
+bool same_counters(const EnergyCounters& x, const EnergyCounters& y) {
+    return x.mul_fp9 == y.mul_fp9 && x.add_fp13 == y.add_fp13 && x.add_fp22 == y.add_fp22 &&
+           x.conv_in == y.conv_in && x.conv_fp13 == y.conv_fp13 && x.conv_fp22 == y.conv_fp22 &&
+           x.conv_out == y.conv_out && x.operand_bits == y.operand_bits && x.toggles == y.toggles;
+}
+
+} // namespace
+
+double energy_pj(const EnergyCounters& c, const EnergyTable& t) {
+    return c.mul_fp9 * t.mul_fp9 + c.add_fp13 * t.add_fp13 + c.add_fp22 * t.add_fp22 +
+           c.conv_in * t.conv_in + c.conv_fp13 * t.conv_fp13 + c.conv_fp22 * t.conv_fp22 +
+           c.conv_out * t.conv_out + c.operand_bits * t.operand_bit + c.toggles * t.toggle;
+}
+
+EnergyResult run_energy_model(PrecisionType prec, int gemms, double zero_fraction, unsigned seed) {
+    constexpr int M = TensorCoreSim::M, K = TensorCoreSim::K, N = TensorCoreSim::N;
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    TensorCoreCfg cfg;
+    cfg.input_prec = prec;
+    cfg.output_prec = PREC_FP32;
+
+    TensorCoreSim sim{};
+    sim.reset();
+
+    uint16_t a[M][K], b[K][N];
+    uint32_t c[M][N] = {};
+    EnergyCounters jobs_total;
+    int completed = 0;
+    for (int g = 0; g < gemms; ++g) {
+        for (auto& row : a)
+            for (auto& x : row)
+                x = coin(rng) < zero_fraction ? 0 : convert_input_to_fp9(random_input(rng, prec), prec);
+        for (auto& row : b)
+            for (auto& x : row) x = convert_input_to_fp9(random_input(rng, prec), prec);
+        while (!sim.can_issue())
+            sim.tick();
+        TcTag tag;
+        tag.reg_idxw = g;
+        sim.issue(tag,
+                  MatrixView<const uint16_t>::row_major(&a[0][0], K),
+                  MatrixView<const uint16_t>::row_major(&b[0][0], N),
+                  MatrixView<const uint32_t>::row_major(&c[0][0], N),
+                  cfg);
+        sim.tick();
+        TensorCoreSim::Completion done;
+        while (sim.pop_completion(done)) {
+            jobs_total += done.energy;
+            completed++;
+        }
+    }
+    bool drained = sim.drain() >= 0;
+    TensorCoreSim::Completion done;
+    while (sim.pop_completion(done)) {
+        jobs_total += done.energy;
+        completed++;
+    }
+
+    EnergyResult result;
+    result.prec = prec;
+    result.gemms = gemms;
+    result.zero_fraction = zero_fraction;
+    result.counters = sim.energy;
+    result.pj = energy_pj(sim.energy);
+    result.pj_per_gemm = gemms ? result.pj / gemms : 0.0;
+    result.pj_per_mac = gemms ? result.pj / ((double)gemms * M * N * K) : 0.0;
+    result.jobs_sum_to_total = drained && completed == gemms && same_counters(jobs_total, sim.energy);
+    return result;
+}
+
+} // namespace otc
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "../tensor_core_sim.h"
+
+namespace otc {
+
+// Per-event energies in pJ, applied to TensorCoreSim's activity counters.
+// Fixed costs per operation plus the data-dependent part: operand bits read
+// into the unit and datapath register bits that toggle.
+struct EnergyTable {
+    double mul_fp9 = 0.20;
+    double add_fp13 = 0.12;
+    double add_fp22 = 0.25;
+    double conv_in = 0.02;      // A/B element to FP9
+    double conv_fp13 = 0.01;    // FP9 product to FP13
+    double conv_fp22 = 0.01;    // FP13 tree sum to FP22
+    double conv_out = 0.03;     // FP22 to the output format
+    double operand_bit = 0.05;
+    double toggle = 0.004;
+};
+
+double energy_pj(const EnergyCounters& counters, const EnergyTable& table = {});
+
+struct EnergyResult {
+    PrecisionType  prec;
+    int            gemms;
+    double         zero_fraction;
+    EnergyCounters counters;
+    double         pj;
+    double         pj_per_gemm;
+    double         pj_per_mac;
+    bool           jobs_sum_to_total;  // per-job counters add up to the unit's
+};
+
+// <gemms> independent 8x8x8 GEMMs of random <prec> operands, a <zero_fraction>
+// of the A elements set to zero
+EnergyResult run_energy_model(PrecisionType prec, int gemms, double zero_fraction, unsigned seed = 1);
+
+} // namespace otc
@@ -0,0 +1,125 @@
+#include "issue_model.h"
+#include "../pre_conv/pre_conv.h"
+#include <random>
+
+namespace otc {
+
+namespace {
+
+constexpr int MATRIX_BUS_WIDTH = 512; // define.v, bits per operand transfer
+
+} // namespace
+
+int operand_cycles(PrecisionType prec) {
+    constexpr int M = TensorCoreSim::M, K = TensorCoreSim::K, N = TensorCoreSim::N;
+    int bits = (M * K + K * N) * input_element_bits(prec);
+    return (bits + MATRIX_BUS_WIDTH - 1) / MATRIX_BUS_WIDTH;
+}
+
+IssueResult run_multi_warp(PrecisionType prec, int num_warps, int jobs_per_warp, unsigned seed) {
+    constexpr int M = TensorCoreSim::M, K = TensorCoreSim::K, N = TensorCoreSim::N;
+
+    struct WarpState {
+        uint16_t a[M][K];
+        uint16_t b[K][N];
+        uint32_t acc[M][N];   // FP22 accumulator, C of the next step
+        int      issued = 0;
+        bool     pending = false;
+    };
+
+    std::mt19937 rng(seed);
+    std::vector<WarpState> warps(num_warps);
+    for (auto& w : warps) {
+        for (auto& row : w.a)
+            for (auto& x : row) x = convert_input_to_fp9(random_input(rng, prec), prec);
+        for (auto& row : w.b)
+            for (auto& x : row) x = convert_input_to_fp9(random_input(rng, prec), prec);
+        for (auto& row : w.acc)
+            for (auto& x : row) x = 0;
+    }
+
+    TensorCoreCfg cfg;
+    cfg.input_prec = prec;
+    cfg.output_prec = PREC_FP32;
+
+    TensorCoreSim sim{};
+    sim.reset();
+
+    const int interval = operand_cycles(prec);
+    const int total = num_warps * jobs_per_warp;
+    int completed = 0;
+    int cycles = 0;
+    int next_warp = 0;
+    int xfer_warp = -1;
+    int xfer_left = 0;
+
+    while (completed < total) {
+        // start the next operand transfer, round-robin over ready warps
+        if (xfer_warp < 0) {
+            for (int n = 0; n < num_warps; ++n) {
+                int w = (next_warp + n) % num_warps;
+                if (!warps[w].pending && warps[w].issued < jobs_per_warp) {
+                    xfer_warp = w;
+                    xfer_left = interval;
+                    warps[w].pending = true;
+                    next_warp = (w + 1) % num_warps;
+                    break;
+                }
+            }
+        }
+        // the job issues in the cycle its last operand beat arrives, or
+        // later if the input port is still taken
+        if (xfer_warp >= 0 && xfer_left > 0)
+            xfer_left--;
+        if (xfer_warp >= 0 && xfer_left == 0 && sim.can_issue()) {
+            auto& w = warps[xfer_warp];
+            TcTag tag;
+            tag.warp_id = xfer_warp;
+            tag.reg_idxw = w.issued;
+            sim.issue(tag,
+                      MatrixView<const uint16_t>::row_major(&w.a[0][0], K),
+                      MatrixView<const uint16_t>::row_major(&w.b[0][0], N),
+                      MatrixView<const uint32_t>::row_major(&w.acc[0][0], N),
+                      cfg);
+            w.issued++;
+            xfer_warp = -1;
+        }
+
+        sim.tick();
+        cycles++;
+
+        TensorCoreSim::Completion done;
+        while (sim.pop_completion(done)) {
+            auto& w = warps[done.tag.warp_id];
+            for (int i = 0; i < M; ++i)
+                for (int j = 0; j < N; ++j)
+                    w.acc[i][j] = done.d_fp22[i][j];
+            w.pending = false;
+            completed++;
+        }
+    }
+
+    IssueResult result;
+    result.prec = prec;
+    result.warps = num_warps;
+    result.jobs = total;
+    result.cycles = cycles;
+    result.jobs_per_cycle = cycles ? (double)total / cycles : 0.0;
+    result.peak_jobs_per_cycle = 1.0 / interval;
+    return result;
+}
+
+int warps_to_saturate(PrecisionType prec, int max_warps, double threshold,
+                      std::vector<IssueResult>* sweep) {
+    constexpr int JOBS_PER_WARP = 32;
+    for (int w = 1; w <= max_warps; ++w) {
+        IssueResult r = run_multi_warp(prec, w, JOBS_PER_WARP);
+        if (sweep)
+            sweep->push_back(r);
+        if (r.jobs_per_cycle >= threshold * r.peak_jobs_per_cycle)
+            return w;
+    }
+    return 0;
+}
+
+} // namespace otc
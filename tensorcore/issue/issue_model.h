@@ -0,0 +1,31 @@
+#pragma once
+
+#include "../tensor_core_sim.h"
+#include <vector>
+
+namespace otc {
+
+// Multi-warp issue model on top of TensorCoreSim's tagged jobs. Each warp
+// runs a chain of dependent GEMM steps (step n accumulates onto step n-1's
+// D), so a warp has at most one job in flight. A and B reach the unit over
+// the MATRIX_BUS_WIDTH operand bus, which serializes the warps' transfers.
+struct IssueResult {
+    PrecisionType prec;
+    int    warps;
+    int    jobs;
+    int    cycles;
+    double jobs_per_cycle;
+    double peak_jobs_per_cycle;   // operand-bus bound
+};
+
+// cycles to move one job's A and B over the operand bus
+int operand_cycles(PrecisionType prec);
+
+IssueResult run_multi_warp(PrecisionType prec, int num_warps, int jobs_per_warp, unsigned seed = 1);
+
+// smallest warp count reaching <threshold> of peak throughput, 0 if none up
+// to <max_warps>; every run is appended to <sweep> when given
+int warps_to_saturate(PrecisionType prec, int max_warps, double threshold,
+                      std::vector<IssueResult>* sweep = nullptr);
+
+} // namespace otc
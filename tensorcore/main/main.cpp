@@ -4,7 +4,12 @@
 namespace otc {
 
 int run_main() {
-    return run_smoke_test();
+    int status = run_smoke_test();
+    status |= run_layout_test();
+    status |= run_tagged_test();
+    status |= run_issue_model_test();
+    status |= run_energy_model_test();
+    return status;
 }
 
 } // namespace otc
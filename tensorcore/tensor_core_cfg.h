@@ -4,10 +4,20 @@
 // =============================================================================
 #include "fp_types.h"
 
+// layout bits, as in config_registers.v: set = column-major, clear = row-major
+enum : uint8_t {
+    LAYOUT_A = 1 << 0,
+    LAYOUT_B = 1 << 1,
+    LAYOUT_C = 1 << 2,
+    LAYOUT_D = 1 << 3,
+};
+
 struct TensorCoreCfg {
     PrecisionType input_prec  = PREC_FP8_E4M3;
     PrecisionType output_prec = PREC_FP8_E4M3;
     RoundingMode  rm          = RNE;
+    uint8_t       layout      = 0;      // LAYOUT_* bits
+    bool          transpose_en = false; // write D^T back instead of D
 };
 
 uint32_t convert_fp22_to_output_bits(uint32_t fp22, PrecisionType output_prec, RoundingMode rm);
@@ -11,7 +11,9 @@
 #include "tensor_core_cfg.h"
 #include <array>
 #include <vector>
+#include <deque>
 #include <functional>
+#include <random>
 #include <cstdio>
 
 // =============================================================================
@@ -74,6 +76,29 @@ struct PipeStage2 {
     void reset() { valid1 = valid2 = false; }
 };
 
+// =============================================================================
+// MatrixView: strided view over a caller buffer, element (r, c) at
+// data[r * row_stride + c * col_stride]. Row/column-major layouts, leading
+// dimensions and transposes are only stride choices, so operands are read in
+// place with no host-side reshuffle.
+// =============================================================================
+template <typename T>
+struct MatrixView {
+    T*  data;
+    int row_stride;
+    int col_stride;
+
+    T& operator()(int r, int c) const { return data[r * row_stride + c * col_stride]; }
+
+    MatrixView transposed() const { return {data, col_stride, row_stride}; }
+
+    static MatrixView row_major(T* data, int ld) { return {data, ld, 1}; }
+    static MatrixView col_major(T* data, int ld) { return {data, 1, ld}; }
+    static MatrixView with_layout(T* data, int ld, bool col_major) {
+        return col_major ? MatrixView::col_major(data, ld) : MatrixView::row_major(data, ld);
+    }
+};
+
 // =============================================================================
 // Data tokens flowing through the pipeline
 // =============================================================================
@@ -82,20 +107,64 @@ struct MulInput {
     uint16_t b;  // FP9
 };
 
+// Every token carries its job slot, like the RTL ctrl_warpid/ctrl_reg_idxw
+// sideband, and the second operand of its adder, so jobs issued on
+// consecutive cycles never read each other's operands.
 struct MulStage1Data {
     FMulS1Out s1;
     uint16_t  a_bits;  // preserved for s2
     uint16_t  b_bits;
+    int       job;
 };
 
 struct FP13Token {
-    uint16_t value;  // packed FP13 (E5M7)
+    uint16_t value;   // packed FP13 (E5M7)
+    uint16_t addend;  // second adder operand
+    int      job;
 };
 
 struct FP22Token {
     uint32_t value;  // packed FP22
+    uint32_t bias;   // C[i][j] of the job
+    int      job;
 };
 
+// =============================================================================
+// Activity counters of the energy model: operations per kind, operand bits
+// read into the unit and register bits that toggle on a latch
+// =============================================================================
+struct EnergyCounters {
+    uint64_t mul_fp9 = 0, add_fp13 = 0, add_fp22 = 0;
+    uint64_t conv_in = 0, conv_fp13 = 0, conv_fp22 = 0, conv_out = 0;
+    uint64_t operand_bits = 0, toggles = 0;
+
+    EnergyCounters& operator+=(const EnergyCounters& o) {
+        mul_fp9 += o.mul_fp9; add_fp13 += o.add_fp13; add_fp22 += o.add_fp22;
+        conv_in += o.conv_in; conv_fp13 += o.conv_fp13; conv_fp22 += o.conv_fp22; conv_out += o.conv_out;
+        operand_bits += o.operand_bits; toggles += o.toggles;
+        return *this;
+    }
+};
+
+inline int input_element_bits(PrecisionType prec) {
+    switch (prec) {
+        case PREC_FP4_E2M1: return 4;
+        case PREC_FP8_E4M3:
+        case PREC_FP8_E5M2: return 8;
+        default:            return 16;
+    }
+}
+
+// Random raw input element of the given precision: FP16 values stay within
+// [-2, 2], the narrow formats take any bit pattern
+inline uint32_t random_input(std::mt19937& rng, PrecisionType prec) {
+    if (prec == PREC_FP16) {
+        std::uniform_real_distribution<double> dist(-2.0, 2.0);
+        return double_to_fp16(dist(rng));
+    }
+    return rng() & ((1u << input_element_bits(prec)) - 1);
+}
+
 // =============================================================================
 // Single dot-product pipeline (one output element of the 8×8 matrix)
 // Computes: D[i][j] = sum(A[i][k]*B[k][j] for k=0..7) + C[i][j]
@@ -104,8 +173,8 @@ struct DotProductPipeline {
     // Multiplier pipelines (8 parallel)
     PipeStage2<MulStage1Data> mul_pipe[8];
     // Multiplication products (held between mul output and add tree input)
-    uint16_t mul_results[8]; // FP13 intermediates
-    bool     mul_results_valid[8];
+    FP13Token mul_results[8]; // FP13 intermediates
+    bool      mul_results_valid[8];
 
     // Adder tree: Level 0 (4 adders), Level 1 (2 adders), Level 2 (1 adder)
     // Each is a 2-stage pipeline
@@ -128,15 +197,22 @@ struct DotProductPipeline {
     PrecisionType output_prec;
 
     // Intermediate storage for adder tree inputs
-    uint16_t add_L0_a[4], add_L0_b[4];
+    FP13Token add_L0_in[4];
     bool add_L0_input_valid[4];
-    uint16_t add_L1_a[2], add_L1_b[2];
+    FP13Token add_L1_in[2];
     bool add_L1_input_valid[2];
-    uint16_t add_L2_a, add_L2_b;
+    FP13Token add_L2_in;
     bool add_L2_input_valid;
-    uint32_t final_add_a; // FP22 from tree
-    uint32_t final_add_b; // FP22 from C
+    FP22Token final_add_in; // FP22 from tree, bias from C
     bool final_add_input_valid;
+    int  conv_job = -1;
+
+    // Last latched value of each datapath register, for the toggle count:
+    // multiplier operands, FP13 products, the 7 tree adders, the FP22 sum
+    uint16_t op_a_reg[8] = {}, op_b_reg[8] = {};
+    uint16_t prod_reg[8] = {};
+    uint16_t tree_reg[7] = {};
+    uint32_t acc_reg = 0;
 
     void reset() {
         for (int i = 0; i < 8; i++) { mul_pipe[i].reset(); mul_results_valid[i] = false; }
@@ -145,26 +221,64 @@ struct DotProductPipeline {
         add_L2.reset(); add_L2_input_valid = false;
         final_add.reset(); final_add_input_valid = false;
         conv_valid = false;
+        for (int i = 0; i < 8; i++) { op_a_reg[i] = op_b_reg[i] = prod_reg[i] = 0; }
+        for (auto& r : tree_reg) r = 0;
+        acc_reg = conv_out_bits = 0;
     }
 
-    // Returns output valid and result (FP8/FP16/FP32 depending on output_prec)
+    // Output valid this cycle and result (FP8/FP16/FP32 depending on output_prec)
     bool out_valid() const { return conv_valid; }
     uint32_t out_result() const { return conv_out_bits; }
 };
 
+// =============================================================================
+// Job tag: the writeback destination carried with every result, as
+// mm_mul_add.v's ctrl_warpid_o / ctrl_reg_idxw_o
+// =============================================================================
+struct TcTag {
+    uint32_t warp_id  = 0;
+    uint32_t reg_idxw = 0;
+};
+
 // =============================================================================
 // Top-level Tensor Core simulator: 8×8 matrix of dot product pipelines
 // Computes D[8×8] = A[8×8] × B[8×8] + C[8×8]
+// Jobs issue at most one per cycle and any number may be in flight; each
+// finished job is posted to the completion queue with its tag.
 // =============================================================================
 struct TensorCoreSim {
     static constexpr int M = 8, K = 8, N = 8;
     static constexpr int PIPELINE_DEPTH = 11;
+    static constexpr int MAX_JOBS = 16;  // in-flight job slots (> pipeline depth)
+
+    struct Job {
+        TcTag         tag;
+        TensorCoreCfg cfg;
+        uint32_t      c_fp22[M][N];
+        uint32_t      d_fp22[M][N];
+        uint32_t      d_out[M][N];
+        int           remaining = 0;  // outputs still in the pipeline
+        int           issue_cycle = 0;
+        bool          busy = false;
+        bool          post = true;    // push to the completion queue
+        EnergyCounters energy;
+    };
+
+    struct Completion {
+        TcTag    tag;
+        uint32_t d_fp22[M][N];
+        uint32_t d_out[M][N];
+        int      issue_cycle;
+        int      cycle;         // cycle the last output left the pipeline
+        EnergyCounters energy;  // activity of this job alone
+    };
 
     // 64 dot-product pipelines
     DotProductPipeline dp[M][N];
 
-    // Configuration
+    // Configuration of the last issued job
     TensorCoreCfg cfg;
+    TensorCoreCfg d_cfg;  // configuration of the untagged job d_out holds
 
     // Input data (all K elements arrive simultaneously)
     uint16_t a_fp9[M][K];  // A matrix in FP9
@@ -181,9 +295,16 @@ struct TensorCoreSim {
     bool output_ready = true;
     int  cycle_count  = 0;
 
+    // Job slots and completion queue
+    Job jobs[MAX_JOBS];
+    int issue_job = 0;   // slot injected on the next tick
+    int jobs_in_flight = 0;
+    std::deque<Completion> completions;
+
     // Statistics
     int total_cycles = 0;
     int jobs_completed = 0;
+    EnergyCounters energy;  // all jobs since reset()
 
     void reset() {
         for (int i = 0; i < M; i++)
@@ -191,39 +312,146 @@ struct TensorCoreSim {
                 dp[i][j].reset();
                 d_valid[i][j] = false;
             }
+        for (auto& job : jobs)
+            job.busy = false;
+        jobs_in_flight = 0;
+        completions.clear();
         input_loaded = false;
         cycle_count = 0;
         total_cycles = 0;
         jobs_completed = 0;
+        energy = {};
     }
 
-    // Load input matrices (already converted to FP9/FP22)
-    void load_inputs(const uint16_t a[M][K], const uint16_t b[K][N],
-                     const uint32_t c[M][N], const TensorCoreCfg& in_cfg)
+    // A job can issue this cycle: the input port is free and a slot is open
+    bool can_issue() const {
+        return !input_loaded && jobs_in_flight < MAX_JOBS;
+    }
+
+    // Issue a tagged job; it enters the multipliers on the next tick.
+    // Returns false when can_issue() is false.
+    bool issue(const TcTag& tag, MatrixView<const uint16_t> a, MatrixView<const uint16_t> b,
+               MatrixView<const uint32_t> c, const TensorCoreCfg& in_cfg)
     {
+        if (!can_issue())
+            return false;
+        int slot = 0;
+        while (jobs[slot].busy)
+            slot++;
+        auto& job = jobs[slot];
+        job.tag = tag;
+        job.cfg = in_cfg;
+        job.remaining = M * N;
+        job.issue_cycle = cycle_count;
+        job.busy = true;
+        job.post = true;
+        job.energy = {};
+        jobs_in_flight++;
+        account(slot, &EnergyCounters::conv_in, M * K + K * N);
+        account(slot, &EnergyCounters::operand_bits, (M * K + K * N) * input_element_bits(in_cfg.input_prec));
+
         cfg = in_cfg;
         for (int i = 0; i < M; i++)
             for (int k = 0; k < K; k++)
-                a_fp9[i][k] = a[i][k];
+                a_fp9[i][k] = a(i, k);
         for (int k = 0; k < K; k++)
             for (int j = 0; j < N; j++)
-                b_fp9[k][j] = b[k][j];
+                b_fp9[k][j] = b(k, j);
+        for (int i = 0; i < M; i++)
+            for (int j = 0; j < N; j++) {
+                c_fp22[i][j] = c(i, j);
+                job.c_fp22[i][j] = c_fp22[i][j];
+            }
+        issue_job = slot;
+        input_loaded = true;
+        return true;
+    }
+
+    // Oldest finished job, if any
+    bool pop_completion(Completion& out) {
+        if (completions.empty())
+            return false;
+        out = completions.front();
+        completions.pop_front();
+        return true;
+    }
+
+    // Tick until every issued job has completed; returns the cycles taken,
+    // or -1 when jobs are still in flight after 100 * MAX_JOBS cycles
+    int drain() {
+        int cycles = 0;
+        while (jobs_in_flight != 0 || input_loaded) {
+            if (cycles == 100 * MAX_JOBS)
+                return -1;
+            tick();
+            cycles++;
+        }
+        return cycles;
+    }
+
+    // Load input matrices (already converted to FP9/FP22) through strided
+    // views; the operand registers latch them element by element like the RTL
+    // operand collector, whatever the caller's layout. Returns false, leaving
+    // d_out untouched, when can_issue() is false.
+    bool load_inputs(MatrixView<const uint16_t> a, MatrixView<const uint16_t> b,
+                     MatrixView<const uint32_t> c, const TensorCoreCfg& in_cfg)
+    {
+        if (!can_issue())
+            return false;
         for (int i = 0; i < M; i++)
             for (int j = 0; j < N; j++) {
-                c_fp22[i][j] = c[i][j];
                 d_out[i][j] = 0;
                 d_valid[i][j] = false;
             }
-        input_loaded = true;
+        // untagged jobs are read back through d_out, not the queue
+        issue(TcTag{}, a, b, c, in_cfg);
+        jobs[issue_job].post = false;
+        d_cfg = in_cfg;
+        return true;
     }
 
-    void load_inputs(const uint16_t a[M][K], const uint16_t b[K][N],
+    // Load caller buffers laid out per in_cfg.layout, with leading dimensions
+    // lda/ldb/ldc (the row pitch when row-major, the column pitch otherwise)
+    bool load_inputs(const uint16_t* a, int lda, const uint16_t* b, int ldb,
+                     const uint32_t* c, int ldc, const TensorCoreCfg& in_cfg)
+    {
+        return load_inputs(MatrixView<const uint16_t>::with_layout(a, lda, in_cfg.layout & LAYOUT_A),
+                    MatrixView<const uint16_t>::with_layout(b, ldb, in_cfg.layout & LAYOUT_B),
+                    MatrixView<const uint32_t>::with_layout(c, ldc, in_cfg.layout & LAYOUT_C),
+                    in_cfg);
+    }
+
+    bool load_inputs(const uint16_t a[M][K], const uint16_t b[K][N],
+                     const uint32_t c[M][N], const TensorCoreCfg& in_cfg)
+    {
+        return load_inputs(MatrixView<const uint16_t>::row_major(&a[0][0], K),
+                    MatrixView<const uint16_t>::row_major(&b[0][0], N),
+                    MatrixView<const uint32_t>::row_major(&c[0][0], N),
+                    in_cfg);
+    }
+
+    bool load_inputs(const uint16_t a[M][K], const uint16_t b[K][N],
                      const uint32_t c[M][N], PrecisionType prec, RoundingMode r = RNE) {
         TensorCoreCfg in_cfg;
         in_cfg.input_prec = prec;
         in_cfg.output_prec = prec;
         in_cfg.rm = r;
-        load_inputs(a, b, c, in_cfg);
+        return load_inputs(a, b, c, in_cfg);
+    }
+
+    // Write D back through a strided view; transpose_en (of the job that
+    // produced d_out) writes D^T
+    void store_outputs(MatrixView<uint32_t> d) const {
+        if (d_cfg.transpose_en)
+            d = d.transposed();
+        for (int i = 0; i < M; i++)
+            for (int j = 0; j < N; j++)
+                d(i, j) = d_out[i][j];
+    }
+
+    // Write D into a caller buffer laid out per d_cfg.layout (LAYOUT_D)
+    void store_outputs(uint32_t* d, int ldd) const {
+        store_outputs(MatrixView<uint32_t>::with_layout(d, ldd, d_cfg.layout & LAYOUT_D));
     }
 
     // Run the full pipeline until all outputs are valid
@@ -245,7 +473,6 @@ struct TensorCoreSim {
         }
 
         total_cycles += cycles;
-        jobs_completed++;
         input_loaded = false;
         return cycles;
     }
@@ -267,22 +494,77 @@ struct TensorCoreSim {
     }
 
 private:
+    // Charge n events of one kind to a job and to the unit total
+    void account(int slot, uint64_t EnergyCounters::*field, uint64_t n) {
+        jobs[slot].energy.*field += n;
+        energy.*field += n;
+    }
+
+    // Latch v into a datapath register, charging the bits that flip
+    template <typename R>
+    void latch(R& reg, uint32_t v, int slot) {
+        account(slot, &EnergyCounters::toggles, __builtin_popcount((uint32_t)reg ^ v));
+        reg = (R)v;
+    }
+
+    // Stage 11 result of one dot product; posts the job once all 64 are out
+    void retire_output(int i, int j, int slot, uint32_t fp22, uint32_t bits) {
+        auto& job = jobs[slot];
+        job.d_fp22[i][j] = fp22;
+        job.d_out[i][j] = bits;
+        if (--job.remaining != 0)
+            return;
+        if (job.post) {
+            Completion done;
+            done.tag = job.tag;
+            for (int r = 0; r < M; r++)
+                for (int c = 0; c < N; c++) {
+                    done.d_fp22[r][c] = job.d_fp22[r][c];
+                    done.d_out[r][c] = job.d_out[r][c];
+                }
+            done.issue_cycle = job.issue_cycle;
+            done.cycle = cycle_count;
+            done.energy = job.energy;
+            completions.push_back(done);
+        }
+        job.busy = false;
+        jobs_in_flight--;
+        jobs_completed++;
+    }
+
+    // Stage 2 of tree adder <node> (0-3 L0, 4-5 L1, 6 L2)
+    FP13Token tree_add(DotProductPipeline& p, int node, const FP13Token& in) {
+        uint16_t sum = fp13_add(in.value, in.addend, jobs[in.job].cfg.rm);
+        account(in.job, &EnergyCounters::add_fp13, 1);
+        latch(p.tree_reg[node], sum, in.job);
+        return {sum, 0, in.job};
+    }
+
     void tick_dot_product(int i, int j) {
         auto& p = dp[i][j];
-        p.rm = cfg.rm;
-        p.output_prec = cfg.output_prec;
 
         // ============================================================
         // Stage 11: Output conversion (FP22 → output format)
         // ============================================================
         bool conv_out_ready = true; // always ready to accept output
-        if (p.final_add.out_valid() && !p.conv_valid) {
-            p.conv_valid = true;
-            p.conv_fp22 = p.final_add.out_data().value;
-            p.conv_out_bits = convert_fp22_to_output_bits(p.conv_fp22, p.output_prec, p.rm);
-            d_fp22[i][j] = p.conv_fp22;
-            d_out[i][j] = p.conv_out_bits;
-            d_valid[i][j] = true;
+        p.conv_valid = p.final_add.out_valid();
+        if (p.conv_valid) {
+            const FP22Token& out = p.final_add.out_data();
+            const TensorCoreCfg& job_cfg = jobs[out.job].cfg;
+            p.rm = job_cfg.rm;
+            p.output_prec = job_cfg.output_prec;
+            p.conv_job = out.job;
+            p.conv_fp22 = out.value;
+            uint32_t bits = convert_fp22_to_output_bits(p.conv_fp22, p.output_prec, p.rm);
+            latch(p.conv_out_bits, bits, out.job);
+            account(out.job, &EnergyCounters::conv_out, 1);
+            // d_out belongs to the untagged job; tagged ones go to the queue
+            if (!jobs[out.job].post) {
+                d_fp22[i][j] = p.conv_fp22;
+                d_out[i][j] = p.conv_out_bits;
+                d_valid[i][j] = true;
+            }
+            retire_output(i, j, out.job, p.conv_fp22, p.conv_out_bits);
         }
 
         // ============================================================
@@ -292,25 +574,25 @@ private:
         {
             // Check if we have input for final add
             bool final_in_valid = p.add_L2.out_valid() && !p.final_add_input_valid;
-            if (final_in_valid && !p.final_add_input_valid) {
-                // Convert FP9 tree result to FP22
-                p.final_add_a = fp13_to_fp22(p.add_L2.out_data().value);
-                p.final_add_b = c_fp22[i][j];
+            if (final_in_valid) {
+                // Convert FP13 tree result to FP22, fetch the job's bias
+                const FP13Token& tree = p.add_L2.out_data();
+                p.final_add_in = {fp13_to_fp22(tree.value), jobs[tree.job].c_fp22[i][j], tree.job};
                 p.final_add_input_valid = true;
+                account(tree.job, &EnergyCounters::conv_fp22, 1);
             }
 
-            bool fa_in_valid = p.final_add_input_valid;
-            FP22Token fa_in = {p.final_add_a};
-
-            p.final_add.tick(fa_in_valid, fa_in, final_out_ready,
+            p.final_add.tick(p.final_add_input_valid, p.final_add_in, final_out_ready,
                 // Stage 1: latch input, compute fadd_s1 (both paths stored implicitly)
                 [&](const FP22Token& in) -> FP22Token {
                     return in; // data latched; s1 computed in stage 2
                 },
                 // Stage 2: full FP22 add
                 [&](const FP22Token& in) -> FP22Token {
-                    uint32_t result = fp22_add(in.value, p.final_add_b, cfg.rm);
-                    return {result};
+                    uint32_t result = fp22_add(in.value, in.bias, jobs[in.job].cfg.rm);
+                    account(in.job, &EnergyCounters::add_fp22, 1);
+                    latch(p.acc_reg, result, in.job);
+                    return {result, in.bias, in.job};
                 });
 
             if (p.final_add.in_ready(final_out_ready) && p.final_add_input_valid) {
@@ -326,17 +608,14 @@ private:
             bool l2_in_valid = p.add_L1[0].out_valid() && p.add_L1[1].out_valid()
                                && !p.add_L2_input_valid;
             if (l2_in_valid) {
-                p.add_L2_a = p.add_L1[0].out_data().value;
-                p.add_L2_b = p.add_L1[1].out_data().value;
+                p.add_L2_in = {p.add_L1[0].out_data().value, p.add_L1[1].out_data().value,
+                               p.add_L1[0].out_data().job};
                 p.add_L2_input_valid = true;
             }
 
-            FP13Token l2_in = {p.add_L2_a};
-            p.add_L2.tick(p.add_L2_input_valid, l2_in, l2_out_ready,
+            p.add_L2.tick(p.add_L2_input_valid, p.add_L2_in, l2_out_ready,
                 [](const FP13Token& in) -> FP13Token { return in; },
-                [&](const FP13Token& in) -> FP13Token {
-                    return {fp13_add(in.value, p.add_L2_b, cfg.rm)};
-                });
+                [&](const FP13Token& in) -> FP13Token { return tree_add(p, 6, in); });
 
             if (p.add_L2.in_ready(l2_out_ready) && p.add_L2_input_valid) {
                 p.add_L2_input_valid = false;
@@ -354,17 +633,14 @@ private:
             bool l1_in_valid = p.add_L0[src0].out_valid() && p.add_L0[src1].out_valid()
                                && !p.add_L1_input_valid[a];
             if (l1_in_valid) {
-                p.add_L1_a[a] = p.add_L0[src0].out_data().value;
-                p.add_L1_b[a] = p.add_L0[src1].out_data().value;
+                p.add_L1_in[a] = {p.add_L0[src0].out_data().value, p.add_L0[src1].out_data().value,
+                                  p.add_L0[src0].out_data().job};
                 p.add_L1_input_valid[a] = true;
             }
 
-            FP13Token l1_in = {p.add_L1_a[a]};
-            p.add_L1[a].tick(p.add_L1_input_valid[a], l1_in, l1_out_ready[a],
+            p.add_L1[a].tick(p.add_L1_input_valid[a], p.add_L1_in[a], l1_out_ready[a],
                 [](const FP13Token& in) -> FP13Token { return in; },
-                [&, a](const FP13Token& in) -> FP13Token {
-                    return {fp13_add(in.value, p.add_L1_b[a], cfg.rm)};
-                });
+                [&](const FP13Token& in) -> FP13Token { return tree_add(p, 4 + a, in); });
 
             if (p.add_L1[a].in_ready(l1_out_ready[a]) && p.add_L1_input_valid[a]) {
                 p.add_L1_input_valid[a] = false;
@@ -385,17 +661,14 @@ private:
             bool l0_in_valid = p.mul_results_valid[src0] && p.mul_results_valid[src1]
                                && !p.add_L0_input_valid[a];
             if (l0_in_valid) {
-                p.add_L0_a[a] = p.mul_results[src0];
-                p.add_L0_b[a] = p.mul_results[src1];
+                p.add_L0_in[a] = {p.mul_results[src0].value, p.mul_results[src1].value,
+                                  p.mul_results[src0].job};
                 p.add_L0_input_valid[a] = true;
             }
 
-            FP13Token l0_in = {p.add_L0_a[a]};
-            p.add_L0[a].tick(p.add_L0_input_valid[a], l0_in, l0_out_ready[a],
+            p.add_L0[a].tick(p.add_L0_input_valid[a], p.add_L0_in[a], l0_out_ready[a],
                 [](const FP13Token& in) -> FP13Token { return in; },
-                [&, a](const FP13Token& in) -> FP13Token {
-                    return {fp13_add(in.value, p.add_L0_b[a], cfg.rm)};
-                });
+                [&](const FP13Token& in) -> FP13Token { return tree_add(p, a, in); });
 
             if (p.add_L0[a].in_ready(l0_out_ready[a]) && p.add_L0_input_valid[a]) {
                 p.add_L0_input_valid[a] = false;
@@ -408,22 +681,22 @@ private:
         // Stages 1-2: Multipliers (8 parallel)
         // ============================================================
         for (int k = 0; k < K; k++) {
-            bool mul_out_ready = true;
-            // Determine if add tree L0 can accept our output
-            int add_idx = k < 4 ? k : (k - 4);
-            // Actually mul outputs feed into L0 via mul_results buffer
+            // mul outputs feed into L0 via mul_results buffer
             // They're always "ready" as long as the buffer slot is free
-            mul_out_ready = !p.mul_results_valid[k];
+            bool mul_out_ready = !p.mul_results_valid[k];
 
             bool mul_in_valid = input_loaded && !p.mul_results_valid[k];
             MulStage1Data mul_in;
             mul_in.a_bits = a_fp9[i][k];
             mul_in.b_bits = b_fp9[k][j];
-            mul_in.s1 = fmul_s1(mul_in.a_bits, mul_in.b_bits, 5, 4, cfg.rm);
+            mul_in.s1 = fmul_s1(mul_in.a_bits, mul_in.b_bits, 5, 4, jobs[issue_job].cfg.rm);
+            mul_in.job = issue_job;
 
             p.mul_pipe[k].tick(mul_in_valid, mul_in, mul_out_ready,
                 // Stage 1: latch + s1 computation
                 [&](const MulStage1Data& in) -> MulStage1Data {
+                    latch(p.op_a_reg[k], in.a_bits, in.job);
+                    latch(p.op_b_reg[k], in.b_bits, in.job);
                     return in;
                 },
                 // Stage 2: multiplication + s3 normalization
@@ -434,13 +707,17 @@ private:
                     // Actually, compute full result here
                     uint32_t result = fmul_s3(s2, 5, 4);
                     out.s1.shift_amt = result; // reuse field to carry result
+                    account(in.job, &EnergyCounters::mul_fp9, 1);
                     return out;
                 });
 
             // Capture multiplier output
             if (p.mul_pipe[k].out_valid() && !p.mul_results_valid[k]) {
-                p.mul_results[k] = fp9_to_fp13((uint16_t)(p.mul_pipe[k].out_data().s1.shift_amt & 0x1FF));
+                const MulStage1Data& out = p.mul_pipe[k].out_data();
+                p.mul_results[k] = {fp9_to_fp13((uint16_t)(out.s1.shift_amt & 0x1FF)), 0, out.job};
                 p.mul_results_valid[k] = true;
+                latch(p.prod_reg[k], p.mul_results[k].value, out.job);
+                account(out.job, &EnergyCounters::conv_fp13, 1);
             }
         }
     }
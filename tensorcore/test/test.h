@@ -3,5 +3,9 @@
 namespace otc {
 
 int run_smoke_test();
+int run_layout_test();
+int run_tagged_test();
+int run_issue_model_test();
+int run_energy_model_test();
 
 } // namespace otc
@@ -38,29 +38,7 @@ static std::vector<uint32_t> pack_ab(const std::vector<double>& vals, int type_a
         if (type_ab == TYPE_FP8) {
             packed = (sub == SUB_FP8E4M3) ? FPConvert::f64_to_fp8e4m3(vals[i]) : FPConvert::f64_to_fp8e5m2(vals[i]);
         } else if (type_ab == TYPE_FP4) {
-            double v = vals[i];
-            int sgn = (v < 0.0) ? 1 : 0;
-            double av = fabs(v);
-            int e = 0;
-            int m = 0;
-            if (av >= 4.0) {
-                e = 2;
-                m = 1;
-            } else if (av > 0.0) {
-                int exp;
-                double frac = frexp(av, &exp);
-                if (exp <= 0) {
-                    e = 0;
-                    m = (av >= 0.5) ? 1 : 0;
-                } else if (exp >= 3) {
-                    e = 2;
-                    m = 1;
-                } else {
-                    e = exp;
-                    m = (2.0 * frac - 1.0 >= 0.5) ? 1 : 0;
-                }
-            }
-            packed = (uint32_t)((sgn << 3) | (e << 1) | m);
+            packed = FPConvert::f64_to_fp4(vals[i]);
         } else {
             packed = SoftFloat::f64_to_fp16(vals[i]);
         }
@@ -150,11 +128,7 @@ static std::vector<double> golden_model_quantized_from_packed(const std::vector<
         uint16_t h = (w >> (ei * 16)) & 0xFFFF;
         cq22[i] = SoftFloat::f64_to_fp22(SoftFloat::fp16_to_f64(h));
     }
-}
-
 
-static std::vector<double> golden_model_quantized(const std::vector<double>& aq, const std::vector<double>& bq,
-                                                  const std::vector<double>& cq, const OTC_Config& cfg) {
     std::vector<double> d(cfg.M * cfg.N, 0.0);
     for (int i = 0; i < cfg.M; i++) {
         for (int j = 0; j < cfg.N; j++) {
@@ -1,4 +1,94 @@
 #include "otc_driver.h"
+#include <map>
+
+namespace {
+
+constexpr int RECONFIG_TIMEOUT = 100000;  // ticks otc_configure waits for a reconfig
+
+uint32_t get_elem(const uint32_t* words, int idx, int eb) {
+    int eperw = 32 / eb;
+    return (words[idx / eperw] >> ((idx % eperw) * eb)) & ((1u << eb) - 1);
+}
+
+void put_elem(std::vector<uint32_t>& words, int idx, int eb, uint32_t v) {
+    int eperw = 32 / eb;
+    words[idx / eperw] |= v << ((idx % eperw) * eb);
+}
+
+// softmax probabilities are requantized to type_ab to feed the PV GEMM;
+// `value` is the probability as multiplied, so the row sum matches it
+uint32_t encode_ab(uint32_t fp22, const OTC_Config& cfg, double& value) {
+    if (cfg.type_ab == TYPE_FP4) {
+        uint32_t code = FPEmu::fp22_to_fp4(fp22);
+        value = FPConvert::fp4_to_f64(code);
+        return code;
+    }
+    if (cfg.type_ab == TYPE_FP8) {
+        uint32_t code = FPEmu::fp22_to_fp8(fp22, cfg.type_ab_sub) & 0xFF;
+        value = cfg.type_ab_sub == SUB_FP8E4M3 ? FPConvert::fp8e4m3_to_f64(code) : FPConvert::fp8e5m2_to_f64(code);
+        return code;
+    }
+    uint32_t code = FPEmu::fp22_to_fp16(fp22);
+    value = FPConvert::fp16_to_f64_via_fp9(code);  // what the DP multiplier sees
+    return code;
+}
+
+double round_cd(double x, const OTC_Config& cfg) {
+    if (cfg.type_cd == TYPE_FP16) return SoftFloat::fp16_to_f64(SoftFloat::f64_to_fp16(x));
+    return SoftFloat::fp32_to_f64(SoftFloat::f64_to_fp32(x));
+}
+
+// Issues tiles of up to `max_slices` K-deep slices, where a tile's later
+// slices take the previous slice's FP22 sums as C. A slice is ready once the
+// previous one has come back, so tiles go in windows, slice-major, wide
+// enough to keep the pipeline full while a sum is in flight.
+// issue(ti, ks, partial, acc) packs and enqueues slice ks of tile ti (acc is
+// empty for the first slice) and finish(ti, br) scatters a tile's final
+// result. Returns 0, -2 when a slice is refused or -4 past `limit`.
+template <typename Issue, typename Finish>
+int run_k_sliced(TensorCoreUnit& tc, const std::vector<int>& tile_slices, int max_slices, uint64_t limit,
+                 Issue issue, Finish finish) {
+    const OTC_Config& cfg = tc.cfg_;
+    size_t num_tiles = tile_slices.size();
+    int per_tile = (cfg.total_dp() + cfg.dispatch_width - 1) / cfg.dispatch_width;
+    size_t window = max_slices > 1 ? std::max(2, (cfg.pipeline_depth() + per_tile - 1) / per_tile + 1) : num_tiles;
+    std::vector<std::vector<uint32_t>> acc(num_tiles);
+    std::vector<int> slices_done(num_tiles, 0), batch_tile;
+    int base_id = tc.next_batch_id_;
+    auto step = [&]() {
+        tc.tick();
+        BatchResult br;
+        while (tc.pop_output_result(br)) {
+            int ti = batch_tile[br.batch_id - base_id];
+            slices_done[ti]++;
+            if (br.partial) acc[ti] = br.d_fp22;
+            else finish(ti, br);
+        }
+    };
+
+    for (size_t first = 0; first < num_tiles; first += window) {
+        size_t last = std::min(num_tiles, first + window);
+        for (int ks = 0; ks < max_slices; ++ks) {
+            for (size_t ti = first; ti < last; ++ti) {
+                if (ks >= tile_slices[ti]) continue;
+                while (!tc.can_accept_job() || slices_done[ti] < ks) {
+                    if (tc.cycle_ >= limit) return -4;
+                    step();
+                }
+                if (!issue((int)ti, ks, ks + 1 < tile_slices[ti], std::move(acc[ti]))) return -2;
+                batch_tile.push_back((int)ti);
+                tc.start();
+            }
+        }
+    }
+    while (tc.is_busy() || !tc.output_fifo_.empty()) {
+        if (tc.cycle_ >= limit) return -4;
+        step();
+    }
+    return 0;
+}
+
+}  // namespace
 
 int otc_dev_open(OTC_Device** dev) {
     *dev = new OTC_Device();
@@ -12,16 +102,31 @@ int otc_dev_close(OTC_Device* dev) {
 
 int otc_configure(OTC_Device* dev, const OTC_Config& cfg) {
     if (!cfg.validate()) {
+        dev->tc.config_error_ = true;
+        dev->tc.stats_.config_errors++;
         std::cerr << "ERROR: invalid config (M=" << cfg.M << " K=" << cfg.K << " N=" << cfg.N
                   << " type_ab=" << std::hex << (int)cfg.type_ab << std::dec << ")\n";
         return -1;
     }
-    dev->tc.init(cfg);
-    dev->tc.reset();
-    dev->configured = true;
+    if (!dev->configured) {
+        dev->tc.init(cfg);
+        dev->tc.reset();
+        dev->configured = true;
+        return 0;
+    }
+    // the host waits for busy to drop and the config registers to reload;
+    // on timeout the reconfig stays pending and completes on later ticks
+    dev->tc.reconfigure(cfg);
+    for (int i = 0; i < RECONFIG_TIMEOUT && dev->tc.is_reconfiguring(); ++i) dev->tc.tick();
+    if (dev->tc.is_reconfiguring()) {
+        std::cerr << "ERROR: reconfiguration still pending after " << RECONFIG_TIMEOUT << " cycles\n";
+        return -2;
+    }
     return 0;
 }
 
+int otc_config_error(OTC_Device* dev) { return dev->tc.config_error_ ? 1 : 0; }
+
 int otc_upload(OTC_Device* dev, const uint32_t* a, int na, const uint32_t* b, int nb, const uint32_t* c, int nc) {
     if (!dev->configured) return -1;
     dev->tc.load(std::vector<uint32_t>(a, a + na), std::vector<uint32_t>(b, b + nb), std::vector<uint32_t>(c, c + nc));
@@ -67,6 +172,14 @@ int otc_pop_result_f64(OTC_Device* dev, double* dst, int n) {
     return cnt;
 }
 
+int otc_pop_result_packed(OTC_Device* dev, uint32_t* dst, int n) {
+    BatchResult br;
+    if (!dev->tc.pop_output_result(br)) return 0;
+    int cnt = std::min(n, (int)br.d_packed.size());
+    memcpy(dst, br.d_packed.data(), cnt * sizeof(uint32_t));
+    return cnt;
+}
+
 int otc_download_fp32(OTC_Device* dev, uint32_t* dst, int n) {
     auto r = dev->tc.get_result_fp32();
     int cnt = std::min(n, (int)r.size());
@@ -75,3 +188,477 @@ int otc_download_fp32(OTC_Device* dev, uint32_t* dst, int n) {
 }
 
 const OTC_Stats& otc_stats(OTC_Device* dev) { return dev->tc.stats_; }
+
+int otc_queue_job(OTC_Device* dev, const OTC_Config& cfg, const uint32_t* a, int na, const uint32_t* b, int nb, const uint32_t* c, int nc) {
+    if (!cfg.validate()) {
+        dev->tc.config_error_ = true;
+        dev->tc.stats_.config_errors++;
+        return -1;
+    }
+    OTC_Job job;
+    job.cfg = cfg;
+    job.a.assign(a, a + na);
+    job.b.assign(b, b + nb);
+    job.c.assign(c, c + nc);
+    dev->queue.push_back(job);
+    return (int)dev->queue.size() - 1;
+}
+
+// Group pending jobs by datapath config so each config is loaded once: the
+// group matching the current config runs first, the rest follow in order of
+// first appearance, and jobs keep their submission order within a group.
+std::vector<int> otc_schedule_jobs(const std::vector<OTC_Job>& jobs, const OTC_Config* current) {
+    std::vector<int> order;
+    std::vector<bool> taken(jobs.size(), false);
+    auto take_group = [&](const OTC_Config& key) {
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            if (!taken[i] && !jobs[i].done && jobs[i].cfg.same_datapath(key)) {
+                taken[i] = true;
+                order.push_back((int)i);
+            }
+        }
+    };
+    if (current) take_group(*current);
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        if (!taken[i] && !jobs[i].done) take_group(jobs[i].cfg);
+    }
+    return order;
+}
+
+int otc_run_queue(OTC_Device* dev, bool reorder, OTC_QueueReport* report, int max_cycles) {
+    auto& tc = dev->tc;
+    std::vector<int> order;
+    if (reorder) {
+        order = otc_schedule_jobs(dev->queue, dev->configured ? &tc.cfg_ : nullptr);
+    } else {
+        for (size_t i = 0; i < dev->queue.size(); ++i) {
+            if (!dev->queue[i].done) order.push_back((int)i);
+        }
+    }
+    if (order.empty()) return 0;
+    if (!dev->configured) {
+        tc.init(dev->queue[order[0]].cfg);
+        tc.reset();
+        dev->configured = true;
+    }
+
+    OTC_QueueReport rep;
+    uint64_t start_cycle = tc.cycle_;
+    uint64_t start_drain = tc.stats_.reconfig_drain_cycles;
+    uint64_t start_reconfig = tc.stats_.reconfig_cycles;
+    uint64_t limit = start_cycle + max_cycles;
+    // Results of batches this call did not issue are left in the output FIFO
+    // for their owner.
+    std::map<int, int> batch_job;
+    auto step = [&]() {
+        tc.tick();
+        for (auto it = tc.output_fifo_.begin(); it != tc.output_fifo_.end();) {
+            auto bj = batch_job.find(it->batch_id);
+            if (bj == batch_job.end()) { ++it; continue; }
+            auto& job = dev->queue[bj->second];
+            job.d_f64 = it->d_f64;
+            job.done = true;
+            job.done_cycle = it->done_cycle;
+            batch_job.erase(bj);
+            it = tc.output_fifo_.erase(it);
+        }
+    };
+
+    for (int j : order) {
+        auto& job = dev->queue[j];
+        // a datapath change pays the reload, any other register change
+        // only waits for the earlier jobs to drain
+        if (!tc.cfg_.same_config(job.cfg)) {
+            bool datapath = !tc.cfg_.same_datapath(job.cfg);
+            if (!tc.reconfigure(job.cfg)) return -3;
+            if (datapath) rep.reconfigs++;
+        }
+        while (!tc.can_accept_job()) {
+            if (tc.cycle_ >= limit) return -1;
+            step();
+        }
+        if (!tc.enqueue_job(job.a, job.b, job.c)) return -2;
+        batch_job[tc.next_batch_id_ - 1] = j;
+        tc.start();
+        rep.jobs++;
+    }
+    while (!batch_job.empty()) {
+        if (tc.cycle_ >= limit) return -1;
+        step();
+    }
+
+    rep.cycles = tc.cycle_ - start_cycle;
+    rep.drain_cycles = tc.stats_.reconfig_drain_cycles - start_drain;
+    rep.reconfig_cycles = tc.stats_.reconfig_cycles - start_reconfig;
+    if (report) *report = rep;
+    return 0;
+}
+
+int otc_job_result_f64(OTC_Device* dev, int job, double* dst, int n) {
+    if (job < 0 || job >= (int)dev->queue.size() || !dev->queue[job].done) return 0;
+    const auto& r = dev->queue[job].d_f64;
+    int cnt = std::min(n, (int)r.size());
+    memcpy(dst, r.data(), cnt * sizeof(double));
+    return cnt;
+}
+
+// Tiles of all problems are issued back to back: a tile is accepted as soon
+// as the previous one is dispatched, so the DP pipelines never drain between
+// problems. A k longer than K runs as K-deep slices whose FP22 sums stay on
+// chip as the C operand of the next slice (run_k_sliced). The device must be
+// idle on entry.
+int otc_gemm_grouped(OTC_Device* dev, const OTC_GemmDesc* gemms, int count, OTC_GemmReport* report, int max_cycles) {
+    auto& tc = dev->tc;
+    if (!dev->configured) return -1;
+    if (tc.is_busy() || !tc.output_fifo_.empty()) return -2;
+    const OTC_Config& cfg = tc.cfg_;
+    for (int g = 0; g < count; ++g) {
+        const auto& p = gemms[g];
+        if (p.m <= 0 || p.n <= 0 || p.k <= 0 || !p.a || !p.b || !p.d) return -3;
+    }
+
+    struct Tile { int g, mt, nt; };
+    std::vector<Tile> tiles;
+    std::vector<int> tile_slices;
+    OTC_GemmReport rep;
+    rep.groups.resize(count);
+    int max_slices = 0;
+    for (int g = 0; g < count; ++g) {
+        const auto& p = gemms[g];
+        int mts = (p.m + cfg.M - 1) / cfg.M, nts = (p.n + cfg.N - 1) / cfg.N, slices = (p.k + cfg.K - 1) / cfg.K;
+        for (int mt = 0; mt < mts; ++mt)
+            for (int nt = 0; nt < nts; ++nt) {
+                tiles.push_back({g, mt, nt});
+                tile_slices.push_back(slices);
+            }
+        max_slices = std::max(max_slices, slices);
+        auto& gr = rep.groups[g];
+        gr.tiles = mts * nts;
+        gr.k_slices = slices;
+        gr.macs = (uint64_t)p.m * p.n * p.k;
+        gr.tile_util = (double)gr.macs / ((double)gr.tiles * slices * cfg.M * cfg.N * cfg.K);
+        rep.macs += gr.macs;
+    }
+    rep.tiles = (int)tiles.size();
+
+    int eb = FPConvert::elem_bits(cfg.type_ab);
+    uint64_t start_cycle = tc.cycle_, limit = start_cycle + max_cycles;
+    std::vector<bool> started(count, false);
+    auto issue = [&](int ti, int ks, bool partial, std::vector<uint32_t> acc) {
+        const Tile& t = tiles[ti];
+        const auto& p = gemms[t.g];
+        int k0 = ks * cfg.K, kd = std::min(cfg.K, p.k - k0);
+        std::vector<uint32_t> a((cfg.M * cfg.K * eb + 31) / 32, 0), b((cfg.K * cfg.N * eb + 31) / 32, 0);
+        std::vector<uint32_t> c((cfg.M * cfg.N + 1) / 2, 0);
+        for (int r = 0; r < cfg.M; ++r) {
+            int row = t.mt * cfg.M + r;
+            if (row >= p.m) break;
+            for (int kk = 0; kk < kd; ++kk) put_elem(a, r * cfg.K + kk, eb, get_elem(p.a, row * p.k + k0 + kk, eb));
+        }
+        for (int col = 0; col < cfg.N; ++col) {
+            int cc = t.nt * cfg.N + col;
+            if (cc >= p.n) break;
+            for (int kk = 0; kk < kd; ++kk) {
+                if (cfg.transpose_b) put_elem(b, col * cfg.K + kk, eb, get_elem(p.b, cc * p.k + k0 + kk, eb));
+                else put_elem(b, kk * cfg.N + col, eb, get_elem(p.b, (k0 + kk) * p.n + cc, eb));
+            }
+            for (int r = 0; ks == 0 && p.c && r < cfg.M && t.mt * cfg.M + r < p.m; ++r)
+                put_elem(c, r * cfg.N + col, 16, get_elem(p.c, (t.mt * cfg.M + r) * p.n + cc, 16));
+        }
+        bool ok = ks ? tc.enqueue_job_acc(a, b, std::move(acc), partial, false) : tc.try_start_batch(a, b, c, partial);
+        if (ok && !started[t.g]) { started[t.g] = true; rep.groups[t.g].start_cycle = tc.cycle_; }
+        return ok;
+    };
+    auto finish = [&](int ti, const BatchResult& br) {
+        const Tile& t = tiles[ti];
+        const auto& p = gemms[t.g];
+        for (int r = 0; r < cfg.M; ++r) {
+            for (int col = 0; col < cfg.N; ++col) {
+                int row = t.mt * cfg.M + r, cc = t.nt * cfg.N + col;
+                if (row < p.m && cc < p.n) p.d[row * p.n + cc] = br.d_f64[r * cfg.N + col];
+            }
+        }
+        auto& gr = rep.groups[t.g];
+        gr.done_cycle = std::max(gr.done_cycle, br.done_cycle);
+    };
+    int ret = run_k_sliced(tc, tile_slices, max_slices, limit, issue, finish);
+    if (ret) return ret;
+
+    rep.cycles = tc.cycle_ - start_cycle;
+    rep.macs_per_cycle = rep.cycles ? (double)rep.macs / rep.cycles : 0.0;
+    for (auto& gr : rep.groups) {
+        uint64_t span = gr.done_cycle - gr.start_cycle;
+        gr.macs_per_cycle = span ? (double)gr.macs / span : 0.0;
+    }
+    if (report) *report = rep;
+    return 0;
+}
+
+// `count` problems of one shape; strides are in packed words for A/B/C and in
+// elements for D.
+int otc_gemm_batched(OTC_Device* dev, int m, int k, int n, int count,
+                     const uint32_t* a, int stride_a, const uint32_t* b, int stride_b,
+                     const uint32_t* c, int stride_c, double* d, int stride_d, OTC_GemmReport* report) {
+    std::vector<OTC_GemmDesc> gemms(count);
+    for (int i = 0; i < count; ++i) {
+        gemms[i].m = m; gemms[i].k = k; gemms[i].n = n;
+        gemms[i].a = a + (size_t)i * stride_a;
+        gemms[i].b = b + (size_t)i * stride_b;
+        gemms[i].c = c ? c + (size_t)i * stride_c : nullptr;
+        gemms[i].d = d + (size_t)i * stride_d;
+    }
+    return otc_gemm_grouped(dev, gemms.data(), count, report);
+}
+
+// conv2d as an implicit GEMM. Input and filter are packed in type_ab; the
+// output is written in the input layout. A reduction longer than K runs as
+// K-deep slices whose FP22 sums stay on chip as the C operand of the next
+// slice (run_k_sliced). The device must be idle on entry.
+int otc_conv2d(OTC_Device* dev, const OTC_ConvShape& cs, const uint32_t* input, const uint32_t* filter, double* output,
+               OTC_ConvReport* report, int max_cycles) {
+    auto& tc = dev->tc;
+    if (!dev->configured) return -1;
+    if (tc.is_busy() || !tc.output_fifo_.empty()) return -2;
+    if (!cs.validate() || !input || !filter || !output) return -3;
+    const OTC_Config& cfg = tc.cfg_;
+
+    struct Tile { int g, mt, nt; };
+    std::vector<Tile> tiles;
+    int gm = cs.gemm_m(), gk = cs.gemm_k(), kg = cs.k / cs.groups;
+    int mts = (gm + cfg.M - 1) / cfg.M, nts = (kg + cfg.N - 1) / cfg.N, slices = (gk + cfg.K - 1) / cfg.K;
+    for (int g = 0; g < cs.groups; ++g)
+        for (int mt = 0; mt < mts; ++mt)
+            for (int nt = 0; nt < nts; ++nt) tiles.push_back({g, mt, nt});
+
+    OTC_ConvReport rep;
+    rep.tiles = (int)tiles.size();
+    rep.k_slices = slices;
+    rep.macs = (uint64_t)gm * cs.k * gk;
+    int eb = FPConvert::elem_bits(cfg.type_ab);
+    rep.im2col_bytes = ((uint64_t)cs.groups * nts * gm * gk * eb + 7) / 8;
+
+    int oh = cs.out_h(), ow = cs.out_w();
+    uint64_t start_cycle = tc.cycle_, limit = start_cycle + max_cycles, in0 = tc.stats_.conv_input_bytes,
+             f0 = tc.stats_.conv_filter_bytes, w0 = tc.stats_.dram_write_bytes;
+    auto issue = [&](int ti, int ks, bool partial, std::vector<uint32_t> acc) {
+        const Tile& t = tiles[ti];
+        return tc.enqueue_conv_tile(cs, input, filter, t.g, t.mt * cfg.M, ks * cfg.K, t.nt * cfg.N, std::move(acc), partial);
+    };
+    auto finish = [&](int ti, const BatchResult& br) {
+        const Tile& t = tiles[ti];
+        for (int r = 0; r < cfg.M; ++r) {
+            int m = t.mt * cfg.M + r;
+            if (m >= gm) break;
+            int img = m / (oh * ow), y = m / ow % oh, x = m % ow;
+            for (int col = 0; col < cfg.N && t.nt * cfg.N + col < kg; ++col)
+                output[cs.output_index(img, t.g * kg + t.nt * cfg.N + col, y, x)] = br.d_f64[r * cfg.N + col];
+        }
+    };
+    int ret = run_k_sliced(tc, std::vector<int>(tiles.size(), slices), slices, limit, issue, finish);
+    if (ret) return ret;
+
+    rep.cycles = tc.cycle_ - start_cycle;
+    rep.macs_per_cycle = rep.cycles ? (double)rep.macs / rep.cycles : 0.0;
+    rep.input_bytes = tc.stats_.conv_input_bytes - in0;
+    rep.filter_bytes = tc.stats_.conv_filter_bytes - f0;
+    rep.output_bytes = tc.stats_.dram_write_bytes - w0;
+    if (report) *report = rep;
+    return 0;
+}
+
+// Flash-attention style: each M-row query tile walks key blocks of N keys.
+// S = Q K^T accumulates in FP22 over K-deep slices of head_dim and stays on
+// chip; the SFU turns it into P with the running row max and sum; P V adds
+// into an FP22 output accumulator that the SFU rescales by exp(m_old - m_new)
+// and that is fed back as C. Only Q, K, V and the final O cross the memory
+// interface. Several query tiles are in flight so one tile's QK^T overlaps
+// another's softmax and PV. The device must be idle on entry.
+int otc_attention(OTC_Device* dev, const OTC_AttnShape& as, const uint32_t* q, const uint32_t* k, const uint32_t* v,
+                  double* o, OTC_AttnReport* report, int max_cycles) {
+    auto& tc = dev->tc;
+    if (!dev->configured) return -1;
+    if (tc.is_busy() || !tc.output_fifo_.empty()) return -2;
+    if (as.heads <= 0 || as.seq_q <= 0 || as.seq_kv <= 0 || as.head_dim <= 0 || !q || !k || !v || !o) return -3;
+    const OTC_Config& cfg = tc.cfg_;
+    int eb = FPConvert::elem_bits(cfg.type_ab), d = as.head_dim, bc = cfg.N;
+    int qk_slices = (d + cfg.K - 1) / cfg.K, pv_slices = (bc + cfg.K - 1) / cfg.K, d_tiles = (d + cfg.N - 1) / cfg.N;
+    int q_tiles = (as.seq_q + cfg.M - 1) / cfg.M, kv_blocks = (as.seq_kv + bc - 1) / bc;
+    uint32_t scale22 = SoftFloat::f64_to_fp22(as.scale != 0.0 ? as.scale : 1.0 / std::sqrt((double)d));
+    int a_words = (cfg.M * cfg.K * eb + 31) / 32, b_words = (cfg.K * cfg.N * eb + 31) / 32;
+
+    enum Phase { QK, S_WAIT, P_WAIT, PV, FINAL, DONE };
+    struct Stream {
+        int head, qt, blocks;
+        int kb = 0, pos = 0, qk_back = 0;
+        Phase phase = QK;
+        uint64_t p_ready = 0;
+        std::vector<uint32_t> s;                 // S tile, FP22
+        std::vector<std::vector<uint32_t>> acc;  // O accumulator per head_dim tile, FP22
+        std::vector<int> pv_back;
+        std::vector<double> m;                   // running row max, FP22 values
+        std::vector<uint32_t> l;                 // running row sum, FP22
+        std::vector<std::vector<uint32_t>> p;    // P per key slice, packed as A
+    };
+    std::vector<Stream> streams;
+    for (int h = 0; h < as.heads; ++h)
+        for (int qt = 0; qt < q_tiles; ++qt) {
+            Stream st;
+            st.head = h; st.qt = qt;
+            st.blocks = as.causal ? std::min(kv_blocks, (std::min(as.seq_q, (qt + 1) * cfg.M) - 1) / bc + 1) : kv_blocks;
+            st.acc.assign(d_tiles, std::vector<uint32_t>(cfg.M * cfg.N, 0));
+            st.pv_back.assign(d_tiles, pv_slices);
+            st.m.assign(cfg.M, -INFINITY);
+            st.l.assign(cfg.M, 0);
+            streams.push_back(st);
+        }
+
+    OTC_AttnReport rep;
+    rep.q_tiles = (int)streams.size();
+    struct Tag { int stream, nt; bool pv; };
+    std::vector<Tag> tags;
+    int base_id = tc.next_batch_id_;
+    uint64_t start_cycle = tc.cycle_, limit = start_cycle + max_cycles, sfu_done = 0;
+    uint64_t r0 = tc.stats_.dram_read_bytes, w0 = tc.stats_.dram_write_bytes, ops0 = tc.stats_.sfu_ops,
+             busy0 = tc.stats_.sfu_busy_cycles;
+    auto step = [&]() {
+        tc.tick();
+        BatchResult br;
+        while (tc.pop_output_result(br)) {
+            const Tag& t = tags[br.batch_id - base_id];
+            Stream& st = streams[t.stream];
+            if (t.pv) { st.acc[t.nt] = br.d_fp22; st.pv_back[t.nt]++; }
+            else { st.s = br.d_fp22; st.qk_back++; }
+        }
+    };
+    auto pv_idle = [&](const Stream& st) {
+        for (int n : st.pv_back) if (n < pv_slices) return false;
+        return true;
+    };
+
+    // online softmax for one key block, on the SFU
+    auto softmax = [&](Stream& st) {
+        st.p.assign(pv_slices, std::vector<uint32_t>(a_words, 0));
+        for (int r = 0; r < cfg.M; ++r) {
+            int qi = st.qt * cfg.M + r;
+            std::vector<double> x(bc, -INFINITY);
+            double mx = st.m[r];
+            for (int c = 0; c < bc && qi < as.seq_q; ++c) {
+                int kj = st.kb * bc + c;
+                if (kj >= as.seq_kv || (as.causal && kj > qi)) continue;
+                x[c] = SoftFloat::fp22_to_f64(FPEmu::fp22_mul(st.s[r * cfg.N + c], scale22));
+                mx = std::max(mx, x[c]);
+            }
+            if (mx == -INFINITY) continue;
+            uint32_t alpha = SoftFloat::f64_to_fp22(std::exp(st.m[r] - mx));
+            st.m[r] = mx;
+            st.l[r] = FPEmu::fp22_mul(st.l[r], alpha);
+            for (auto& a : st.acc)
+                for (int col = 0; col < cfg.N; ++col) a[r * cfg.N + col] = FPEmu::fp22_mul(a[r * cfg.N + col], alpha);
+            for (int c = 0; c < bc; ++c) {
+                if (x[c] == -INFINITY) continue;
+                double pv;
+                uint32_t code = encode_ab(SoftFloat::f64_to_fp22(std::exp(x[c] - mx)), cfg, pv);
+                put_elem(st.p[c / cfg.K], r * cfg.K + c % cfg.K, eb, code);
+                st.l[r] = FPEmu::fp22_add(st.l[r], SoftFloat::f64_to_fp22(pv));
+            }
+        }
+        // scale, max, exp and sum per score, one exp per row, rescale the accumulator
+        st.p_ready = tc.sfu_issue(3 * cfg.M * bc + cfg.M + cfg.M * d_tiles * cfg.N);
+    };
+
+    auto issue = [&](int si) {
+        Stream& st = streams[si];
+        std::vector<uint32_t> a(a_words, 0), b(b_words, 0);
+        if (st.phase == QK) {
+            if (st.qk_back < st.pos) return false;
+            int sl = st.pos;
+            for (int r = 0; r < cfg.M && st.qt * cfg.M + r < as.seq_q; ++r)
+                for (int kk = 0; kk < cfg.K && sl * cfg.K + kk < d; ++kk)
+                    put_elem(a, r * cfg.K + kk, eb, get_elem(q, (st.head * as.seq_q + st.qt * cfg.M + r) * d + sl * cfg.K + kk, eb));
+            for (int col = 0; col < bc && st.kb * bc + col < as.seq_kv; ++col)
+                for (int kk = 0; kk < cfg.K && sl * cfg.K + kk < d; ++kk)
+                    put_elem(b, cfg.transpose_b ? col * cfg.K + kk : kk * cfg.N + col, eb,
+                             get_elem(k, (st.head * as.seq_kv + st.kb * bc + col) * d + sl * cfg.K + kk, eb));
+            // the Q tile stays resident after the first key block
+            tc.enqueue_job_acc(a, b, sl ? st.s : std::vector<uint32_t>(), true, st.kb > 0);
+            tags.push_back({si, 0, false});
+            if (++st.pos == qk_slices) st.phase = S_WAIT;
+        } else {
+            int ks = st.pos / d_tiles, nt = st.pos % d_tiles;
+            if (st.pv_back[nt] < ks) return false;
+            for (int kk = 0; kk < cfg.K; ++kk) {
+                int kj = st.kb * bc + ks * cfg.K + kk;
+                if (ks * cfg.K + kk >= bc || kj >= as.seq_kv) break;
+                for (int col = 0; col < cfg.N && nt * cfg.N + col < d; ++col)
+                    put_elem(b, cfg.transpose_b ? col * cfg.K + kk : kk * cfg.N + col, eb,
+                             get_elem(v, (st.head * as.seq_kv + kj) * d + nt * cfg.N + col, eb));
+            }
+            tc.enqueue_job_acc(st.p[ks], b, st.acc[nt], true, true);
+            tags.push_back({si, nt, true});
+            if (++st.pos == pv_slices * d_tiles) {
+                if (++st.kb < st.blocks) { st.phase = QK; st.pos = 0; st.qk_back = 0; }
+                else st.phase = FINAL;
+            }
+        }
+        tc.start();
+        rep.batches++;
+        return true;
+    };
+
+    auto finish = [&](Stream& st) {
+        for (int r = 0; r < cfg.M; ++r) {
+            int qi = st.qt * cfg.M + r;
+            if (qi >= as.seq_q) break;
+            double l = SoftFloat::fp22_to_f64(st.l[r]);
+            for (int dim = 0; dim < d; ++dim)
+                o[(st.head * as.seq_q + qi) * d + dim] =
+                    round_cd(SoftFloat::fp22_to_f64(st.acc[dim / cfg.N][r * cfg.N + dim % cfg.N]) / l, cfg);
+        }
+        int rows = std::min(cfg.M, as.seq_q - st.qt * cfg.M);
+        sfu_done = std::max(sfu_done, tc.sfu_issue(rows * d));
+        tc.stats_.dram_write_bytes += (uint64_t)rows * d * (cfg.type_cd == TYPE_FP16 ? 2 : 4);
+    };
+
+    int per_tile = (cfg.total_dp() + cfg.dispatch_width - 1) / cfg.dispatch_width;
+    size_t window = std::max(2, (cfg.pipeline_depth() + cfg.sfu_latency + per_tile - 1) / per_tile + 1);
+    std::vector<int> active;
+    size_t next = 0;
+    for (;;) {
+        while (active.size() < window && next < streams.size()) active.push_back((int)next++);
+        for (int si : active) {
+            Stream& st = streams[si];
+            if (st.phase == S_WAIT && st.qk_back == qk_slices && pv_idle(st)) { softmax(st); st.phase = P_WAIT; }
+            if (st.phase == P_WAIT && tc.cycle_ >= st.p_ready) {
+                std::fill(st.pv_back.begin(), st.pv_back.end(), 0);
+                st.phase = PV; st.pos = 0;
+            }
+            if (st.phase == FINAL && pv_idle(st)) { finish(st); st.phase = DONE; }
+        }
+        active.erase(std::remove_if(active.begin(), active.end(), [&](int si) { return streams[si].phase == DONE; }),
+                     active.end());
+        if (active.empty() && next == streams.size()) break;
+        if (tc.can_accept_job())
+            for (int si : active)
+                if ((streams[si].phase == QK || streams[si].phase == PV) && issue(si)) break;
+        if (tc.cycle_ >= limit) return -4;
+        step();
+    }
+    while (tc.is_busy() || !tc.output_fifo_.empty() || tc.cycle_ < sfu_done) {
+        if (tc.cycle_ >= limit) return -4;
+        step();
+    }
+
+    for (const auto& st : streams) rep.kv_blocks += st.blocks;
+    rep.macs = (uint64_t)rep.batches * cfg.M * cfg.N * cfg.K;
+    rep.cycles = tc.cycle_ - start_cycle;
+    rep.macs_per_cycle = rep.cycles ? (double)rep.macs / rep.cycles : 0.0;
+    rep.sfu_ops = tc.stats_.sfu_ops - ops0;
+    rep.sfu_busy_cycles = tc.stats_.sfu_busy_cycles - busy0;
+    rep.offchip_bytes = (tc.stats_.dram_read_bytes - r0) + (tc.stats_.dram_write_bytes - w0);
+    // per block: S written and read back in FP32, P written once and read per head_dim tile
+    uint64_t s_bytes = (uint64_t)cfg.M * bc * 4, p_bytes = ((uint64_t)cfg.M * bc * eb + 7) / 8;
+    rep.onchip_bytes = (uint64_t)rep.kv_blocks * (2 * s_bytes + (1 + d_tiles) * p_bytes);
+    rep.unfused_offchip_bytes = rep.offchip_bytes + rep.onchip_bytes;
+    if (report) *report = rep;
+    return 0;
+}
@@ -1,14 +1,101 @@
 #pragma once
 #include "pipeline.h"
 
+// A GEMM queued with its own config. Queued jobs are independent, so the
+// driver may run them in any order.
+struct OTC_Job {
+    OTC_Config cfg;
+    std::vector<uint32_t> a, b, c;
+    std::vector<double> d_f64;
+    bool done = false;
+    uint64_t done_cycle = 0;
+};
+
+struct OTC_QueueReport {
+    int jobs = 0;
+    int reconfigs = 0;
+    uint64_t cycles = 0;
+    uint64_t drain_cycles = 0;     // cycles a config switch waited for busy to drop
+    uint64_t reconfig_cycles = 0;  // cycles the config registers were reloading
+};
+
+// One GEMM of a grouped submission. A is m x k and B is k x n (n x k with
+// transpose_b), packed in type_ab like otc_upload; C is m x n FP16, or null
+// for zero. Problems are cut into M x N tiles of the configured shape; k runs
+// as K-deep slices, the last one zero-padded.
+struct OTC_GemmDesc {
+    int m = 0, k = 0, n = 0;
+    const uint32_t* a = nullptr;
+    const uint32_t* b = nullptr;
+    const uint32_t* c = nullptr;
+    double* d = nullptr;  // m x n result, row-major
+};
+
+struct OTC_GroupReport {
+    int tiles = 0;
+    int k_slices = 0;           // K-deep passes per output tile
+    uint64_t macs = 0;          // useful m * n * k
+    uint64_t start_cycle = 0;   // first tile accepted
+    uint64_t done_cycle = 0;    // last tile retired
+    double macs_per_cycle = 0;
+    double tile_util = 0;       // useful MACs over MACs of the padded tiles
+};
+
+struct OTC_GemmReport {
+    std::vector<OTC_GroupReport> groups;
+    int tiles = 0;
+    uint64_t macs = 0;
+    uint64_t cycles = 0;
+    double macs_per_cycle = 0;
+};
+
+struct OTC_ConvReport {
+    int tiles = 0;               // M x N output tiles over all groups
+    int k_slices = 0;            // K-deep passes per output tile
+    uint64_t macs = 0;           // useful n * out_h * out_w * k * (c / groups) * r * s
+    uint64_t cycles = 0;
+    double macs_per_cycle = 0;
+    uint64_t input_bytes = 0;    // input fetched by the implicit-GEMM feed
+    uint64_t filter_bytes = 0;
+    uint64_t output_bytes = 0;
+    uint64_t im2col_bytes = 0;   // A traffic had the same tiles read an explicit im2col matrix
+};
+
+// Attention over `heads` independent heads: O = softmax(scale * Q K^T) V.
+// Q is heads x seq_q x head_dim and K, V are heads x seq_kv x head_dim, all
+// row-major and packed in type_ab; O is heads x seq_q x head_dim.
+struct OTC_AttnShape {
+    int heads = 1, seq_q = 1, seq_kv = 1, head_dim = 1;
+    double scale = 0.0;   // 0 selects 1 / sqrt(head_dim)
+    bool causal = false;  // query i attends to keys 0..i
+};
+
+struct OTC_AttnReport {
+    int q_tiles = 0;
+    int kv_blocks = 0;              // (q tile, key block) pairs computed, causal skips the rest
+    int batches = 0;
+    uint64_t macs = 0;              // MACs issued to the DP array
+    uint64_t cycles = 0;
+    double macs_per_cycle = 0;
+    uint64_t sfu_ops = 0;
+    uint64_t sfu_busy_cycles = 0;
+    uint64_t offchip_bytes = 0;     // Q, K, V reads and the O write
+    uint64_t onchip_bytes = 0;      // S and P tiles that never leave the chip
+    uint64_t unfused_offchip_bytes = 0;  // same work as separate QK^T, softmax and PV passes
+};
+
 struct OTC_Device {
     TensorCoreUnit tc;
     bool configured = false;
+    std::vector<OTC_Job> queue;
 };
 
 int otc_dev_open(OTC_Device** dev);
 int otc_dev_close(OTC_Device* dev);
+// 0 on success; -1 rejects an invalid config and keeps the old one; -2 if a
+// reconfiguration has not completed within the driver's wait (still pending)
 int otc_configure(OTC_Device* dev, const OTC_Config& cfg);
+int otc_config_error(OTC_Device* dev);
 int otc_upload(OTC_Device* dev, const uint32_t* a, int na, const uint32_t* b, int nb, const uint32_t* c, int nc);
 int otc_start(OTC_Device* dev);
 int otc_ready(OTC_Device* dev);
@@ -18,4 +105,21 @@ int otc_download_f64(OTC_Device* dev, double* dst, int n);
 int otc_download_fp32(OTC_Device* dev, uint32_t* dst, int n);
 int otc_submit(OTC_Device* dev, const uint32_t* a, int na, const uint32_t* b, int nb, const uint32_t* c, int nc);
 int otc_pop_result_f64(OTC_Device* dev, double* dst, int n);
+int otc_pop_result_packed(OTC_Device* dev, uint32_t* dst, int n);
 const OTC_Stats& otc_stats(OTC_Device* dev);
+
+int otc_queue_job(OTC_Device* dev, const OTC_Config& cfg, const uint32_t* a, int na, const uint32_t* b, int nb, const uint32_t* c, int nc);
+std::vector<int> otc_schedule_jobs(const std::vector<OTC_Job>& jobs, const OTC_Config* current);
+int otc_run_queue(OTC_Device* dev, bool reorder, OTC_QueueReport* report = nullptr, int max_cycles = 1000000);
+int otc_job_result_f64(OTC_Device* dev, int job, double* dst, int n);
+
+int otc_gemm_grouped(OTC_Device* dev, const OTC_GemmDesc* gemms, int count, OTC_GemmReport* report = nullptr,
+                     int max_cycles = 10000000);
+int otc_gemm_batched(OTC_Device* dev, int m, int k, int n, int count,
+                     const uint32_t* a, int stride_a, const uint32_t* b, int stride_b,
+                     const uint32_t* c, int stride_c, double* d, int stride_d, OTC_GemmReport* report = nullptr);
+
+int otc_conv2d(OTC_Device* dev, const OTC_ConvShape& cs, const uint32_t* input, const uint32_t* filter, double* output,
+               OTC_ConvReport* report = nullptr, int max_cycles = 10000000);
+int otc_attention(OTC_Device* dev, const OTC_AttnShape& as, const uint32_t* q, const uint32_t* k, const uint32_t* v,
+                  double* o, OTC_AttnReport* report = nullptr, int max_cycles = 10000000);
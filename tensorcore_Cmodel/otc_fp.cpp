@@ -67,7 +67,7 @@ uint32_t add_core(uint32_t a_bits, uint32_t b_bits, int exp_bits, int mant_bits)
         else { rs = bs - as; sign = b.sign; }
     }
     if (rs == 0) return 0;
-    while (rs >= ((uint64_t)1 << (mant_bits + 5))) { rs >>= 1; exp++; }
+    while (rs >= ((uint64_t)1 << (mant_bits + 4))) { rs = (rs >> 1) | (rs & 1u); exp++; }
     while (rs < ((uint64_t)1 << (mant_bits + 3)) && exp > 1) { rs <<= 1; exp--; }
 
     uint32_t mant = (rs >> 3) & ((1u << mant_bits) - 1);
@@ -167,11 +167,10 @@ uint32_t f64_to_fp22(double v) { return f64_to_fp_generic(v, 21, 8, 13, 127) & 0
 
 namespace FPEmu {
 uint16_t fp4_to_fp9(uint8_t fp4) {
+    // e2m1, bias 1, no Inf/NaN: 0, 0.5, 1, 1.5, 2, 3, 4, 6
     uint8_t s = (fp4 >> 3) & 1, e = (fp4 >> 1) & 0x3, m = fp4 & 1;
-    if (e == 0x3) return (s << 8) | (0x1F << 3) | (m ? 1 : 0);
-    if (e == 0x0) return (s << 8) | (m << 2);
-    if (e == 0x1) return (s << 8) | (0x0F << 3) | (m << 2);
-    return (s << 8) | (0x1F << 3);
+    if (e == 0x0) return m ? (s << 8) | (0x0E << 3) : (s << 8);
+    return (s << 8) | ((e + 14) << 3) | (m << 2);
 }
 uint16_t fp8e4m3_to_fp9(uint8_t fp8) { return (uint16_t)(((fp8 >> 7) << 8) | (((fp8 >> 3) & 0xF) << 3) | (fp8 & 0x7)); }
 uint16_t fp8e5m2_to_fp9(uint8_t fp8) { return (uint16_t)(((fp8 >> 7) << 8) | (((fp8 >> 2) & 0x1F) << 3) | ((fp8 & 0x3) << 1)); }
@@ -186,6 +185,7 @@ uint16_t fp16_to_fp9(uint16_t fp16) {
 uint16_t fp9_mul(uint16_t a, uint16_t b) { return (uint16_t)(mul_core(a & 0x1FF, b & 0x1FF, 5, 3) & 0x1FF); }
 uint16_t fp13_add(uint16_t a, uint16_t b) { return (uint16_t)(add_core(a & 0x1FFF, b & 0x1FFF, 5, 7) & 0x1FFF); }
 uint32_t fp22_add(uint32_t a, uint32_t b) { return add_core(a & 0x3FFFFF, b & 0x3FFFFF, 8, 13) & 0x3FFFFF; }
+uint32_t fp22_mul(uint32_t a, uint32_t b) { return mul_core(a & 0x3FFFFF, b & 0x3FFFFF, 8, 13) & 0x3FFFFF; }
 uint32_t fp9_to_fp22(uint16_t a) {
     uint16_t s = (a >> 8) & 1, e = (a >> 3) & 0x1F, m = a & 0x7;
     if (e == 0x1F) return ((uint32_t)s << 21) | (0xFFu << 13) | (m ? 1u : 0u);
@@ -215,6 +215,22 @@ uint16_t fp22_to_fp8(uint32_t a, int sub) {
     if (ee>=0xF) return (s<<7)|(0xE<<3)|0x7;
     return (s<<7)|((ee&0xF)<<3)|(m3&0x7);
 }
+uint8_t fp22_to_fp4(uint32_t a) {
+    // e2m1, bias 1: 0, 0.5, 1, 1.5, 2, 3, 4, 6; Inf/NaN and finite overflow saturate to 6
+    uint32_t s=(a>>21)&1,e=(a>>13)&0xFF,m=a&0x1FFF;
+    if (e==0xFF) return (s<<3)|0x7;
+    int ee=(int)e-127+1;
+    if (ee<=0) {
+        int shift=12-((int)e-127); if (e==0 || shift>15) return (s<<3);
+        uint32_t sig=(1u<<13)|m, q=sig>>shift, rem=sig&((1u<<shift)-1), half=1u<<(shift-1);
+        if (rem>half || (rem==half && (q&1))) q++;
+        return q>=2 ? (s<<3)|(0x1<<1) : (s<<3)|q;
+    }
+    if (ee>=4) return (s<<3)|0x7;
+    uint32_t m1=(m>>12)+((m&0x800)&&((m&0x7FF)||((m>>12)&1))); if (m1>=2){m1=0;ee++;}
+    if (ee>=4) return (s<<3)|0x7;
+    return (s<<3)|(ee<<1)|(m1&1);
+}
 uint16_t fp22_to_fp16(uint32_t a) {
     uint32_t s=(a>>21)&1,e=(a>>13)&0xFF,m=a&0x1FFF;
     if (e==0xFF) return (s<<15)|(0x1F<<10)|(m?1:0);
@@ -229,6 +245,7 @@ namespace FPConvert {
 double fp4_to_f64(uint8_t fp4) { return SoftFloat::fp9_to_f64(FPEmu::fp4_to_fp9(fp4)); }
 double fp8e5m2_to_f64(uint8_t fp8) { return SoftFloat::fp9_to_f64(FPEmu::fp8e5m2_to_fp9(fp8)); }
 double fp8e4m3_to_f64(uint8_t fp8) { return SoftFloat::fp9_to_f64(FPEmu::fp8e4m3_to_fp9(fp8)); }
+uint8_t f64_to_fp4(double v) { return FPEmu::fp22_to_fp4(SoftFloat::f64_to_fp22(v)); }
 uint8_t f64_to_fp8e5m2(double v) { return (uint8_t)FPEmu::fp22_to_fp8(SoftFloat::f64_to_fp22(v), SUB_FP8E5M2); }
 uint8_t f64_to_fp8e4m3(double v) { return (uint8_t)FPEmu::fp22_to_fp8(SoftFloat::f64_to_fp22(v), SUB_FP8E4M3); }
 double fp16_to_f64_via_fp9(uint16_t fp16) { return SoftFloat::fp9_to_f64(FPEmu::fp16_to_fp9(fp16)); }
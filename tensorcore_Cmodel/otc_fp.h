@@ -30,7 +30,9 @@ uint16_t fp16_to_fp9(uint16_t fp16);
 uint16_t fp9_mul(uint16_t a, uint16_t b);
 uint16_t fp13_add(uint16_t a, uint16_t b);
 uint32_t fp22_add(uint32_t a, uint32_t b);
+uint32_t fp22_mul(uint32_t a, uint32_t b);
 uint16_t fp22_to_fp8(uint32_t a, int sub);
+uint8_t fp22_to_fp4(uint32_t a);
 uint16_t fp22_to_fp16(uint32_t a);
 uint32_t fp9_to_fp22(uint16_t a);
 uint16_t fp13_to_fp9(uint16_t a);
@@ -40,6 +42,7 @@ uint16_t fp13_to_fp9(uint16_t a);
 namespace FPConvert {
 
 double fp4_to_f64(uint8_t fp4);
+uint8_t f64_to_fp4(double v);
 double fp8e5m2_to_f64(uint8_t fp8);
 double fp8e4m3_to_f64(uint8_t fp8);
 uint8_t f64_to_fp8e5m2(double v);
@@ -20,6 +20,27 @@ struct TestResult {
 static int g_total = 0, g_passed = 0, g_failed = 0;
 static std::vector<TestResult> g_results;
 
+// Record one named pass/fail check in the global summary and the suite's counters
+static void suite_check(const char* name, bool cond, int& pass, int& fail) {
+    g_total++;
+    if (cond) { g_passed++; pass++; }
+    else { g_failed++; fail++; }
+    printf("  %-50s %s\n", name, cond ? "PASS" : "FAIL");
+    TestResult tr; tr.name = name; tr.pass = cond;
+    tr.max_err = tr.avg_err = 0; tr.mismatches = cond ? 0 : 1;
+    g_results.push_back(tr);
+}
+
+// Open a device configured with cfg, hand it to body and close it afterwards;
+// returns whatever body returns
+template <typename Body>
+static auto with_device(const OTC_Config& cfg, Body&& body) {
+    struct Closer { OTC_Device* dev = nullptr; ~Closer() { otc_dev_close(dev); } } dc;
+    otc_dev_open(&dc.dev);
+    otc_configure(dc.dev, cfg);
+    return body(dc.dev);
+}
+
 // Pack helpers (same as main.cpp — duplicated here to keep test self-contained)
 std::vector<uint32_t> test_pack_ab(const std::vector<double>& vals, int type_ab, int sub) {
     int eb = FPConvert::elem_bits(type_ab);
@@ -63,23 +84,9 @@ std::vector<uint32_t> test_pack_ab(const std::vector<double>& vals, int type_ab,
                 }
                 break;
             }
-            case TYPE_FP4: {
-                double v = vals[i];
-                int s = (v < 0) ? 1 : 0;
-                double av = fabs(v);
-                int e, m;
-                if (av == 0.0) { e = 0; m = 0; }
-                else if (av >= 4.0) { e = 2; m = 1; }
-                else {
-                    int ex; double fr = frexp(av, &ex);
-                    int be = ex;
-                    if (be <= 0) { e = 0; m = (av >= 0.5) ? 1 : 0; }
-                    else if (be >= 3) { e = 2; m = 1; }
-                    else { e = be; m = (2.0 * fr - 1.0 >= 0.5) ? 1 : 0; }
-                }
-                packed = (s << 3) | (e << 1) | m;
+            case TYPE_FP4:
+                packed = FPConvert::f64_to_fp4(vals[i]);
                 break;
-            }
             case TYPE_FP16:
                 packed = SoftFloat::f64_to_fp16(vals[i]);
                 break;
@@ -101,6 +108,16 @@ std::vector<uint32_t> test_pack_c_fp16(const std::vector<double>& vals) {
 
 double quantize_output_ref(double v, int type_cd, int type_cd_sub);
 
+// Round to fp9 (e5m3) with ties to even, as fp13_to_fp9 does at the DP output
+static double round_fp9_rne(double v) {
+    if (v == 0.0 || !std::isfinite(v)) return v;
+    int e;
+    frexp(v, &e);
+    e = std::max(e, -13);  // fp9 subnormals share the 2^-14 exponent
+    double q = ldexp(std::nearbyint(ldexp(v, 4 - e)), e - 4);
+    return fabs(q) >= 65536.0 ? copysign(INFINITY, v) : q;
+}
+
 // Quantized golden: same precision path as simulator
 std::vector<double> quantized_golden(const std::vector<double>& a, const std::vector<double>& b,
                                       const std::vector<double>& c, int M, int K, int N,
@@ -130,7 +147,8 @@ std::vector<double> quantized_golden(const std::vector<double>& a, const std::ve
 
     // Golden path is aligned to the current simulator datapath implementation:
     //   1) A/B are quantized by pack+unpack above (aq/bq)
-    //   2) dot-product accumulation is performed in host high precision
+    //   2) dot-product accumulation is performed in host high precision,
+    //      then rounded to fp9 like the adder-tree output (fp13_to_fp9)
     //   3) C participates as fp22-quantized input (cq)
     //   4) final output is quantized by configured output type
     std::vector<double> d(M * N, 0.0);
@@ -140,7 +158,7 @@ std::vector<double> quantized_golden(const std::vector<double>& a, const std::ve
             for (int k = 0; k < K; k++) {
                 dot += aq[i * K + k] * bq[k * N + j];
             }
-            double acc_fp22 = SoftFloat::fp22_to_f64(SoftFloat::f64_to_fp22(dot + cq[i * N + j]));
+            double acc_fp22 = SoftFloat::fp22_to_f64(SoftFloat::f64_to_fp22(round_fp9_rne(dot) + cq[i * N + j]));
             d[i * N + j] = quantize_output_ref(acc_fp22, type_cd, type_cd_sub);
         }
     }
@@ -608,47 +626,1049 @@ void test_fp_roundtrips() {
         check("fp22_roundtrip_close", ok);
     }
 
-    // FP8 E4M3: 1.0 round-trip
+    // FP8 E4M3 decode: to_fp9.v copies the 4-bit exponent into the FP9
+    // exponent field unchanged, so the bias-7 value lands in a bias-15
+    // field and every E4M3 input is scaled by 2^-8. Check that behaviour
+    // rather than an IEEE-style round trip.
     {
-        double v = 1.0;
-        int s = 0; double av = 1.0;
-        int exp; double frac = frexp(av, &exp); frac *= 2; exp--;
-        int be = exp + 7;  // bias=7, so 1.0 has exp=0, be=7
-        int m = (int)((frac - 1.0) * 8 + 0.5) & 7;
-        uint8_t packed = (s << 7) | (be << 3) | m;
-        double back = FPConvert::fp8e4m3_to_f64(packed);
-        check("fp8e4m3_1.0_roundtrip", fabs(back - 1.0) < 1e-10);
+        uint8_t one = (0 << 7) | (7 << 3) | 0;      // 1.0 in E4M3
+        double back = FPConvert::fp8e4m3_to_f64(one);
+        check("fp8e4m3_1.0_rtl_decode", fabs(back - ldexp(1.0, -8)) < 1e-10);
     }
-
-    // FP8 E4M3: -0.5 round-trip
     {
-        double v = -0.5;
-        int s = 1; double av = 0.5;
-        int exp; double frac = frexp(av, &exp); frac *= 2; exp--;
-        int be = exp + 7;
-        int m = (int)((frac - 1.0) * 8 + 0.5) & 7;
-        uint8_t packed = (s << 7) | (be << 3) | m;
-        double back = FPConvert::fp8e4m3_to_f64(packed);
-        check("fp8e4m3_-0.5_roundtrip", fabs(back - (-0.5)) < 1e-10);
+        uint8_t neg_half = (1 << 7) | (6 << 3) | 0; // -0.5 in E4M3
+        double back = FPConvert::fp8e4m3_to_f64(neg_half);
+        check("fp8e4m3_-0.5_rtl_decode", fabs(back - (-ldexp(0.5, -8))) < 1e-10);
     }
 
     // FP4 round-trip for representable values
     {
-        double vals[] = {0.0, 0.5, 1.0, 1.5, 2.0, 3.0};
+        double vals[] = {0.0, 0.5, 1.0, 1.5, 2.0, 3.0, 4.0, 6.0, -0.5, -6.0};
         bool ok = true;
         for (double v : vals) {
             // Pack and unpack
             std::vector<double> vv = {v};
             auto packed = test_pack_ab(vv, TYPE_FP4, 0);
             double back = FPConvert::fp4_to_f64(packed[0] & 0xF);
-            if (fabs(back - v) > 0.5) ok = false;
+            if (back != v) ok = false;
         }
         check("fp4_roundtrip_representable", ok);
     }
 
+    // FP13/FP22 add: a carry out of the significand renormalises and keeps
+    // the sticky bit (1.9921875 + 0.0166015625 is just above a tie)
+    {
+        auto add13 = [](double x, double y) {
+            return SoftFloat::fp13_to_f64(FPEmu::fp13_add(SoftFloat::f64_to_fp13(x), SoftFloat::f64_to_fp13(y)));
+        };
+        auto add22 = [](double x, double y) {
+            return SoftFloat::fp22_to_f64(FPEmu::fp22_add(SoftFloat::f64_to_fp22(x), SoftFloat::f64_to_fp22(y)));
+        };
+        check("fp_add_carry_renormalizes", add13(1.0, 1.0) == 2.0 && add13(1.5, 1.5) == 3.0 && add13(-1.0, -1.0) == -2.0 &&
+              add22(1.0, 1.0) == 2.0 && add22(0.75, 0.5) == 1.25);
+        check("fp_add_carry_keeps_sticky", add13(1.9921875, 0.0166015625) == 2.015625);
+    }
+
     printf("  FP round-trip tests: %d passed, %d failed\n", fp_pass, fp_fail);
 }
 
+// ============================================================================
+// Fused epilogue
+// ============================================================================
+
+struct EpilogueRun {
+    std::vector<double> d;
+    std::vector<uint32_t> packed;
+    uint64_t cycles;
+    uint64_t write_bytes;
+};
+
+static EpilogueRun run_epilogue_job(const OTC_Config& cfg, const std::vector<uint32_t>& pa,
+                                    const std::vector<uint32_t>& pb, const std::vector<uint32_t>& pc) {
+    return with_device(cfg, [&](OTC_Device* dev) {
+        otc_submit(dev, pa.data(), pa.size(), pb.data(), pb.size(), pc.data(), pc.size());
+        otc_run(dev);
+        BatchResult br;
+        dev->tc.pop_output_result(br);
+        return EpilogueRun{br.d_f64, br.d_packed, otc_stats(dev).total_cycles, otc_stats(dev).dram_write_bytes};
+    });
+}
+
+void test_epilogue_suite() {
+    printf("\n=== Suite: Fused epilogue ===\n");
+
+    int ep_pass = 0, ep_fail = 0;
+
+    // FP22 -> FP4 (E2M1) rounding: round to nearest even, overflow and Inf saturate to 6
+    {
+        auto q = [](double v) { return FPEmu::fp22_to_fp4(SoftFloat::f64_to_fp22(v)); };
+        suite_check("fp22_to_fp4_exact", q(0.5) == 0x1 && q(1.0) == 0x2 && q(1.5) == 0x3 && q(3.0) == 0x5 &&
+                    q(4.0) == 0x6 && q(6.0) == 0x7 && q(-0.5) == 0x9, ep_pass, ep_fail);
+        suite_check("fp22_to_fp4_ties_to_even", q(0.25) == 0x0 && q(0.75) == 0x2 && q(1.25) == 0x2 && q(2.5) == 0x4 &&
+                    q(5.0) == 0x6, ep_pass, ep_fail);
+        suite_check("fp22_to_fp4_saturates", q(7.0) == 0x7 && q(100.0) == 0x7 && q(-100.0) == 0xF &&
+                    q(INFINITY) == 0x7, ep_pass, ep_fail);
+        bool decode_ok = true;
+        const double e2m1[8] = {0.0, 0.5, 1.0, 1.5, 2.0, 3.0, 4.0, 6.0};
+        for (int c = 0; c < 16; ++c) {
+            double v = (c & 0x8 ? -1.0 : 1.0) * e2m1[c & 0x7];
+            decode_ok = decode_ok && FPConvert::fp4_to_f64(c) == v && q(v) == (c == 0x8 ? 0x0 : c);  // -0.0 reaches FP22 as +0
+        }
+        suite_check("fp4_decode_e2m1", decode_ok, ep_pass, ep_fail);
+    }
+
+    const int M = 8, K = 8, N = 8;
+    OTC_Config base;
+    base.type_ab = TYPE_FP8; base.type_ab_sub = SUB_FP8E4M3; base.type_cd = TYPE_FP32;
+    auto pa = test_pack_ab(gen_rand(M * K, 41, -1.0, 1.0), base.type_ab, base.type_ab_sub);
+    auto pb = test_pack_ab(gen_rand(K * N, 42, -1.0, 1.0), base.type_ab, base.type_ab_sub);
+    auto pc = test_pack_c_fp16(gen_rand(M * N, 43, -0.5, 0.5));
+    auto plain = run_epilogue_job(base, pa, pb, pc);
+
+    // Reference: the same FP22 steps applied on the host to the raw accumulator
+    // (FP32 output holds the FP22 value exactly)
+    std::vector<double> bias(N), scale(N);
+    for (int j = 0; j < N; ++j) { bias[j] = 0.25 * (j - 4); scale[j] = 0.5 + 0.125 * j; }
+    auto host_epilogue = [&](const OTC_Epilogue& epi, int idx) {
+        int col = idx % N;
+        uint32_t v = SoftFloat::f64_to_fp22(plain.d[idx]);
+        v = FPEmu::fp22_add(v, SoftFloat::f64_to_fp22(epi.bias[col]));
+        double x = SoftFloat::fp22_to_f64(v);
+        if (epi.act == ACT_RELU && x <= 0.0) v = 0;
+        if (epi.act == ACT_CLAMP) v = SoftFloat::f64_to_fp22(std::min(std::max(x, epi.clamp_lo), epi.clamp_hi));
+        return FPEmu::fp22_mul(v, SoftFloat::f64_to_fp22(epi.scale.size() == 1 ? epi.scale[0] : epi.scale[col]));
+    };
+
+    {
+        OTC_Config cfg = base;
+        cfg.epilogue.enable = true;
+        cfg.epilogue.bias = bias;
+        cfg.epilogue.act = ACT_RELU;
+        cfg.epilogue.scale = scale;
+        cfg.epilogue.out_type = TYPE_FP8;
+        cfg.epilogue.out_sub = SUB_FP8E4M3;
+        auto r = run_epilogue_job(cfg, pa, pb, pc);
+        bool ok = r.packed.size() == (size_t)(M * N / 4);
+        for (int i = 0; ok && i < M * N; ++i) {
+            uint32_t code = FPEmu::fp22_to_fp8(host_epilogue(cfg.epilogue, i), SUB_FP8E4M3) & 0xFF;
+            ok = ((r.packed[i / 4] >> ((i % 4) * 8)) & 0xFF) == code && r.d[i] == FPConvert::fp8e4m3_to_f64(code);
+        }
+        suite_check("epilogue_bias_relu_chscale_fp8_bitexact", ok, ep_pass, ep_fail);
+        bool as_operand = true;
+        for (int i = 0; i < M * N; ++i) {
+            as_operand = as_operand && FPConvert::elem_to_f64(r.packed[i / 4], i % 4, TYPE_FP8, SUB_FP8E4M3) == r.d[i];
+        }
+        suite_check("epilogue_fp8_packs_next_layer_operand", as_operand, ep_pass, ep_fail);
+        suite_check("epilogue_fp8_write_bytes", r.write_bytes == (uint64_t)M * N && plain.write_bytes == (uint64_t)M * N * 4, ep_pass, ep_fail);
+    }
+    {
+        OTC_Config cfg = base;
+        cfg.epilogue.enable = true;
+        cfg.epilogue.bias = bias;
+        cfg.epilogue.act = ACT_CLAMP;
+        cfg.epilogue.clamp_lo = -1.0;
+        cfg.epilogue.clamp_hi = 1.0;
+        cfg.epilogue.scale = {2.0};
+        cfg.epilogue.out_type = TYPE_FP4;
+        auto r = run_epilogue_job(cfg, pa, pb, pc);
+        // Independent E2M1 reference: nearest of the eight magnitudes, ties to the even code
+        const double mag[8] = {0.0, 0.5, 1.0, 1.5, 2.0, 3.0, 4.0, 6.0};
+        auto e2m1_code = [&](double x) {
+            uint32_t best = 0;
+            for (uint32_t c = 1; c < 8; ++c) {
+                double d = fabs(fabs(x) - mag[c]), db = fabs(fabs(x) - mag[best]);
+                if (d < db || (d == db && (c & 1) == 0)) best = c;
+            }
+            return (std::signbit(x) ? 0x8u : 0u) | best;
+        };
+        bool ok = r.packed.size() == (size_t)(M * N / 8);
+        for (int i = 0; ok && i < M * N; ++i) {
+            uint32_t code = e2m1_code(SoftFloat::fp22_to_f64(host_epilogue(cfg.epilogue, i)));
+            double value = (code & 0x8 ? -1.0 : 1.0) * mag[code & 0x7];
+            ok = ((r.packed[i / 8] >> ((i % 8) * 4)) & 0xF) == code && r.d[i] == value;
+        }
+        suite_check("epilogue_bias_clamp_tscale_fp4_bitexact", ok, ep_pass, ep_fail);
+
+        // The packed tile is the A operand of the next FP4 GEMM
+        OTC_Config next = base;
+        next.type_ab = TYPE_FP4; next.type_ab_sub = 0;
+        auto pb4 = test_pack_ab(gen_rand(K * N, 44, -2.0, 2.0), TYPE_FP4, 0);
+        auto chained = run_epilogue_job(next, r.packed, pb4, pc);
+        auto repacked = run_epilogue_job(next, test_pack_ab(r.d, TYPE_FP4, 0), pb4, pc);
+        suite_check("epilogue_fp4_packs_next_layer_operand", chained.d == repacked.d && chained.d != plain.d, ep_pass, ep_fail);
+    }
+    {
+        OTC_Config cfg = base;
+        cfg.epilogue.enable = true;
+        cfg.epilogue.act = ACT_GELU;
+        auto r = run_epilogue_job(cfg, pa, pb, pc);
+        double max_err = 0.0;
+        for (int i = 0; i < M * N; ++i) {
+            double x = plain.d[i];
+            max_err = std::max(max_err, fabs(r.d[i] - x / (1.0 + exp(-1.702 * x))));
+        }
+        suite_check("epilogue_gelu_approx", max_err < 1e-3, ep_pass, ep_fail);
+    }
+
+    // Bias add whose sum carries out of the significand: 1 + 1 must give 2
+    {
+        OTC_Config cfg = base;
+        cfg.epilogue.enable = true;
+        cfg.epilogue.bias.assign(N, 1.0);
+        auto zeros = test_pack_ab(gen_zeros(M * K), base.type_ab, base.type_ab_sub);
+        auto r = run_epilogue_job(cfg, zeros, zeros, test_pack_c_fp16(gen_const(M * N, 1.0)));
+        suite_check("epilogue_bias_add_carries", r.d == std::vector<double>(M * N, 2.0), ep_pass, ep_fail);
+    }
+
+    // Timing: the epilogue adds its latency and is throughput bound when narrow
+    {
+        OTC_Config cfg = base;
+        cfg.epilogue.enable = true;
+        cfg.epilogue.latency = 3;
+        cfg.epilogue.throughput = cfg.dispatch_width;
+        auto wide = run_epilogue_job(cfg, pa, pb, pc);
+        cfg.epilogue.throughput = 1;
+        auto narrow = run_epilogue_job(cfg, pa, pb, pc);
+        printf("  layer cycles: no epilogue %llu, epilogue x%d/cycle %llu, x1/cycle %llu\n",
+               (unsigned long long)plain.cycles, base.dispatch_width, (unsigned long long)wide.cycles,
+               (unsigned long long)narrow.cycles);
+        suite_check("epilogue_adds_latency", wide.cycles == plain.cycles + 3 && wide.d == plain.d, ep_pass, ep_fail);
+        suite_check("epilogue_throughput_bound", narrow.cycles >= (uint64_t)(M * N + 3) && narrow.d == plain.d, ep_pass, ep_fail);
+    }
+    {
+        OTC_Config cfg = base;
+        cfg.epilogue.enable = true;
+        cfg.epilogue.bias.assign(N - 1, 0.0);
+        suite_check("epilogue_rejects_bad_bias_size", !cfg.validate(), ep_pass, ep_fail);
+    }
+
+    printf("  Epilogue tests: %d passed, %d failed\n", ep_pass, ep_fail);
+}
+
+// ============================================================================
+// Reconfiguration and mixed-precision job scheduling
+// ============================================================================
+
+static std::vector<double> run_single_job(const OTC_Config& cfg, const std::vector<uint32_t>& pa,
+                                          const std::vector<uint32_t>& pb, const std::vector<uint32_t>& pc) {
+    return with_device(cfg, [&](OTC_Device* dev) {
+        otc_upload(dev, pa.data(), pa.size(), pb.data(), pb.size(), pc.data(), pc.size());
+        otc_run(dev);
+        std::vector<double> d(cfg.M * cfg.N);
+        otc_download_f64(dev, d.data(), d.size());
+        return d;
+    });
+}
+
+void test_reconfig_suite() {
+    printf("\n=== Suite: Reconfiguration cost and job scheduling ===\n");
+
+    int rc_pass = 0, rc_fail = 0;
+
+    OTC_Config fp8;
+    fp8.type_ab = TYPE_FP8; fp8.type_ab_sub = SUB_FP8E4M3; fp8.type_cd = TYPE_FP32;
+    OTC_Config fp4 = fp8;
+    fp4.type_ab = TYPE_FP4; fp4.type_ab_sub = 0;
+    OTC_Config fp16 = fp8;
+    fp16.type_ab = TYPE_FP16; fp16.type_ab_sub = 0; fp16.type_cd = TYPE_FP16;
+
+    // Illegal combination raises config_error and keeps the old config
+    with_device(fp8, [&](OTC_Device* dev) {
+        OTC_Config bad = fp8;
+        bad.K = 6;
+        int ret = otc_configure(dev, bad);
+        suite_check("reconfig_illegal_raises_config_error", ret == -1 && otc_config_error(dev) == 1, rc_pass, rc_fail);
+        suite_check("reconfig_illegal_keeps_config", dev->tc.cfg_.K == 8 && otc_stats(dev).config_errors == 1, rc_pass, rc_fail);
+        ret = otc_configure(dev, fp16);
+        suite_check("reconfig_legal_clears_config_error", ret == 0 && otc_config_error(dev) == 0, rc_pass, rc_fail);
+    });
+
+    // Changing type costs reconfig_latency cycles, an identical config is free
+    with_device(fp8, [&](OTC_Device* dev) {
+        uint64_t c0 = dev->tc.cycle_;
+        otc_configure(dev, fp8);
+        uint64_t c1 = dev->tc.cycle_;
+        suite_check("reconfig_same_config_is_free", c1 == c0 && otc_stats(dev).reconfigs == 0, rc_pass, rc_fail);
+        otc_configure(dev, fp4);
+        uint64_t c2 = dev->tc.cycle_;
+        suite_check("reconfig_type_change_costs_latency",
+                    c2 - c1 == (uint64_t)fp4.reconfig_latency && otc_stats(dev).reconfigs == 1, rc_pass, rc_fail);
+        suite_check("reconfig_applies_new_type", dev->tc.cfg_.type_ab == TYPE_FP4, rc_pass, rc_fail);
+    });
+
+    // A reconfiguration that outlasts the driver's wait reports -2 and stays pending
+    with_device(fp8, [&](OTC_Device* dev) {
+        OTC_Config slow = fp4;
+        slow.reconfig_latency = 150000;
+        int ret = otc_configure(dev, slow);
+        bool pending = dev->tc.is_reconfiguring();
+        while (dev->tc.is_reconfiguring()) otc_tick(dev);
+        suite_check("reconfig_timeout_returns_pending", ret == -2 && pending && otc_config_error(dev) == 0, rc_pass, rc_fail);
+        suite_check("reconfig_timeout_completes_later", dev->tc.cfg_.type_ab == TYPE_FP4, rc_pass, rc_fail);
+    });
+
+    // A config change while busy drains the in-flight tile under the old config
+    {
+        auto a = gen_rand(64, 5, -1.0, 1.0), b = gen_rand(64, 6, -1.0, 1.0), c = gen_rand(64, 7, -0.5, 0.5);
+        auto pa = test_pack_ab(a, fp8.type_ab, fp8.type_ab_sub);
+        auto pb = test_pack_ab(b, fp8.type_ab, fp8.type_ab_sub);
+        auto pc = test_pack_c_fp16(c);
+        auto ref = run_single_job(fp8, pa, pb, pc);
+
+        with_device(fp8, [&](OTC_Device* dev) {
+            otc_submit(dev, pa.data(), pa.size(), pb.data(), pb.size(), pc.data(), pc.size());
+            otc_start(dev);
+            otc_tick(dev);
+            otc_tick(dev);
+            dev->tc.reconfigure(fp16);
+            bool gated = !dev->tc.can_accept_job() && dev->tc.cfg_.type_ab == TYPE_FP8;
+            otc_run(dev);
+            std::vector<double> d(64);
+            int n = otc_pop_result_f64(dev, d.data(), d.size());
+            const auto& st = otc_stats(dev);
+            suite_check("reconfig_busy_blocks_new_jobs", gated, rc_pass, rc_fail);
+            suite_check("reconfig_busy_drains_first", st.reconfig_drain_cycles > 0 &&
+                        st.reconfig_cycles == (uint64_t)fp16.reconfig_latency, rc_pass, rc_fail);
+            suite_check("reconfig_busy_result_uses_old_config", n == 64 && d == ref, rc_pass, rc_fail);
+            suite_check("reconfig_busy_applies_after_drain", dev->tc.cfg_.type_ab == TYPE_FP16 && dev->tc.can_accept_job(), rc_pass, rc_fail);
+        });
+
+        // A register-only change also waits for the drain but costs no reload
+        OTC_Config fp8_relu = fp8;
+        fp8_relu.epilogue.enable = true;
+        fp8_relu.epilogue.act = ACT_RELU;
+        with_device(fp8, [&](OTC_Device* dev) {
+            otc_submit(dev, pa.data(), pa.size(), pb.data(), pb.size(), pc.data(), pc.size());
+            otc_start(dev);
+            otc_tick(dev);
+            otc_tick(dev);
+            dev->tc.reconfigure(fp8_relu);
+            bool deferred = !dev->tc.cfg_.epilogue.enable && !dev->tc.can_accept_job();
+            otc_run(dev);
+            std::vector<double> d(64);
+            int n = otc_pop_result_f64(dev, d.data(), d.size());
+            const auto& st = otc_stats(dev);
+            suite_check("reconfig_regs_busy_deferred", deferred, rc_pass, rc_fail);
+            suite_check("reconfig_regs_result_uses_old_config", n == 64 && d == ref, rc_pass, rc_fail);
+            suite_check("reconfig_regs_applies_free", dev->tc.cfg_.epilogue.enable && dev->tc.can_accept_job() &&
+                        st.reconfigs == 0 && st.reconfig_cycles == 0, rc_pass, rc_fail);
+        });
+
+        // Datapath changes requested while one is pending merge into one reload
+        with_device(fp8, [&](OTC_Device* dev) {
+            otc_submit(dev, pa.data(), pa.size(), pb.data(), pb.size(), pc.data(), pc.size());
+            otc_start(dev);
+            otc_tick(dev);
+            dev->tc.reconfigure(fp16);
+            dev->tc.reconfigure(fp4);
+            otc_run(dev);
+            const auto& st = otc_stats(dev);
+            suite_check("reconfig_pending_merges", st.reconfigs == 1 &&
+                        st.reconfig_cycles == (uint64_t)fp4.reconfig_latency &&
+                        dev->tc.cfg_.type_ab == TYPE_FP4, rc_pass, rc_fail);
+        });
+    }
+
+    // Mixed FP8/FP4/FP16 stream, in submission order versus grouped by config
+    {
+        const OTC_Config* pattern[] = {&fp8, &fp4, &fp16};
+        const int num_jobs = 12;
+        std::vector<std::vector<uint32_t>> pa(num_jobs), pb(num_jobs), pc(num_jobs);
+        for (int j = 0; j < num_jobs; ++j) {
+            const OTC_Config& cfg = *pattern[j % 3];
+            pa[j] = test_pack_ab(gen_rand(64, 100 + j, -1.0, 1.0), cfg.type_ab, cfg.type_ab_sub);
+            pb[j] = test_pack_ab(gen_rand(64, 200 + j, -1.0, 1.0), cfg.type_ab, cfg.type_ab_sub);
+            pc[j] = test_pack_c_fp16(gen_rand(64, 300 + j, -0.5, 0.5));
+        }
+
+        OTC_QueueReport rep[2];
+        bool results_ok = true;
+        for (int reorder = 0; reorder < 2; ++reorder) {
+            with_device(*pattern[0], [&](OTC_Device* dev) {
+                for (int j = 0; j < num_jobs; ++j) {
+                    otc_queue_job(dev, *pattern[j % 3], pa[j].data(), pa[j].size(), pb[j].data(), pb[j].size(),
+                                  pc[j].data(), pc[j].size());
+                }
+                otc_run_queue(dev, reorder != 0, &rep[reorder]);
+                for (int j = 0; j < num_jobs; ++j) {
+                    std::vector<double> d(64);
+                    int n = otc_job_result_f64(dev, j, d.data(), d.size());
+                    results_ok = results_ok && n == 64 && d == run_single_job(*pattern[j % 3], pa[j], pb[j], pc[j]);
+                }
+            });
+        }
+
+        printf("  mixed fp8/fp4/fp16 x%d: in-order %llu cycles (%d reconfigs, %llu drain, %llu stall), "
+               "grouped %llu cycles (%d reconfigs, %llu drain, %llu stall), saved %lld cycles\n",
+               num_jobs, (unsigned long long)rep[0].cycles, rep[0].reconfigs, (unsigned long long)rep[0].drain_cycles,
+               (unsigned long long)rep[0].reconfig_cycles,
+               (unsigned long long)rep[1].cycles, rep[1].reconfigs, (unsigned long long)rep[1].drain_cycles,
+               (unsigned long long)rep[1].reconfig_cycles,
+               (long long)rep[0].cycles - (long long)rep[1].cycles);
+        suite_check("sched_results_match_single_runs", results_ok, rc_pass, rc_fail);
+        suite_check("sched_in_order_reconfigs", rep[0].reconfigs == num_jobs - 1, rc_pass, rc_fail);
+        suite_check("sched_grouped_reconfigs", rep[1].reconfigs == 2, rc_pass, rc_fail);
+        // A switch waits for the last old-config tile to dispatch and drain;
+        // only the drain beyond its dispatch slot is lost to overlap, so each
+        // switch costs its reload plus drain minus one tile's dispatch cycles
+        int per_tile = (fp8.total_dp() + fp8.dispatch_width - 1) / fp8.dispatch_width;
+        auto switch_cost = [&](const OTC_QueueReport& r) {
+            return (long long)(r.reconfig_cycles + r.drain_cycles) - (long long)r.reconfigs * per_tile;
+        };
+        suite_check("sched_grouped_saves_cycles", rep[1].cycles < rep[0].cycles &&
+                    (long long)(rep[0].cycles - rep[1].cycles) == switch_cost(rep[0]) - switch_cost(rep[1]), rc_pass, rc_fail);
+
+        // A result submitted outside the queue stays in the output FIFO for its owner
+        with_device(fp8, [&](OTC_Device* dev) {
+            otc_submit(dev, pa[0].data(), pa[0].size(), pb[0].data(), pb[0].size(), pc[0].data(), pc[0].size());
+            otc_start(dev);
+            otc_queue_job(dev, fp8, pa[3].data(), pa[3].size(), pb[3].data(), pb[3].size(), pc[3].data(), pc[3].size());
+            int rc = otc_run_queue(dev, false);
+            std::vector<double> d(64), q(64);
+            int n = otc_pop_result_f64(dev, d.data(), d.size());
+            int nq = otc_job_result_f64(dev, 0, q.data(), q.size());
+            suite_check("sched_keeps_foreign_results", rc == 0 && n == 64 && d == run_single_job(fp8, pa[0], pb[0], pc[0]) &&
+                        nq == 64 && q == run_single_job(fp8, pa[3], pb[3], pc[3]), rc_pass, rc_fail);
+        });
+
+        // Jobs that differ only in epilogue registers each run under their own
+        // config, and switching between them is not a datapath reconfiguration
+        OTC_Config fp8_relu = fp8;
+        fp8_relu.epilogue.enable = true;
+        fp8_relu.epilogue.act = ACT_RELU;
+        for (int reorder = 0; reorder < 2; ++reorder) {
+            for (const OTC_Config* dev_cfg : {&fp8, &fp8_relu}) {
+                with_device(*dev_cfg, [&](OTC_Device* dev) {
+                    const OTC_Config* job_cfg[] = {&fp8_relu, &fp8, &fp8_relu};
+                    for (int j = 0; j < 3; ++j) {
+                        otc_queue_job(dev, *job_cfg[j], pa[3 * j].data(), pa[3 * j].size(), pb[3 * j].data(),
+                                      pb[3 * j].size(), pc[3 * j].data(), pc[3 * j].size());
+                    }
+                    OTC_QueueReport r;
+                    int rc = otc_run_queue(dev, reorder != 0, &r);
+                    bool ok = rc == 0 && r.reconfigs == 0 && r.reconfig_cycles == 0;
+                    for (int j = 0; j < 3; ++j) {
+                        std::vector<double> d(64);
+                        int n = otc_job_result_f64(dev, j, d.data(), d.size());
+                        ok = ok && n == 64 && d == run_epilogue_job(*job_cfg[j], pa[3 * j], pb[3 * j], pc[3 * j]).d;
+                    }
+                    char name[64];
+                    snprintf(name, sizeof(name), "sched_epilogue_per_job_%s_%s", reorder ? "grouped" : "in_order",
+                             dev_cfg == &fp8 ? "plain_dev" : "relu_dev");
+                    suite_check(name, ok, rc_pass, rc_fail);
+                });
+            }
+        }
+    }
+
+    printf("  Reconfig tests: %d passed, %d failed\n", rc_pass, rc_fail);
+}
+
+// ============================================================================
+// Batched and grouped GEMM submission
+// ============================================================================
+
+void test_grouped_gemm_suite() {
+    printf("\n=== Suite: Batched and grouped GEMM ===\n");
+
+    int gg_pass = 0, gg_fail = 0;
+
+    // {-1, 0, 1} operands and +-0.5 bias keep every FP9/FP13/FP22 step exact,
+    // so the FP32 output must equal the double-precision GEMM
+    OTC_Config cfg;
+    cfg.type_ab = TYPE_FP16; cfg.type_ab_sub = 0; cfg.type_cd = TYPE_FP32;
+    auto ternary = [](int n, unsigned seed) {
+        auto v = gen_small_ints(n, seed);
+        for (auto& x : v) x = std::max(-1.0, std::min(1.0, x));
+        return v;
+    };
+
+    struct Problem {
+        int m, k, n;
+        std::vector<double> a, b, c, gold, d;
+        std::vector<uint32_t> pa, pb, pc;
+    };
+    const int shapes[][3] = {{8, 8, 8}, {5, 8, 3}, {16, 4, 12}, {3, 2, 20}, {12, 8, 16}, {1, 8, 1}};
+    std::vector<Problem> probs;
+    for (int i = 0; i < 6; ++i) {
+        Problem p;
+        p.m = shapes[i][0]; p.k = shapes[i][1]; p.n = shapes[i][2];
+        p.a = ternary(p.m * p.k, 500 + i);
+        p.b = ternary(p.k * p.n, 600 + i);
+        p.c = ternary(p.m * p.n, 700 + i);
+        for (auto& x : p.c) x *= 0.5;
+        p.gold.assign(p.m * p.n, 0.0);
+        for (int r = 0; r < p.m; ++r)
+            for (int col = 0; col < p.n; ++col) {
+                double acc = p.c[r * p.n + col];
+                for (int kk = 0; kk < p.k; ++kk) acc += p.a[r * p.k + kk] * p.b[kk * p.n + col];
+                p.gold[r * p.n + col] = acc;
+            }
+        p.pa = test_pack_ab(p.a, cfg.type_ab, 0);
+        p.pb = test_pack_ab(p.b, cfg.type_ab, 0);
+        p.pc = test_pack_c_fp16(p.c);
+        p.d.assign(p.m * p.n, 0.0);
+        probs.push_back(p);
+    }
+    auto desc = [](Problem& p) {
+        OTC_GemmDesc g;
+        g.m = p.m; g.k = p.k; g.n = p.n;
+        g.a = p.pa.data(); g.b = p.pb.data(); g.c = p.pc.data(); g.d = p.d.data();
+        return g;
+    };
+
+    // One call per GEMM: the device drains between problems
+    uint64_t seq_cycles = 0;
+    bool seq_ok = true;
+    with_device(cfg, [&](OTC_Device* dev) {
+        for (auto& p : probs) {
+            OTC_GemmDesc g = desc(p);
+            OTC_GemmReport rep;
+            int ret = otc_gemm_grouped(dev, &g, 1, &rep);
+            seq_ok = seq_ok && ret == 0 && p.d == p.gold;
+            seq_cycles += rep.cycles;
+        }
+    });
+    suite_check("grouped_single_calls_exact", seq_ok, gg_pass, gg_fail);
+
+    // All heterogeneous GEMMs in one grouped call
+    {
+        for (auto& p : probs) std::fill(p.d.begin(), p.d.end(), 0.0);
+        std::vector<OTC_GemmDesc> gemms;
+        for (auto& p : probs) gemms.push_back(desc(p));
+        with_device(cfg, [&](OTC_Device* dev) {
+            OTC_GemmReport rep;
+            int ret = otc_gemm_grouped(dev, gemms.data(), gemms.size(), &rep);
+            bool ok = ret == 0;
+            for (auto& p : probs) ok = ok && p.d == p.gold;
+            suite_check("grouped_heterogeneous_exact", ok, gg_pass, gg_fail);
+            suite_check("grouped_tile_count", rep.tiles == 1 + 1 + 4 + 3 + 4 + 1, gg_pass, gg_fail);
+            printf("  %-8s %5s %6s %8s %10s %8s\n", "group", "tiles", "MACs", "cycles", "MAC/cycle", "util");
+            for (size_t g = 0; g < rep.groups.size(); ++g) {
+                const auto& gr = rep.groups[g];
+                printf("  %2dx%2dx%-2d %5d %6llu %8llu %10.2f %7.1f%%\n", probs[g].m, probs[g].k, probs[g].n, gr.tiles,
+                       (unsigned long long)gr.macs, (unsigned long long)(gr.done_cycle - gr.start_cycle),
+                       gr.macs_per_cycle, 100.0 * gr.tile_util);
+            }
+            printf("  aggregate: %d tiles, %llu MACs, %llu cycles, %.2f MAC/cycle (one call per GEMM: %llu cycles)\n",
+                   rep.tiles, (unsigned long long)rep.macs, (unsigned long long)rep.cycles, rep.macs_per_cycle,
+                   (unsigned long long)seq_cycles);
+            suite_check("grouped_overlaps_problems", rep.cycles < seq_cycles, gg_pass, gg_fail);
+        });
+    }
+
+    // k deeper than K runs as FP22 K-slices, next to a shallow problem
+    {
+        Problem deep;
+        deep.m = 12; deep.k = 2 * cfg.K + 4; deep.n = 10;
+        deep.a = ternary(deep.m * deep.k, 510);
+        deep.b = ternary(deep.k * deep.n, 610);
+        deep.c = ternary(deep.m * deep.n, 710);
+        for (auto& x : deep.c) x *= 0.5;
+        deep.gold.assign(deep.m * deep.n, 0.0);
+        for (int r = 0; r < deep.m; ++r)
+            for (int col = 0; col < deep.n; ++col) {
+                double acc = deep.c[r * deep.n + col];
+                for (int kk = 0; kk < deep.k; ++kk) acc += deep.a[r * deep.k + kk] * deep.b[kk * deep.n + col];
+                deep.gold[r * deep.n + col] = acc;
+            }
+        deep.pa = test_pack_ab(deep.a, cfg.type_ab, 0);
+        deep.pb = test_pack_ab(deep.b, cfg.type_ab, 0);
+        deep.pc = test_pack_c_fp16(deep.c);
+        deep.d.assign(deep.m * deep.n, 0.0);
+        std::fill(probs[1].d.begin(), probs[1].d.end(), 0.0);
+        OTC_GemmDesc gemms[] = {desc(deep), desc(probs[1])};
+        with_device(cfg, [&](OTC_Device* dev) {
+            OTC_GemmReport rep;
+            int ret = otc_gemm_grouped(dev, gemms, 2, &rep);
+            suite_check("grouped_deep_k_slices_exact", ret == 0 && deep.d == deep.gold && probs[1].d == probs[1].gold &&
+                        rep.groups[0].k_slices == 3 && rep.groups[1].k_slices == 1, gg_pass, gg_fail);
+            suite_check("grouped_deep_k_partials_stay_on_chip",
+                        otc_stats(dev).dram_write_bytes == (uint64_t)(2 * 2 + 1) * cfg.M * cfg.N * 4, gg_pass, gg_fail);
+        });
+    }
+
+    // Uniform batch addressed by strides
+    {
+        const int count = 6, m = 8, k = 8, n = 8;
+        std::vector<double> a = ternary(count * m * k, 800), b = ternary(count * k * n, 801);
+        std::vector<double> c(count * m * n, 0.5), d(count * m * n, 0.0);
+        auto pa = test_pack_ab(a, cfg.type_ab, 0), pb = test_pack_ab(b, cfg.type_ab, 0);
+        auto pc = test_pack_c_fp16(c);
+        int eperw = 32 / FPConvert::elem_bits(cfg.type_ab);
+        with_device(cfg, [&](OTC_Device* dev) {
+            OTC_GemmReport rep;
+            int ret = otc_gemm_batched(dev, m, k, n, count, pa.data(), m * k / eperw, pb.data(), k * n / eperw,
+                                       pc.data(), m * n / 2, d.data(), m * n, &rep);
+            bool ok = ret == 0;
+            for (int i = 0; i < count && ok; ++i)
+                for (int r = 0; r < m; ++r)
+                    for (int col = 0; col < n; ++col) {
+                        double acc = 0.5;
+                        for (int kk = 0; kk < k; ++kk) acc += a[i * m * k + r * k + kk] * b[i * k * n + kk * n + col];
+                        ok = ok && d[i * m * n + r * n + col] == acc;
+                    }
+            printf("  batched %dx %dx%dx%d: %llu cycles, %.2f MAC/cycle\n", count, m, k, n,
+                   (unsigned long long)rep.cycles, rep.macs_per_cycle);
+            suite_check("batched_strided_exact", ok, gg_pass, gg_fail);
+        });
+    }
+
+    printf("  Grouped GEMM tests: %d passed, %d failed\n", gg_pass, gg_fail);
+}
+
+// ============================================================================
+// Implicit-GEMM convolution
+// ============================================================================
+
+void test_conv2d_suite() {
+    printf("\n=== Suite: Implicit-GEMM conv2d ===\n");
+
+    int cv_pass = 0, cv_fail = 0;
+
+    // {-1, 0, 1} operands: every K slice sums to at most K = 8 and the FP22
+    // accumulation across slices is integer, so results must match exactly
+    OTC_Config cfg;
+    cfg.type_ab = TYPE_FP16; cfg.type_ab_sub = 0; cfg.type_cd = TYPE_FP32;
+    auto ternary = [](int n, unsigned seed) {
+        auto v = gen_small_ints(n, seed);
+        for (auto& x : v) x = std::max(-1.0, std::min(1.0, x));
+        return v;
+    };
+
+    // direct convolution, no im2col
+    auto direct_conv = [](const OTC_ConvShape& cs, const std::vector<double>& in, const std::vector<double>& f) {
+        int cg = cs.c / cs.groups, kg = cs.k / cs.groups;
+        std::vector<double> out((size_t)cs.n * cs.k * cs.out_h() * cs.out_w(), 0.0);
+        for (int img = 0; img < cs.n; ++img)
+            for (int oc = 0; oc < cs.k; ++oc)
+                for (int y = 0; y < cs.out_h(); ++y)
+                    for (int x = 0; x < cs.out_w(); ++x) {
+                        double acc = 0.0;
+                        for (int ch = 0; ch < cg; ++ch)
+                            for (int fr = 0; fr < cs.r; ++fr)
+                                for (int fs = 0; fs < cs.s; ++fs) {
+                                    int iy = y * cs.stride_h - cs.pad_h + fr * cs.dil_h;
+                                    int ix = x * cs.stride_w - cs.pad_w + fs * cs.dil_w;
+                                    if (iy < 0 || iy >= cs.h || ix < 0 || ix >= cs.w) continue;
+                                    int ic = oc / kg * cg + ch;
+                                    int fi = cs.nhwc ? ((oc * cs.r + fr) * cs.s + fs) * cg + ch
+                                                     : ((oc * cg + ch) * cs.r + fr) * cs.s + fs;
+                                    acc += in[cs.input_index(img, ic, iy, ix)] * f[fi];
+                                }
+                        out[cs.output_index(img, oc, y, x)] = acc;
+                    }
+        return out;
+    };
+
+    struct Case { const char* name; OTC_ConvShape cs; };
+    std::vector<Case> cases(4);
+    {
+        auto& c = cases[0].cs; cases[0].name = "3x3 pad1 NCHW";
+        c.n = 2; c.c = 3; c.h = 7; c.w = 6; c.k = 5; c.r = 3; c.s = 3; c.pad_h = c.pad_w = 1;
+    }
+    {
+        auto& c = cases[1].cs; cases[1].name = "3x2 s2 d2 g2 NHWC";
+        c.n = 1; c.c = 4; c.h = 9; c.w = 8; c.k = 6; c.r = 3; c.s = 2; c.stride_h = 2; c.pad_h = 2; c.pad_w = 1;
+        c.dil_h = 2; c.groups = 2; c.nhwc = true;
+    }
+    {
+        auto& c = cases[2].cs; cases[2].name = "depthwise 3x3 NCHW";
+        c.n = 1; c.c = 4; c.h = 6; c.w = 6; c.k = 4; c.r = 3; c.s = 3; c.pad_h = c.pad_w = 1; c.groups = 4;
+    }
+    {
+        auto& c = cases[3].cs; cases[3].name = "1x1 NHWC";
+        c.n = 2; c.c = 8; c.h = 4; c.w = 4; c.k = 16; c.nhwc = true;
+    }
+
+    with_device(cfg, [&](OTC_Device* dev) {
+        printf("  %-20s %5s %6s %6s %8s %10s %8s %8s\n", "case", "tiles", "slices", "MACs", "cycles", "MAC/cycle",
+               "in B", "im2col B");
+        bool all_exact = true, writes_ok = true;
+        OTC_ConvReport first;
+        for (size_t i = 0; i < cases.size(); ++i) {
+            const auto& cs = cases[i].cs;
+            int cg = cs.c / cs.groups;
+            auto in = ternary(cs.n * cs.c * cs.h * cs.w, 900 + i);
+            auto f = ternary(cs.k * cg * cs.r * cs.s, 950 + i);
+            auto gold = direct_conv(cs, in, f);
+            auto pin = test_pack_ab(in, cfg.type_ab, 0), pf = test_pack_ab(f, cfg.type_ab, 0);
+            std::vector<double> out(gold.size(), 0.0);
+            OTC_ConvReport rep;
+            int ret = otc_conv2d(dev, cs, pin.data(), pf.data(), out.data(), &rep);
+            all_exact = all_exact && ret == 0 && out == gold;
+            writes_ok = writes_ok && rep.output_bytes == (uint64_t)rep.tiles * cfg.M * cfg.N * 4;
+            if (i == 0) first = rep;
+            printf("  %-20s %5d %6d %6llu %8llu %10.2f %8llu %8llu\n", cases[i].name, rep.tiles, rep.k_slices,
+                   (unsigned long long)rep.macs, (unsigned long long)rep.cycles, rep.macs_per_cycle,
+                   (unsigned long long)rep.input_bytes, (unsigned long long)rep.im2col_bytes);
+        }
+        suite_check("conv2d_matches_direct_conv", all_exact, cv_pass, cv_fail);
+        suite_check("conv2d_deep_k_in_slices", first.k_slices == 4, cv_pass, cv_fail);
+        suite_check("conv2d_partial_sums_stay_on_chip", writes_ok, cv_pass, cv_fail);
+        suite_check("conv2d_feed_reads_less_than_im2col", first.input_bytes < first.im2col_bytes, cv_pass, cv_fail);
+        suite_check("conv2d_rejects_bad_groups", [&] {
+            OTC_ConvShape cs = cases[0].cs;
+            cs.groups = 2;
+            std::vector<uint32_t> w(64, 0);
+            std::vector<double> out(1024);
+            return otc_conv2d(dev, cs, w.data(), w.data(), out.data()) == -3;
+        }(), cv_pass, cv_fail);
+    });
+
+    // The epilogue only sees a tile's last K slice: partial sums bypass it,
+    // so a deep-k conv pays the epilogue once per output tile
+    {
+        const auto& cs = cases[0].cs;
+        auto in = ternary(cs.n * cs.c * cs.h * cs.w, 900), f = ternary(cs.k * cs.c * cs.r * cs.s, 950);
+        auto gold = direct_conv(cs, in, f);
+        for (auto& x : gold) x = std::max(0.0, x);
+        auto pin = test_pack_ab(in, cfg.type_ab, 0), pf = test_pack_ab(f, cfg.type_ab, 0);
+        OTC_Config ecfg = cfg;
+        ecfg.epilogue.enable = true;
+        ecfg.epilogue.act = ACT_RELU;
+        ecfg.epilogue.throughput = 2;
+        OTC_ConvReport rep[2];
+        uint64_t epi_ops = 0;
+        std::vector<double> out(gold.size(), 0.0);
+        for (int e = 0; e < 2; ++e) {
+            with_device(e ? ecfg : cfg, [&](OTC_Device* dev) {
+                otc_conv2d(dev, cs, pin.data(), pf.data(), out.data(), &rep[e]);
+                epi_ops = otc_stats(dev).epilogue_ops;
+            });
+        }
+        printf("  deep-k conv, %d slices: %llu cycles, %llu with a 2/cycle ReLU epilogue\n", rep[1].k_slices,
+               (unsigned long long)rep[0].cycles, (unsigned long long)rep[1].cycles);
+        suite_check("conv2d_epilogue_last_slice_only", out == gold &&
+                    epi_ops == (uint64_t)rep[1].tiles * cfg.M * cfg.N, cv_pass, cv_fail);
+        suite_check("conv2d_epilogue_cycles", rep[1].cycles - rep[0].cycles < (uint64_t)rep[1].tiles * cfg.M * cfg.N / 2,
+                    cv_pass, cv_fail);
+    }
+
+    printf("  Conv2d tests: %d passed, %d failed\n", cv_pass, cv_fail);
+}
+
+// ============================================================================
+// Fused attention
+// ============================================================================
+
+void test_attention_suite() {
+    printf("\n=== Suite: Fused attention ===\n");
+
+    int at_pass = 0, at_fail = 0;
+
+    OTC_Config cfg;
+    cfg.type_ab = TYPE_FP16; cfg.type_ab_sub = 0; cfg.type_cd = TYPE_FP32;
+    auto ternary = [](int n, unsigned seed) {
+        auto v = gen_small_ints(n, seed);
+        for (auto& x : v) x = std::max(-1.0, std::min(1.0, x));
+        return v;
+    };
+
+    auto reference = [](const OTC_AttnShape& as, const std::vector<double>& q, const std::vector<double>& k,
+                        const std::vector<double>& v) {
+        int d = as.head_dim;
+        double scale = as.scale != 0.0 ? as.scale : 1.0 / std::sqrt((double)d);
+        std::vector<double> out((size_t)as.heads * as.seq_q * d, 0.0);
+        for (int h = 0; h < as.heads; ++h)
+            for (int i = 0; i < as.seq_q; ++i) {
+                int keys = as.causal ? std::min(i + 1, as.seq_kv) : as.seq_kv;
+                std::vector<double> sc(keys);
+                double mx = -INFINITY, sum = 0.0;
+                for (int j = 0; j < keys; ++j) {
+                    double acc = 0.0;
+                    for (int x = 0; x < d; ++x) acc += q[(h * as.seq_q + i) * d + x] * k[(h * as.seq_kv + j) * d + x];
+                    sc[j] = acc * scale;
+                    mx = std::max(mx, sc[j]);
+                }
+                for (auto& x : sc) { x = std::exp(x - mx); sum += x; }
+                for (int j = 0; j < keys; ++j)
+                    for (int x = 0; x < d; ++x)
+                        out[(h * as.seq_q + i) * d + x] += sc[j] / sum * v[(h * as.seq_kv + j) * d + x];
+            }
+        return out;
+    };
+
+    with_device(cfg, [&](OTC_Device* dev) {
+
+        // Zero keys give uniform weights: every probability is exactly 1, the
+        // ternary PV sums and the row sums are integers, so O is the exact mean
+        // of the visible V rows
+        for (int causal = 0; causal < 2; ++causal) {
+            OTC_AttnShape as;
+            as.heads = 2; as.seq_q = 19; as.seq_kv = causal ? 19 : 13; as.head_dim = 12; as.causal = causal;
+            auto q = ternary(as.heads * as.seq_q * as.head_dim, 1000 + causal);
+            std::vector<double> k(as.heads * as.seq_kv * as.head_dim, 0.0);
+            auto v = ternary(as.heads * as.seq_kv * as.head_dim, 1010 + causal);
+            std::vector<double> o(as.heads * as.seq_q * as.head_dim, 0.0), gold(o.size());
+            for (int h = 0; h < as.heads; ++h)
+                for (int i = 0; i < as.seq_q; ++i) {
+                    int keys = causal ? i + 1 : as.seq_kv;
+                    for (int x = 0; x < as.head_dim; ++x) {
+                        double sum = 0.0;
+                        for (int j = 0; j < keys; ++j) sum += v[(h * as.seq_kv + j) * as.head_dim + x];
+                        gold[(h * as.seq_q + i) * as.head_dim + x] = SoftFloat::fp32_to_f64(SoftFloat::f64_to_fp32(sum / keys));
+                    }
+                }
+            auto pq = test_pack_ab(q, cfg.type_ab, 0), pk = test_pack_ab(k, cfg.type_ab, 0), pv = test_pack_ab(v, cfg.type_ab, 0);
+            int ret = otc_attention(dev, as, pq.data(), pk.data(), pv.data(), o.data());
+            suite_check(causal ? "attention_uniform_causal_exact" : "attention_uniform_padded_keys_exact", ret == 0 && o == gold, at_pass, at_fail);
+        }
+
+        // Random operands against a double-precision softmax. P is requantized
+        // and multiplied in FP9, so agreement is to a few percent of the V range.
+        printf("  %-12s %6s %7s %8s %10s %8s %9s %9s %9s %8s\n", "case", "blocks", "batches", "cycles", "MAC/cycle",
+               "SFU cyc", "off-chip", "on-chip", "unfused", "max err");
+        bool all_close = true, all_saved = true;
+        for (int causal = 0; causal < 2; ++causal) {
+            OTC_AttnShape as;
+            as.heads = 2; as.seq_q = 32; as.seq_kv = 32; as.head_dim = 16; as.causal = causal;
+            auto q = gen_rand(as.heads * as.seq_q * as.head_dim, 1100 + causal);
+            auto k = gen_rand(as.heads * as.seq_kv * as.head_dim, 1110 + causal);
+            auto v = gen_rand(as.heads * as.seq_kv * as.head_dim, 1120 + causal);
+            auto pq = test_pack_ab(q, cfg.type_ab, 0), pk = test_pack_ab(k, cfg.type_ab, 0), pv = test_pack_ab(v, cfg.type_ab, 0);
+            // compare against the operands as the DP multipliers see them
+            auto as_fp9 = [](std::vector<double>& x, const std::vector<uint32_t>& w) {
+                for (size_t i = 0; i < x.size(); ++i) x[i] = FPConvert::fp16_to_f64_via_fp9((w[i / 2] >> (16 * (i % 2))) & 0xFFFF);
+            };
+            as_fp9(q, pq); as_fp9(k, pk); as_fp9(v, pv);
+            auto gold = reference(as, q, k, v);
+            std::vector<double> o(gold.size(), 0.0);
+            OTC_AttnReport rep;
+            int ret = otc_attention(dev, as, pq.data(), pk.data(), pv.data(), o.data(), &rep);
+            double max_err = 0.0;
+            for (size_t i = 0; i < o.size(); ++i) max_err = std::max(max_err, std::fabs(o[i] - gold[i]));
+            all_close = all_close && ret == 0 && max_err < 0.05;
+            all_saved = all_saved && rep.offchip_bytes < rep.unfused_offchip_bytes;
+            printf("  %-12s %6d %7d %8llu %10.2f %8llu %9llu %9llu %9llu %8.4f\n", causal ? "causal" : "full",
+                   rep.kv_blocks, rep.batches, (unsigned long long)rep.cycles, rep.macs_per_cycle,
+                   (unsigned long long)rep.sfu_busy_cycles, (unsigned long long)rep.offchip_bytes,
+                   (unsigned long long)rep.onchip_bytes, (unsigned long long)rep.unfused_offchip_bytes, max_err);
+            if (causal) suite_check("attention_causal_skips_blocks", rep.kv_blocks < rep.q_tiles * 4, at_pass, at_fail);
+        }
+        suite_check("attention_random_close_to_reference", all_close, at_pass, at_fail);
+        suite_check("attention_keeps_intermediates_on_chip", all_saved, at_pass, at_fail);
+        suite_check("attention_rejects_bad_shape", [&] {
+            OTC_AttnShape as;
+            as.head_dim = 0;
+            uint32_t w = 0;
+            double out = 0;
+            return otc_attention(dev, as, &w, &w, &w, &out) == -3;
+        }(), at_pass, at_fail);
+    });
+
+    printf("  Attention tests: %d passed, %d failed\n", at_pass, at_fail);
+}
+
+// ============================================================================
+// Zero-operand skipping
+// ============================================================================
+
+void test_zero_skip_suite() {
+    printf("\n=== Suite: Zero-operand skipping ===\n");
+
+    int zs_pass = 0, zs_fail = 0;
+
+    // two multipliers per DP (four passes per dense dot product) and a
+    // dispatcher wide enough that the multipliers are the bottleneck
+    OTC_Config dense;
+    dense.type_ab = TYPE_FP16; dense.type_ab_sub = 0; dense.type_cd = TYPE_FP32;
+    dense.dp_lanes = 2; dense.dispatch_width = 64;
+    OTC_Config skip = dense;
+    skip.zero_skip = true;
+
+    auto same_bits = [](const std::vector<double>& x, const std::vector<double>& y) {
+        return x.size() == y.size() && memcmp(x.data(), y.data(), x.size() * sizeof(double)) == 0;
+    };
+
+    // Raw FP16 words for the special cases. The reference is the dense
+    // datapath itself, whatever it does with signed zeros and Inf/NaN.
+    auto run_words = [](const OTC_Config& cfg, uint32_t a, uint32_t b, uint32_t c) {
+        std::vector<uint32_t> wa(cfg.M * cfg.K / 2, a), wb(cfg.K * cfg.N / 2, b), wc(cfg.M * cfg.N / 2, c);
+        std::vector<double> d(cfg.M * cfg.N);
+        return with_device(cfg, [&](OTC_Device* dev) {
+            otc_submit(dev, wa.data(), wa.size(), wb.data(), wb.size(), wc.data(), wc.size());
+            otc_start(dev);
+            otc_run(dev);
+            otc_pop_result_f64(dev, d.data(), d.size());
+            return d;
+        });
+    };
+    auto same_words = [&](uint32_t a, uint32_t b, uint32_t c) { return same_bits(run_words(dense, a, b, c), run_words(skip, a, b, c)); };
+    suite_check("zero_skip_negative_zeros_bit_identical", same_words(0x80008000u, 0x3C003C00u, 0x80008000u), zs_pass, zs_fail);
+    suite_check("zero_skip_mixed_zero_signs_bit_identical", same_words(0x80000000u, 0xBC003C00u, 0x00008000u), zs_pass, zs_fail);
+    // a zero lane against Inf is not skipped: it must not turn into +-0
+    suite_check("zero_skip_zero_times_inf_not_skipped", same_words(0x00000000u, 0x7C00FC00u, 0x00000000u) &&
+                                                        !std::isfinite(run_words(skip, 0x00000000u, 0x7C00FC00u, 0x00000000u)[0]), zs_pass, zs_fail);
+
+    // Batched GEMMs with increasing activation sparsity; zeros carry random signs
+    const int count = 16, m = 8, k = 8, n = 8;
+    auto b = gen_rand(count * k * n, 1300);
+    auto pb = test_pack_ab(b, TYPE_FP16, 0);
+    std::vector<double> c(count * m * n, 0.25);
+    auto pc = test_pack_c_fp16(c);
+    auto run = [&](const OTC_Config& cfg, const std::vector<uint32_t>& pa, std::vector<double>& d, OTC_Stats& st) {
+        return with_device(cfg, [&](OTC_Device* dev) {
+            OTC_GemmReport rep;
+            otc_gemm_batched(dev, m, k, n, count, pa.data(), m * k / 2, pb.data(), k * n / 2, pc.data(), m * n / 2,
+                             d.data(), m * n, &rep);
+            st = otc_stats(dev);
+            return rep.cycles;
+        });
+    };
+    printf("  %-9s %8s %8s %8s %12s\n", "sparsity", "dense", "skip", "speedup", "passes/dot");
+    bool exact = true, monotonic = true;
+    double prev = 0.0, speedup_70 = 0.0;
+    const double levels[] = {0.0, 0.25, 0.5, 0.6, 0.7, 0.9};
+    for (double sp : levels) {
+        auto a = gen_rand(count * m * k, 1301);
+        unsigned rng = 1302;
+        for (auto& x : a) {
+            rng = rng * 1103515245u + 12345u;
+            if ((rng >> 16) % 1000 < sp * 1000) x = (rng >> 8) & 1 ? -0.0 : 0.0;
+        }
+        auto pa = test_pack_ab(a, TYPE_FP16, 0);
+        std::vector<double> d0(count * m * n), d1(count * m * n);
+        OTC_Stats s0, s1;
+        uint64_t c0 = run(dense, pa, d0, s0), c1 = run(skip, pa, d1, s1);
+        double speedup = (double)c0 / c1;
+        exact = exact && same_bits(d0, d1);
+        monotonic = monotonic && speedup >= prev;
+        prev = speedup;
+        if (sp == 0.7) speedup_70 = speedup;
+        printf("  %8.0f%% %8llu %8llu %7.2fx %12.2f\n", 100 * sp, (unsigned long long)c0, (unsigned long long)c1,
+               speedup, (double)s1.dp_passes / (count * m * n));
+    }
+    suite_check("zero_skip_bit_identical_to_dense", exact, zs_pass, zs_fail);
+    suite_check("zero_skip_speedup_grows_with_sparsity", monotonic, zs_pass, zs_fail);
+    suite_check("zero_skip_speedup_at_70pct", speedup_70 > 1.5, zs_pass, zs_fail);
+
+    printf("  Zero-skip tests: %d passed, %d failed\n", zs_pass, zs_fail);
+}
+
+void test_energy_suite() {
+    printf("\n=== Suite: Energy model ===\n");
+
+    int en_pass = 0, en_fail = 0;
+
+    // Same batched GEMM at each input precision, dense and 70% sparse A
+    const int count = 8, m = 8, k = 8, n = 8;
+    struct Run { double pj; uint64_t macs, toggles; };
+    auto run = [&](uint8_t type, double sparsity, bool zero_skip) {
+        OTC_Config cfg;
+        cfg.type_ab = type; cfg.type_ab_sub = 0; cfg.type_cd = TYPE_FP32; cfg.zero_skip = zero_skip;
+        auto a = gen_rand(count * m * k, 1400), b = gen_rand(count * k * n, 1401);
+        unsigned rng = 1402;
+        for (auto& x : a) {
+            rng = rng * 1103515245u + 12345u;
+            if ((rng >> 16) % 1000 < sparsity * 1000) x = 0.0;
+        }
+        auto pa = test_pack_ab(a, type, 0), pb = test_pack_ab(b, type, 0);
+        std::vector<double> c(count * m * n, 0.0), d(count * m * n);
+        auto pc = test_pack_c_fp16(c);
+        int eb = FPConvert::elem_bits(type);
+        return with_device(cfg, [&](OTC_Device* dev) {
+            OTC_GemmReport rep;
+            otc_gemm_batched(dev, m, k, n, count, pa.data(), m * k * eb / 32, pb.data(), k * n * eb / 32, pc.data(), m * n / 2,
+                             d.data(), m * n, &rep);
+            OTC_Stats st = otc_stats(dev);
+            return Run{st.energy_pj, rep.macs, st.reg_toggles};
+        });
+    };
+    printf("  %-6s %9s %12s %12s %10s\n", "type", "sparsity", "pJ/GEMM", "pJ/MAC", "toggles");
+    const struct { const char* name; uint8_t type; } types[] = {{"fp4", TYPE_FP4}, {"fp8", TYPE_FP8}, {"fp16", TYPE_FP16}};
+    double per_mac[3] = {}, sparse_fp16 = 0;
+    for (int t = 0; t < 3; ++t) {
+        for (double sp : {0.0, 0.7}) {
+            Run r = run(types[t].type, sp, sp > 0);
+            printf("  %-6s %8.0f%% %12.1f %12.3f %10llu\n", types[t].name, 100 * sp, r.pj / count, r.pj / r.macs,
+                   (unsigned long long)r.toggles);
+            if (sp == 0) per_mac[t] = r.pj / r.macs;
+            else if (types[t].type == TYPE_FP16) sparse_fp16 = r.pj / r.macs;
+        }
+    }
+    suite_check("energy_per_mac_grows_with_precision", per_mac[0] > 0 && per_mac[0] < per_mac[1] && per_mac[1] < per_mac[2], en_pass, en_fail);
+    suite_check("energy_zero_skip_saves_energy", sparse_fp16 > 0 && sparse_fp16 < 0.8 * per_mac[2], en_pass, en_fail);
+    // sparsity without skipping still saves toggle energy on the zero lanes
+    suite_check("energy_sparse_operands_toggle_less", run(TYPE_FP16, 0.7, false).toggles < run(TYPE_FP16, 0.0, false).toggles, en_pass, en_fail);
+
+    // Per-batch energies add up to the device total
+    {
+        OTC_Config cfg;
+        cfg.type_ab = TYPE_FP16; cfg.type_ab_sub = 0; cfg.type_cd = TYPE_FP32;
+        auto pa = test_pack_ab(gen_rand(cfg.M * cfg.K, 1403), TYPE_FP16, 0);
+        auto pb = test_pack_ab(gen_rand(cfg.K * cfg.N, 1404), TYPE_FP16, 0);
+        auto pc = test_pack_c_fp16(std::vector<double>(cfg.M * cfg.N, 0.5));
+        with_device(cfg, [&](OTC_Device* dev) {
+            double sum = 0;
+            bool all_popped = true;
+            for (int i = 0; i < 3; ++i) {
+                otc_submit(dev, pa.data(), pa.size(), pb.data(), pb.size(), pc.data(), pc.size());
+                otc_run(dev);
+                BatchResult br;
+                all_popped = all_popped && dev->tc.pop_output_result(br);
+                sum += br.energy_pj;
+            }
+            double total = otc_stats(dev).energy_pj;
+            suite_check("energy_batches_sum_to_total", all_popped && total > 0 && fabs(sum - total) < 1e-6 * total, en_pass, en_fail);
+        });
+    }
+
+    printf("  Energy tests: %d passed, %d failed\n", en_pass, en_fail);
+}
+
+void test_staging_suite() {
+    printf("\n=== Suite: Double-buffered operand staging ===\n");
+
+    int st_pass = 0, st_fail = 0;
+
+    // Back-to-back 8x8x8 FP16 tiles through the batched GEMM driver
+    const int count = 16, m = 8, k = 8, n = 8;
+    auto pa = test_pack_ab(gen_rand(count * m * k, 1500), TYPE_FP16, 0);
+    auto pb = test_pack_ab(gen_rand(count * k * n, 1501), TYPE_FP16, 0);
+    auto pc = test_pack_c_fp16(gen_rand(count * m * n, 1502));
+    auto run = [&](int buffers, int bw, std::vector<double>& d, OTC_Stats& st) {
+        OTC_Config cfg;
+        cfg.type_ab = TYPE_FP16; cfg.type_ab_sub = 0; cfg.type_cd = TYPE_FP32;
+        cfg.staging_buffers = buffers; cfg.mem_bandwidth_bytes_per_cycle = bw;
+        d.assign(count * m * n, 0.0);
+        return with_device(cfg, [&](OTC_Device* dev) {
+            OTC_GemmReport rep;
+            otc_gemm_batched(dev, m, k, n, count, pa.data(), m * k / 2, pb.data(), k * n / 2, pc.data(), m * n / 2,
+                             d.data(), m * n, &rep);
+            st = otc_stats(dev);
+            return rep.cycles;
+        });
+    };
+    auto overlap = [](const OTC_Stats& st) { return st.staging_cycles ? (double)st.staging_overlap_cycles / st.staging_cycles : 0.0; };
+
+    std::vector<double> d0, d1, d2;
+    OTC_Stats s0, s1, s2;
+    uint64_t ideal = run(0, 32, d0, s0), single = run(1, 32, d1, s1), pingpong = run(2, 32, d2, s2);
+    printf("  %-10s %8s %10s %10s\n", "buffers", "cycles", "overlap", "stalls");
+    printf("  %-10s %8llu %10s %10s\n", "ideal", (unsigned long long)ideal, "-", "-");
+    printf("  %-10s %8llu %9.1f%% %10llu\n", "single", (unsigned long long)single, 100 * overlap(s1),
+           (unsigned long long)s1.staging_stall_cycles);
+    printf("  %-10s %8llu %9.1f%% %10llu\n", "ping-pong", (unsigned long long)pingpong, 100 * overlap(s2),
+           (unsigned long long)s2.staging_stall_cycles);
+    suite_check("staging_results_match_unstaged", d0 == d1 && d0 == d2, st_pass, st_fail);
+    suite_check("staging_load_costs_cycles", single > ideal && pingpong >= ideal, st_pass, st_fail);
+    suite_check("staging_pingpong_overlaps_load", overlap(s2) > 0.8 && overlap(s2) > overlap(s1) + 0.3, st_pass, st_fail);
+    suite_check("staging_pingpong_throughput_gain", (double)single / pingpong > 1.5, st_pass, st_fail);
+
+    // Narrower memory port: once loads outlast dispatch, ping-pong is load-bound
+    printf("  %-10s %8s %8s %8s\n", "bytes/cyc", "single", "pingpong", "gain");
+    bool gain_ok = true;
+    for (int bw : {64, 32, 16, 8}) {
+        uint64_t c1 = run(1, bw, d1, s1), c2 = run(2, bw, d2, s2);
+        printf("  %-10d %8llu %8llu %7.2fx\n", bw, (unsigned long long)c1, (unsigned long long)c2, (double)c1 / c2);
+        gain_ok = gain_ok && c2 < c1;
+    }
+    suite_check("staging_pingpong_faster_at_every_bandwidth", gain_ok, st_pass, st_fail);
+
+    printf("  Staging tests: %d passed, %d failed\n", st_pass, st_fail);
+}
+
 // ============================================================================
 // Main
 // ============================================================================
@@ -667,6 +1687,14 @@ int main() {
     test_with_bias_c_suite();
     test_edge_values_suite();
     test_precision_cross_suite();
+    test_reconfig_suite();
+    test_epilogue_suite();
+    test_grouped_gemm_suite();
+    test_conv2d_suite();
+    test_attention_suite();
+    test_zero_skip_suite();
+    test_energy_suite();
+    test_staging_suite();
 
     printf("\n╔══════════════════════════════════════════════════════════════╗\n");
     printf("║   SUMMARY                                                  ║\n");
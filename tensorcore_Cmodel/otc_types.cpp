@@ -17,11 +17,62 @@ int OTC_Config::pipeline_depth() const {
 }
 
 bool OTC_Config::validate() const {
-    return M > 0 && K > 0 && N > 0 && (K & (K - 1)) == 0 &&
+    return M > 0 && K > 0 && N > 0 && (K & (K - 1)) == 0 && dp_lanes >= 0 && dp_lanes <= K &&
            (type_ab == TYPE_FP4 || type_ab == TYPE_FP8 || type_ab == TYPE_FP16) &&
            (type_cd == TYPE_FP8 || type_cd == TYPE_FP16 || type_cd == TYPE_FP32) &&
            dispatch_width > 0 && output_fifo_depth > 0 &&
-           mem_bandwidth_bytes_per_cycle > 0;
+           mem_bandwidth_bytes_per_cycle > 0 && reconfig_latency >= 0 &&
+           staging_buffers >= 0 && staging_latency >= 0 && sfu_lanes > 0 && sfu_latency >= 0 &&
+           (!epilogue.enable ||
+            ((epilogue.bias.empty() || (int)epilogue.bias.size() == N) &&
+             (epilogue.scale.size() <= 1 || (int)epilogue.scale.size() == N) &&
+             epilogue.act >= ACT_NONE && epilogue.act <= ACT_CLAMP && epilogue.clamp_lo <= epilogue.clamp_hi &&
+             (epilogue.out_type == 0 || epilogue.out_type == TYPE_FP8 || epilogue.out_type == TYPE_FP4) &&
+             epilogue.latency >= 0 && epilogue.throughput > 0));
+}
+
+bool OTC_Config::same_datapath(const OTC_Config& o) const {
+    return M == o.M && K == o.K && N == o.N && type_ab == o.type_ab && type_ab_sub == o.type_ab_sub &&
+           type_cd == o.type_cd && type_cd_sub == o.type_cd_sub && transpose_b == o.transpose_b &&
+           dp_lanes == o.dp_lanes && zero_skip == o.zero_skip;
+}
+
+bool OTC_Config::same_config(const OTC_Config& o) const {
+    const OTC_Epilogue& e = epilogue;
+    const OTC_Epilogue& oe = o.epilogue;
+    const OTC_EnergyTable& t = energy;
+    const OTC_EnergyTable& ot = o.energy;
+    return same_datapath(o) && mul_latency == o.mul_latency && add_latency == o.add_latency &&
+           conv_latency == o.conv_latency && dispatch_width == o.dispatch_width &&
+           output_fifo_depth == o.output_fifo_depth && mem_bandwidth_bytes_per_cycle == o.mem_bandwidth_bytes_per_cycle &&
+           reconfig_latency == o.reconfig_latency && staging_buffers == o.staging_buffers &&
+           staging_latency == o.staging_latency && sfu_lanes == o.sfu_lanes && sfu_latency == o.sfu_latency &&
+           e.enable == oe.enable && e.bias == oe.bias && e.scale == oe.scale && e.act == oe.act &&
+           e.clamp_lo == oe.clamp_lo && e.clamp_hi == oe.clamp_hi && e.out_type == oe.out_type &&
+           e.out_sub == oe.out_sub && e.latency == oe.latency && e.throughput == oe.throughput &&
+           t.mul_fp9 == ot.mul_fp9 && t.add_fp13 == ot.add_fp13 && t.add_fp22 == ot.add_fp22 &&
+           t.conv_in == ot.conv_in && t.conv_fp13 == ot.conv_fp13 && t.conv_fp22 == ot.conv_fp22 &&
+           t.conv_out == ot.conv_out && t.operand_bit == ot.operand_bit && t.toggle == ot.toggle;
+}
+
+int OTC_ConvShape::out_h() const { return (h + 2 * pad_h - dil_h * (r - 1) - 1) / stride_h + 1; }
+int OTC_ConvShape::out_w() const { return (w + 2 * pad_w - dil_w * (s - 1) - 1) / stride_w + 1; }
+int OTC_ConvShape::gemm_m() const { return n * out_h() * out_w(); }
+int OTC_ConvShape::gemm_k() const { return c / groups * r * s; }
+
+bool OTC_ConvShape::validate() const {
+    return n > 0 && c > 0 && h > 0 && w > 0 && k > 0 && r > 0 && s > 0 &&
+           stride_h > 0 && stride_w > 0 && pad_h >= 0 && pad_w >= 0 && dil_h > 0 && dil_w > 0 &&
+           groups > 0 && c % groups == 0 && k % groups == 0 &&
+           h + 2 * pad_h >= dil_h * (r - 1) + 1 && w + 2 * pad_w >= dil_w * (s - 1) + 1;
+}
+
+int OTC_ConvShape::input_index(int img, int ch, int y, int x) const {
+    return nhwc ? ((img * h + y) * w + x) * c + ch : ((img * c + ch) * h + y) * w + x;
+}
+
+int OTC_ConvShape::output_index(int img, int ch, int y, int x) const {
+    return nhwc ? ((img * out_h() + y) * out_w() + x) * k + ch : ((img * k + ch) * out_h() + y) * out_w() + x;
 }
 
 void OTC_Stats::print(std::ostream& os) const {
@@ -39,6 +90,24 @@ void OTC_Stats::print(std::ostream& os) const {
     os << "Batches enqueued:         " << batches_enqueued << std::endl;
     os << "DRAM read bytes:          " << dram_read_bytes << std::endl;
     os << "DRAM write bytes:         " << dram_write_bytes << std::endl;
+    os << "Reconfigurations:         " << reconfigs << std::endl;
+    os << "Reconfig drain cycles:    " << reconfig_drain_cycles << std::endl;
+    os << "Reconfig stall cycles:    " << reconfig_cycles << std::endl;
+    os << "Config errors:            " << config_errors << std::endl;
+    os << "Epilogue ops:             " << epilogue_ops << std::endl;
+    os << "Epilogue active cycles:   " << epilogue_active_cycles << std::endl;
+    os << "Epilogue stall cycles:    " << epilogue_stall_cycles << std::endl;
+    os << "Conv tiles:               " << conv_tiles << std::endl;
+    os << "Conv input bytes:         " << conv_input_bytes << std::endl;
+    os << "Conv filter bytes:        " << conv_filter_bytes << std::endl;
+    os << "SFU ops:                  " << sfu_ops << std::endl;
+    os << "SFU busy cycles:          " << sfu_busy_cycles << std::endl;
+    os << "Zero-skipped products:    " << zero_skipped_products << std::endl;
+    os << "DP multiplier passes:     " << dp_passes << std::endl;
+    os << "Operand bits fetched:     " << operand_bits << std::endl;
+    os << "Register bit toggles:     " << reg_toggles << std::endl;
+    os << "Operand staging cycles:   " << staging_cycles << std::endl;
+    os << "Operand stall cycles:     " << staging_stall_cycles << std::endl;
 
     double util = total_cycles ? 100.0 * busy_cycles / total_cycles : 0;
     double throughput = total_cycles ? (double)matrices_done / (double)total_cycles : 0;
@@ -54,6 +123,11 @@ void OTC_Stats::print(std::ostream& os) const {
     os << "Avg BW (bytes/cycle):     " << std::fixed << std::setprecision(2) << avg_bw << std::endl;
     os << "BW utilization:           " << std::fixed << std::setprecision(2) << bw_util << "%" << std::endl;
     os << "Compute util:             " << std::fixed << std::setprecision(2) << dp_util << "%" << std::endl;
+    os << "Load/compute overlap:     " << std::fixed << std::setprecision(2)
+       << (staging_cycles ? 100.0 * staging_overlap_cycles / staging_cycles : 0.0) << "%" << std::endl;
+    os << "Energy (pJ):              " << std::fixed << std::setprecision(1) << energy_pj << std::endl;
+    os << "Toggle energy (pJ):       " << std::fixed << std::setprecision(1) << toggle_energy_pj << std::endl;
+    os << "Energy per MAC (pJ):      " << std::fixed << std::setprecision(4) << (macs ? energy_pj / macs : 0.0) << std::endl;
 }
 
 void TraceLog::init(int level, bool to_file) {
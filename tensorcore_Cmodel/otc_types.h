@@ -21,6 +21,40 @@
 #define SUB_FP8E5M2 0
 #define SUB_FP8E4M3 1
 
+#define ACT_NONE 0
+#define ACT_RELU 1
+#define ACT_GELU 2   // x * sigmoid(1.702x)
+#define ACT_CLAMP 3
+
+// Fused epilogue between the DP array and the output FIFO, applied on the
+// FP22 accumulator value in order: bias, activation, scale, requantization.
+struct OTC_Epilogue {
+    bool enable = false;
+    std::vector<double> bias;    // per output column, empty for none
+    std::vector<double> scale;   // 1 entry per tensor or N per column, empty for none
+    int act = ACT_NONE;
+    double clamp_lo = -6.0, clamp_hi = 6.0;
+    uint8_t out_type = 0;        // 0 keeps type_cd, TYPE_FP8 or TYPE_FP4 requantizes
+    uint8_t out_sub = SUB_FP8E4M3;
+    int latency = 3;
+    int throughput = 8;          // elements per cycle
+};
+
+// Activity-based energy model, in pJ. Operations cost a fixed energy each;
+// the data-dependent part is the bits fetched into the operand registers and
+// the register bits that toggle when the DP pipeline latches new values.
+struct OTC_EnergyTable {
+    double mul_fp9 = 0.20;
+    double add_fp13 = 0.12;
+    double add_fp22 = 0.25;
+    double conv_in = 0.02;      // A/B element to FP9
+    double conv_fp13 = 0.01;    // FP9 product to FP13
+    double conv_fp22 = 0.01;    // FP9 tree sum to FP22
+    double conv_out = 0.03;     // FP22 to type_cd
+    double operand_bit = 0.05;  // per A/B bit read from the operand buffers
+    double toggle = 0.004;      // per register bit that changes
+};
+
 struct OTC_Config {
     int M = 8, K = 8, N = 8;
     uint8_t type_ab = TYPE_FP8;
@@ -28,6 +62,8 @@ struct OTC_Config {
     uint8_t type_cd = TYPE_FP32;
     uint8_t type_cd_sub = SUB_FP8E5M2;
     bool transpose_b = false;
+    int dp_lanes = 0;          // multipliers per DP unit, 0 = K (one pass per dot product)
+    bool zero_skip = false;    // skip products with a zero operand, see DotProductUnit::push
 
     int mul_latency = 2;
     int add_latency = 2;
@@ -35,6 +71,13 @@ struct OTC_Config {
     int dispatch_width = 8;
     int output_fifo_depth = 8;
     int mem_bandwidth_bytes_per_cycle = 32;
+    int reconfig_latency = 4;  // cycles to reload config registers once busy drops
+    int staging_buffers = 0;   // operand buffers: 0 = operands ready at once, 1 = single, 2 = ping-pong
+    int staging_latency = 2;   // cycles to convert a staged tile to FP9/FP22 after its last byte lands
+    int sfu_lanes = 8;         // vector/SFU elementwise ops per cycle
+    int sfu_latency = 4;
+    OTC_Epilogue epilogue;
+    OTC_EnergyTable energy;
 
     int debug_level = 0;
     bool trace_en = false;
@@ -43,6 +86,32 @@ struct OTC_Config {
     int total_dp() const;
     int pipeline_depth() const;
     bool validate() const;
+    // true when switching between the two configs needs no reconfiguration
+    bool same_datapath(const OTC_Config& o) const;
+    // true when every config register matches, the datapath included
+    bool same_config(const OTC_Config& o) const;
+};
+
+// conv2d lowered to an implicit GEMM: M = n * out_h * out_w output pixels,
+// K = (c / groups) * r * s, N = k / groups output channels per group.
+// Filters are KCRS for NCHW input and KRSC for NHWC input, so the GEMM K
+// index walks (c, r, s) or (r, s, c) respectively.
+struct OTC_ConvShape {
+    int n = 1, c = 1, h = 1, w = 1;  // input
+    int k = 1, r = 1, s = 1;         // filters
+    int stride_h = 1, stride_w = 1;
+    int pad_h = 0, pad_w = 0;
+    int dil_h = 1, dil_w = 1;
+    int groups = 1;
+    bool nhwc = false;               // layout of input and output
+
+    int out_h() const;
+    int out_w() const;
+    int gemm_m() const;
+    int gemm_k() const;
+    bool validate() const;
+    int input_index(int img, int ch, int y, int x) const;
+    int output_index(int img, int ch, int y, int x) const;
 };
 
 struct OTC_Stats {
@@ -65,6 +134,28 @@ struct OTC_Stats {
     uint64_t batches_enqueued = 0;
     uint64_t dp_capacity_units = 0;
     uint64_t peak_bw_bytes_per_cycle = 0;
+    uint64_t reconfigs = 0;
+    uint64_t reconfig_drain_cycles = 0;
+    uint64_t reconfig_cycles = 0;
+    uint64_t config_errors = 0;
+    uint64_t epilogue_ops = 0;
+    uint64_t epilogue_active_cycles = 0;
+    uint64_t epilogue_stall_cycles = 0;
+    uint64_t conv_tiles = 0;
+    uint64_t conv_input_bytes = 0;
+    uint64_t conv_filter_bytes = 0;
+    uint64_t sfu_ops = 0;
+    uint64_t sfu_busy_cycles = 0;
+    uint64_t zero_skipped_products = 0;
+    uint64_t dp_passes = 0;
+    uint64_t macs = 0;
+    uint64_t operand_bits = 0;
+    uint64_t reg_toggles = 0;
+    double energy_pj = 0;
+    double toggle_energy_pj = 0;
+    uint64_t staging_cycles = 0;          // an operand tile is loading or converting
+    uint64_t staging_overlap_cycles = 0;  // ... while the DP array computes
+    uint64_t staging_stall_cycles = 0;    // DP array idle, waiting for a staged tile
 
     void print(std::ostream& os) const;
 };
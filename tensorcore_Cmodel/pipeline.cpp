@@ -19,36 +19,101 @@ inline double quantize_output_f64(uint32_t fp22, const OTC_Config& cfg) {
     return SoftFloat::fp22_to_f64(fp22);
 }
 
+inline uint16_t ab_to_fp9(uint32_t code, const OTC_Config& cfg) {
+    if (cfg.type_ab == TYPE_FP4) return FPEmu::fp4_to_fp9(code);
+    if (cfg.type_ab == TYPE_FP8) return cfg.type_ab_sub == SUB_FP8E4M3 ? FPEmu::fp8e4m3_to_fp9(code) : FPEmu::fp8e5m2_to_fp9(code);
+    return FPEmu::fp16_to_fp9(code);
+}
+
+inline uint32_t read_elem(const uint32_t* words, int idx, int eb) {
+    int eperw = 32 / eb;
+    return (words[idx / eperw] >> ((idx % eperw) * eb)) & ((1u << eb) - 1);
+}
+
+uint32_t epilogue_apply(uint32_t v, int col, const OTC_Epilogue& epi) {
+    if (!epi.bias.empty()) v = FPEmu::fp22_add(v, SoftFloat::f64_to_fp22(epi.bias[col]));
+    double x = SoftFloat::fp22_to_f64(v);
+    if (epi.act == ACT_RELU && ((v >> 21) & 1) && !std::isnan(x)) v = 0;
+    else if (epi.act == ACT_GELU) v = SoftFloat::f64_to_fp22(x / (1.0 + std::exp(-1.702 * x)));
+    else if (epi.act == ACT_CLAMP && x < epi.clamp_lo) v = SoftFloat::f64_to_fp22(epi.clamp_lo);
+    else if (epi.act == ACT_CLAMP && x > epi.clamp_hi) v = SoftFloat::f64_to_fp22(epi.clamp_hi);
+    if (!epi.scale.empty()) v = FPEmu::fp22_mul(v, SoftFloat::f64_to_fp22(epi.scale.size() == 1 ? epi.scale[0] : epi.scale[col]));
+    return v;
+}
+
 }  // namespace
 
-void DotProductUnit::init(const OTC_Config* cfg) { cfg_ = cfg; latency_total_ = 6; }
-void DotProductUnit::reset() { pipe_q_.clear(); output_valid_ = false; }
-bool DotProductUnit::can_accept() const { return (int)pipe_q_.size() < 8; }
+void DotProductUnit::init(const OTC_Config* cfg) {
+    cfg_ = cfg; latency_total_ = 6;
+    op_a_reg_.assign(cfg_->K, 0); op_b_reg_.assign(cfg_->K, 0); prod_reg_.assign(cfg_->K, 0); tree_reg_.assign(cfg_->K, 0); acc_reg_ = 0;
+}
+void DotProductUnit::reset() {
+    pipe_q_.clear(); output_valid_ = false; mul_busy_ = 0;
+    std::fill(op_a_reg_.begin(), op_a_reg_.end(), 0); std::fill(op_b_reg_.begin(), op_b_reg_.end(), 0);
+    std::fill(prod_reg_.begin(), prod_reg_.end(), 0); std::fill(tree_reg_.begin(), tree_reg_.end(), 0); acc_reg_ = 0;
+}
+bool DotProductUnit::can_accept() const { return (int)pipe_q_.size() < 8 && mul_busy_ == 0; }
 
+// With dp_lanes < K the K products go through the multipliers in several
+// passes. Zero skipping drops lanes whose product is exactly +-0 (a zero
+// operand against a finite one; 0 x Inf still multiplies to NaN) before the
+// multipliers, so only the remaining products take passes. The skipped
+// lane's signed zero still enters its own adder-tree slot, which keeps the
+// tree order and the result bit-identical to the dense path.
+// Energy: every operation charges its table entry and every latch charges
+// the bits that toggle in its register. Skipped lanes keep their operand
+// registers (operand isolation), so sparsity saves both.
 void DotProductUnit::push(const DPInput& in, OTC_Stats& stats) {
+    const OTC_EnergyTable& et = cfg_->energy;
+    uint64_t toggles = 0;
+    auto latch = [&](uint32_t& reg, uint32_t v) { toggles += __builtin_popcount(reg ^ v); reg = v; };
     std::vector<uint16_t> tree_vals(cfg_->K);
+    int products = 0;
     for (int k = 0; k < cfg_->K; ++k) {
-        uint16_t p9 = FPEmu::fp9_mul(in.a_fp9[k], in.b_fp9[k]);
+        uint16_t a = in.a_fp9[k], b = in.b_fp9[k], p9;
+        bool a_zero = (a & 0xFF) == 0, b_zero = (b & 0xFF) == 0;
+        bool a_special = ((a >> 3) & 0x1F) == 0x1F, b_special = ((b >> 3) & 0x1F) == 0x1F;
+        if (cfg_->zero_skip && ((a_zero && !b_special) || (b_zero && !a_special))) {
+            p9 = (a ^ b) & 0x100;
+            stats.zero_skipped_products++;
+        } else {
+            latch(op_a_reg_[k], a); latch(op_b_reg_[k], b);
+            p9 = FPEmu::fp9_mul(a, b);
+            stats.mul_ops++;
+            products++;
+        }
         uint16_t p13 = SoftFloat::f64_to_fp13(SoftFloat::fp9_to_f64(p9));
         tree_vals[k] = p13;
-        stats.mul_ops++;
+        latch(prod_reg_[k], p13);
     }
-    int w = cfg_->K;
+    int w = cfg_->K, node = 0;
     while (w > 1) {
         for (int i = 0; i < w / 2; ++i) {
             tree_vals[i] = FPEmu::fp13_add(tree_vals[2 * i], tree_vals[2 * i + 1]);
+            latch(tree_reg_[node++], tree_vals[i]);
             stats.add_ops++;
         }
         w >>= 1;
     }
     uint16_t dot9 = FPEmu::fp13_to_fp9(tree_vals[0]);
     uint32_t out22 = FPEmu::fp22_add(FPEmu::fp9_to_fp22(dot9), in.c_fp22);
+    latch(acc_reg_, out22);
     stats.add_ops++;
-    pipe_q_.push_back({{out22, in.row, in.col}, latency_total_, true});
+    int lanes = cfg_->dp_lanes ? cfg_->dp_lanes : cfg_->K;
+    int passes = std::max(1, (products + lanes - 1) / lanes);
+    mul_busy_ = passes;
+    stats.dp_passes += passes;
+    stats.macs += cfg_->K;
+    stats.reg_toggles += toggles;
+    stats.toggle_energy_pj += toggles * et.toggle;
+    stats.energy_pj += products * (et.mul_fp9 + et.conv_fp13) + node * et.add_fp13 + et.conv_fp22 + et.add_fp22 +
+                       toggles * et.toggle;
+    pipe_q_.push_back({{out22, in.row, in.col, in.batch_id}, latency_total_ + passes - 1, true});
 }
 
 void DotProductUnit::tick() {
     output_valid_ = false;
+    if (mul_busy_ > 0) mul_busy_--;
     for (auto it = pipe_q_.begin(); it != pipe_q_.end();) {
         it->latency_countdown--;
         if (it->latency_countdown <= 0) { output_data_ = it->result; output_valid_ = true; it = pipe_q_.erase(it); }
@@ -71,38 +136,178 @@ void TensorCoreUnit::init(const OTC_Config& cfg) {
 void TensorCoreUnit::reset() {
     state_ = IDLE; cycle_ = 0; stats_ = {}; stats_.dp_capacity_units = cfg_.total_dp();
     stats_.peak_bw_bytes_per_cycle = cfg_.mem_bandwidth_bytes_per_cycle;
-    output_fifo_.clear(); active_batch_ = {}; next_batch_id_ = 0; dp_busy_acc_cycles_ = 0;
+    output_fifo_.clear(); active_batch_ = {}; draining_.clear(); next_batch_id_ = 0; dp_busy_acc_cycles_ = 0; sfu_busy_until_ = 0;
+    staged_.clear(); load_busy_until_ = 0; read_bytes_mark_ = 0;
+    config_error_ = false; reconfig_pending_ = false; reconfig_datapath_ = false; reconfig_countdown_ = 0;
     for (auto& dp : dp_units_) dp.reset();
     std::fill(last_output_d_.begin(), last_output_d_.end(), 0.0);
 }
 
-bool TensorCoreUnit::try_start_batch(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, const std::vector<uint32_t>& c) {
-    if (active_batch_.batch_valid) return false;
-    active_batch_.batch_valid = true; active_batch_.batch_id = next_batch_id_++;
-    active_batch_.a_fp9.resize(cfg_.M * cfg_.K); active_batch_.b_fp9.resize(cfg_.K * cfg_.N);
-    active_batch_.c_fp22.resize(cfg_.M * cfg_.N, 0); active_batch_.d_f64.assign(cfg_.M * cfg_.N, 0.0);
-    active_batch_.dispatch_ptr = 0; active_batch_.results_collected = 0; active_batch_.start_cycle = cycle_;
+bool TensorCoreUnit::reconfigure(const OTC_Config& cfg) {
+    if (!cfg.validate()) { config_error_ = true; stats_.config_errors++; return false; }
+    config_error_ = false;
+    // config_registers.v takes new values only while busy is low: accepted
+    // work drains under the old config, whether or not the datapath changes
+    bool datapath = !cfg.same_datapath(cfg_);
+    if (!datapath && !reconfig_pending_ && !has_pending_work()) { cfg_ = cfg; return true; }
+    if (datapath && !(reconfig_pending_ && reconfig_datapath_)) {
+        reconfig_countdown_ = cfg.reconfig_latency;
+        DT.log(1, "reconfig requested: type_ab=0x%x type_cd=0x%x %dx%dx%d", cfg.type_ab, cfg.type_cd, cfg.M, cfg.K, cfg.N);
+    }
+    pending_cfg_ = cfg; reconfig_pending_ = true; reconfig_datapath_ = datapath;
+    if (has_pending_work()) start();
+    else if (!datapath || reconfig_countdown_ == 0) apply_config();
+    return true;
+}
+
+// A datapath change rebuilds the DP array and counts as one reconfiguration
+// however many requests were merged into it; anything else only updates cfg_.
+void TensorCoreUnit::apply_config() {
+    bool datapath = reconfig_datapath_;
+    cfg_ = pending_cfg_; reconfig_pending_ = false; reconfig_datapath_ = false;
+    stats_.peak_bw_bytes_per_cycle = cfg_.mem_bandwidth_bytes_per_cycle;
+    if (!datapath) return;
+    stats_.reconfigs++;
+    dp_units_.assign(cfg_.M * cfg_.N, DotProductUnit());
+    for (auto& dp : dp_units_) dp.init(&cfg_);
+    last_output_d_.assign(cfg_.M * cfg_.N, 0.0);
+    stats_.dp_capacity_units = cfg_.total_dp();
+    DT.log(1, "reconfig applied");
+}
+
+bool TensorCoreUnit::is_reconfiguring() const { return reconfig_pending_; }
+
+bool TensorCoreUnit::try_start_batch(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, const std::vector<uint32_t>& c,
+                                     bool partial) {
+    if (!can_accept_job()) return false;
+    std::vector<uint32_t> c_fp22(cfg_.M * cfg_.N);
+    for (int i = 0; i < cfg_.M * cfg_.N; ++i) {
+        int wi = i / 2, ei = i % 2; uint16_t h = ((wi < (int)c.size() ? c[wi] : 0) >> (ei * 16)) & 0xFFFF;
+        c_fp22[i] = SoftFloat::f64_to_fp22(SoftFloat::fp16_to_f64(h));
+    }
+    stats_.dram_read_bytes += (uint64_t)c.size() * 4;
+    return enqueue_job_acc(a, b, std::move(c_fp22), partial, false);
+}
+
+// A/B packed in type_ab, C already on chip as FP22 (a previous partial or a
+// rescaled accumulator). a_on_chip skips the A fetch for operands produced or
+// kept on chip.
+bool TensorCoreUnit::enqueue_job_acc(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, std::vector<uint32_t> c_fp22,
+                                     bool partial, bool a_on_chip) {
+    if (!can_accept_job()) return false;
+    std::vector<uint16_t> a_fp9(cfg_.M * cfg_.K), b_fp9(cfg_.K * cfg_.N);
     int eb = FPConvert::elem_bits(cfg_.type_ab), eperw = 32 / eb;
     for (int i = 0; i < cfg_.M * cfg_.K; ++i) {
         int wi = i / eperw, ei = i % eperw; uint32_t w = wi < (int)a.size() ? a[wi] : 0;
-        if (cfg_.type_ab == TYPE_FP4) active_batch_.a_fp9[i] = FPEmu::fp4_to_fp9((w >> (ei * 4)) & 0xF);
-        else if (cfg_.type_ab == TYPE_FP8) { uint8_t x = (w >> (ei * 8)) & 0xFF; active_batch_.a_fp9[i] = (cfg_.type_ab_sub == SUB_FP8E4M3) ? FPEmu::fp8e4m3_to_fp9(x) : FPEmu::fp8e5m2_to_fp9(x); }
-        else active_batch_.a_fp9[i] = FPEmu::fp16_to_fp9((w >> (ei * 16)) & 0xFFFF);
+        a_fp9[i] = ab_to_fp9((w >> (ei * eb)) & ((1u << eb) - 1), cfg_);
     }
     for (int i = 0; i < cfg_.K * cfg_.N; ++i) {
         int wi = i / eperw, ei = i % eperw; uint32_t w = wi < (int)b.size() ? b[wi] : 0;
-        if (cfg_.type_ab == TYPE_FP4) active_batch_.b_fp9[i] = FPEmu::fp4_to_fp9((w >> (ei * 4)) & 0xF);
-        else if (cfg_.type_ab == TYPE_FP8) { uint8_t x = (w >> (ei * 8)) & 0xFF; active_batch_.b_fp9[i] = (cfg_.type_ab_sub == SUB_FP8E4M3) ? FPEmu::fp8e4m3_to_fp9(x) : FPEmu::fp8e5m2_to_fp9(x); }
-        else active_batch_.b_fp9[i] = FPEmu::fp16_to_fp9((w >> (ei * 16)) & 0xFFFF);
-    }
-    for (int i = 0; i < cfg_.M * cfg_.N; ++i) {
-        int wi = i / 2, ei = i % 2; uint16_t h = ((wi < (int)c.size() ? c[wi] : 0) >> (ei * 16)) & 0xFFFF;
-        active_batch_.c_fp22[i] = SoftFloat::f64_to_fp22(SoftFloat::fp16_to_f64(h));
+        b_fp9[i] = ab_to_fp9((w >> (ei * eb)) & ((1u << eb) - 1), cfg_);
     }
-    stats_.dram_read_bytes += (uint64_t)(a.size() + b.size() + c.size()) * 4; stats_.batches_enqueued++;
+    c_fp22.resize(cfg_.M * cfg_.N, 0);
+    stats_.dram_read_bytes += (uint64_t)((a_on_chip ? 0 : a.size()) + b.size()) * 4;
+    return start_batch(std::move(a_fp9), std::move(b_fp9), std::move(c_fp22), partial);
+}
+
+// Vector/SFU lanes beside the DP array: `ops` elementwise operations
+// (exponentials, max/sum reductions, rescaling) issue in order at sfu_lanes
+// per cycle and complete sfu_latency cycles after the last one starts.
+uint64_t TensorCoreUnit::sfu_issue(int ops) {
+    uint64_t start = std::max(cycle_, sfu_busy_until_), busy = (ops + cfg_.sfu_lanes - 1) / cfg_.sfu_lanes;
+    sfu_busy_until_ = start + busy;
+    stats_.sfu_ops += ops; stats_.sfu_busy_cycles += busy;
+    return sfu_busy_until_ + cfg_.sfu_latency;
+}
+
+// With staging_buffers > 0 the batch's DRAM reads (everything fetched since
+// the previous batch was accepted) stream into its staging buffer over the
+// memory port, after any earlier load, then pass the FP9/FP22 converters for
+// staging_latency cycles before the batch may dispatch.
+bool TensorCoreUnit::start_batch(std::vector<uint16_t> a_fp9, std::vector<uint16_t> b_fp9, std::vector<uint32_t> c_fp22, bool partial) {
+    if (!can_accept_job()) return false;
+    ActiveBatch nb;
+    nb.batch_valid = true; nb.batch_id = next_batch_id_++; nb.partial = partial;
+    nb.a_fp9 = std::move(a_fp9); nb.b_fp9 = std::move(b_fp9); nb.c_fp22 = std::move(c_fp22);
+    nb.d_f64.assign(cfg_.M * cfg_.N, 0.0); nb.d_fp22.assign(cfg_.M * cfg_.N, 0);
+    nb.dispatch_ptr = 0; nb.results_collected = 0; nb.start_cycle = cycle_;
+    nb.epi = cfg_.epilogue;
+    if (partial) nb.epi.enable = false;  // FP22 partial sums go straight back as C
+    if (nb.epi.enable && nb.epi.out_type != 0)
+        nb.d_packed.assign((cfg_.M * cfg_.N * FPConvert::elem_bits(nb.epi.out_type) + 31) / 32, 0);
+    // A/B leave the operand buffers in type_ab and are converted to FP9
+    int elems = cfg_.M * cfg_.K + cfg_.K * cfg_.N, bits = elems * FPConvert::elem_bits(cfg_.type_ab);
+    nb.energy_pj = bits * cfg_.energy.operand_bit + elems * cfg_.energy.conv_in;
+    stats_.operand_bits += bits; stats_.energy_pj += nb.energy_pj;
+    stats_.batches_enqueued++;
+    uint64_t bytes = stats_.dram_read_bytes - read_bytes_mark_, bw = cfg_.mem_bandwidth_bytes_per_cycle;
+    read_bytes_mark_ = stats_.dram_read_bytes;
+    if (cfg_.staging_buffers == 0) { active_batch_ = std::move(nb); return true; }
+    nb.load_start = std::max(cycle_, load_busy_until_);
+    load_busy_until_ = nb.load_start + (bytes + bw - 1) / bw;
+    nb.ready_cycle = load_busy_until_ + cfg_.staging_latency;
+    staged_.push_back(std::move(nb));
     return true;
 }
 
+// The oldest staged batch becomes active once its operands are converted and
+// the previous batch has left the dispatcher. Returns whether a tile is
+// loading or converting this cycle.
+bool TensorCoreUnit::stage_step() {
+    bool staging = false;
+    for (const auto& b : staged_) staging = staging || (b.load_start < cycle_ && cycle_ <= b.ready_cycle);
+    if (staging) stats_.staging_cycles++;
+    if (!active_batch_.batch_valid && !staged_.empty() && staged_.front().ready_cycle < cycle_) {
+        active_batch_ = std::move(staged_.front()); staged_.pop_front();
+    }
+    return staging;
+}
+
+// Implicit-GEMM feed: the A tile is gathered straight from the input tensor,
+// rows are output pixels m0.., columns are reduction indices k0.. of `group`.
+// Taps that fall into the padding read as zero without a memory access. DRAM
+// traffic is the tile's footprint: every input element it touches is fetched
+// once, however many overlapping windows reuse it.
+bool TensorCoreUnit::enqueue_conv_tile(const OTC_ConvShape& cs, const uint32_t* input, const uint32_t* filter, int group,
+                                       int m0, int k0, int n0, std::vector<uint32_t> c_fp22, bool partial) {
+    if (!can_accept_job()) return false;
+    int eb = FPConvert::elem_bits(cfg_.type_ab), cg = cs.c / cs.groups, kg = cs.k / cs.groups;
+    int oh = cs.out_h(), ow = cs.out_w(), gm = cs.gemm_m(), gk = cs.gemm_k();
+    std::vector<uint16_t> a_fp9(cfg_.M * cfg_.K, 0), b_fp9(cfg_.K * cfg_.N, 0);
+    std::vector<int> touched;
+    auto tap = [&](int kk, int& ch, int& fr, int& fs) {
+        if (cs.nhwc) { ch = kk % cg; fs = kk / cg % cs.s; fr = kk / (cg * cs.s); }
+        else { fs = kk % cs.s; fr = kk / cs.s % cs.r; ch = kk / (cs.r * cs.s); }
+    };
+    for (int row = 0; row < cfg_.M && m0 + row < gm; ++row) {
+        int m = m0 + row, img = m / (oh * ow), y = m / ow % oh, x = m % ow;
+        for (int col = 0; col < cfg_.K && k0 + col < gk; ++col) {
+            int ch, fr, fs; tap(k0 + col, ch, fr, fs);
+            int iy = y * cs.stride_h - cs.pad_h + fr * cs.dil_h, ix = x * cs.stride_w - cs.pad_w + fs * cs.dil_w;
+            if (iy < 0 || iy >= cs.h || ix < 0 || ix >= cs.w) continue;
+            int idx = cs.input_index(img, group * cg + ch, iy, ix);
+            a_fp9[row * cfg_.K + col] = ab_to_fp9(read_elem(input, idx, eb), cfg_);
+            touched.push_back(idx);
+        }
+    }
+    std::sort(touched.begin(), touched.end());
+    uint64_t in_elems = std::unique(touched.begin(), touched.end()) - touched.begin(), f_elems = 0;
+    for (int col = 0; col < cfg_.N && n0 + col < kg; ++col) {
+        int oc = group * kg + n0 + col;
+        for (int kk = 0; kk < cfg_.K && k0 + kk < gk; ++kk) {
+            int ch, fr, fs; tap(k0 + kk, ch, fr, fs);
+            int idx = cs.nhwc ? ((oc * cs.r + fr) * cs.s + fs) * cg + ch : ((oc * cg + ch) * cs.r + fr) * cs.s + fs;
+            b_fp9[cfg_.transpose_b ? col * cfg_.K + kk : kk * cfg_.N + col] = ab_to_fp9(read_elem(filter, idx, eb), cfg_);
+            f_elems++;
+        }
+    }
+    c_fp22.resize(cfg_.M * cfg_.N, 0);
+    uint64_t in_bytes = (in_elems * eb + 7) / 8, f_bytes = (f_elems * eb + 7) / 8;
+    stats_.conv_tiles++; stats_.conv_input_bytes += in_bytes; stats_.conv_filter_bytes += f_bytes;
+    stats_.dram_read_bytes += in_bytes + f_bytes;
+    return start_batch(std::move(a_fp9), std::move(b_fp9), std::move(c_fp22), partial);
+}
+
 bool TensorCoreUnit::enqueue_job(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, const std::vector<uint32_t>& c) { return try_start_batch(a, b, c); }
 void TensorCoreUnit::load(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, const std::vector<uint32_t>& c) { (void)enqueue_job(a,b,c); }
 void TensorCoreUnit::start() { state_ = RUNNING; }
@@ -112,47 +317,121 @@ void TensorCoreUnit::dispatch_some(OTC_Stats& stats) {
     int budget = cfg_.dispatch_width;
     while (budget-- > 0 && active_batch_.dispatch_ptr < cfg_.total_dp()) {
         int dp_index = active_batch_.dispatch_ptr, row = dp_index / cfg_.N, col = dp_index % cfg_.N;
-        DPInput in; in.a_fp9.resize(cfg_.K); in.b_fp9.resize(cfg_.K); in.row = row; in.col = col;
+        DPInput in; in.a_fp9.resize(cfg_.K); in.b_fp9.resize(cfg_.K); in.row = row; in.col = col; in.batch_id = active_batch_.batch_id;
         for (int k = 0; k < cfg_.K; ++k) {
             in.a_fp9[k] = active_batch_.a_fp9[row * cfg_.K + k];
             in.b_fp9[k] = cfg_.transpose_b ? active_batch_.b_fp9[col * cfg_.K + k] : active_batch_.b_fp9[k * cfg_.N + col];
         }
         in.c_fp22 = active_batch_.c_fp22[row * cfg_.N + col];
-        if (dp_units_[dp_index].can_accept()) { dp_units_[dp_index].push(in, stats); active_batch_.dispatch_ptr++; }
+        if (dp_units_[dp_index].can_accept()) {
+            double e0 = stats.energy_pj;
+            dp_units_[dp_index].push(in, stats); active_batch_.dispatch_ptr++;
+            active_batch_.energy_pj += stats.energy_pj - e0;
+        }
     }
     stats_.dp_issue_slots += cfg_.dispatch_width;
+    if (active_batch_.dispatch_ptr >= cfg_.total_dp()) { draining_.push_back(std::move(active_batch_)); active_batch_ = {}; }
+}
+
+TensorCoreUnit::ActiveBatch* TensorCoreUnit::find_batch(int batch_id) {
+    if (active_batch_.batch_valid && active_batch_.batch_id == batch_id) return &active_batch_;
+    for (auto& b : draining_) if (b.batch_id == batch_id) return &b;
+    return nullptr;
 }
 
 void TensorCoreUnit::collect_results() {
     int busy = 0;
     for (auto& dp : dp_units_) {
         dp.tick();
-        if (dp.output_valid_ && active_batch_.batch_valid) {
+        ActiveBatch* b = dp.output_valid_ ? find_batch(dp.output_data_.batch_id) : nullptr;
+        if (b) {
             int out_idx = dp.output_data_.row * cfg_.N + dp.output_data_.col;
-            active_batch_.d_f64[out_idx] = quantize_output_f64(dp.output_data_.value_fp22, cfg_);
-            active_batch_.results_collected++;
+            b->d_fp22[out_idx] = dp.output_data_.value_fp22;
+            b->energy_pj += cfg_.energy.conv_out; stats_.energy_pj += cfg_.energy.conv_out;
+            if (b->epi.enable) b->epi_in.push_back(dp.output_data_);
+            else { b->d_f64[out_idx] = quantize_output_f64(dp.output_data_.value_fp22, cfg_); b->results_collected++; }
         }
         if (dp.busy()) busy++;
     }
     dp_busy_acc_cycles_ += busy;
-    if (active_batch_.batch_valid && active_batch_.results_collected >= cfg_.total_dp()) {
-        BatchResult br{active_batch_.batch_id, active_batch_.d_f64, active_batch_.start_cycle, cycle_};
-        if (push_output_result(br)) { stats_.matrices_done++; last_output_d_ = br.d_f64; active_batch_ = {}; }
+    int budget = cfg_.epilogue.throughput, waiting = 0;
+    for (auto& b : draining_) { if (b.epi.enable) { budget = b.epi.throughput; break; } }
+    int epi_ops = budget;
+    for (auto& b : draining_) { if (b.epi.enable) { epilogue_step(b, budget); waiting += !b.epi_in.empty(); } }
+    if (active_batch_.batch_valid && active_batch_.epi.enable) { epilogue_step(active_batch_, budget); waiting += !active_batch_.epi_in.empty(); }
+    epi_ops -= budget;
+    stats_.epilogue_ops += epi_ops;
+    if (epi_ops) stats_.epilogue_active_cycles++;
+    if (waiting) stats_.epilogue_stall_cycles++;
+    // batches retire to the output FIFO in submission order
+    while (!draining_.empty() && draining_.front().results_collected >= cfg_.total_dp()) {
+        auto& b = draining_.front();
+        BatchResult br{b.batch_id, b.d_f64, b.d_packed, b.d_fp22, b.partial, b.start_cycle, cycle_, b.energy_pj};
+        if (!push_output_result(br)) break;
+        stats_.matrices_done++; last_output_d_ = br.d_f64; draining_.pop_front();
+    }
+}
+
+// Epilogue lanes take `throughput` results per cycle from the DP array and
+// retire them `latency` cycles later; results beyond that wait in epi_in.
+void TensorCoreUnit::epilogue_step(ActiveBatch& b, int& budget) {
+    for (; budget > 0 && !b.epi_in.empty(); --budget) {
+        const DPResult& r = b.epi_in.front();
+        b.epi_pipe.push_back({r.row * cfg_.N + r.col, epilogue_apply(r.value_fp22, r.col, b.epi), cycle_ + b.epi.latency});
+        b.epi_in.pop_front();
+    }
+    while (!b.epi_pipe.empty() && b.epi_pipe.front().ready_cycle <= cycle_) {
+        const auto& e = b.epi_pipe.front();
+        if (b.epi.out_type == TYPE_FP8) {
+            uint32_t code = FPEmu::fp22_to_fp8(e.value_fp22, b.epi.out_sub) & 0xFF;
+            b.d_f64[e.idx] = b.epi.out_sub == SUB_FP8E4M3 ? FPConvert::fp8e4m3_to_f64(code) : FPConvert::fp8e5m2_to_f64(code);
+            b.d_packed[e.idx / 4] |= code << ((e.idx % 4) * 8);
+        } else if (b.epi.out_type == TYPE_FP4) {
+            uint32_t code = FPEmu::fp22_to_fp4(e.value_fp22);
+            b.d_f64[e.idx] = FPConvert::fp4_to_f64(code);
+            b.d_packed[e.idx / 8] |= code << ((e.idx % 8) * 4);
+        } else {
+            b.d_f64[e.idx] = quantize_output_f64(e.value_fp22, cfg_);
+        }
+        b.results_collected++;
+        b.epi_pipe.pop_front();
     }
 }
 
 bool TensorCoreUnit::push_output_result(const BatchResult& br) {
     if ((int)output_fifo_.size() >= cfg_.output_fifo_depth) return false;
-    output_fifo_.push_back(br); stats_.dram_write_bytes += (uint64_t)br.d_f64.size() * 4; return true;
+    output_fifo_.push_back(br);
+    // a partial sum stays on chip as the C operand of the next K slice
+    if (!br.partial) stats_.dram_write_bytes += br.d_packed.empty() ? (uint64_t)br.d_f64.size() * 4 : (uint64_t)br.d_packed.size() * 4;
+    return true;
 }
 
 bool TensorCoreUnit::pop_output_result(BatchResult& br) { if (output_fifo_.empty()) return false; br = output_fifo_.front(); output_fifo_.pop_front(); return true; }
-bool TensorCoreUnit::can_accept_job() const { return !active_batch_.batch_valid; }
-bool TensorCoreUnit::has_pending_work() const { if (active_batch_.batch_valid) return true; for (const auto& d: dp_units_) if (d.busy()) return true; return false; }
-void TensorCoreUnit::tick() { cycle_++; stats_.total_cycles++; if (state_==IDLE||state_==DONE) return; dispatch_some(stats_); collect_results(); if (has_pending_work()) stats_.busy_cycles++; else state_=DONE; stats_.dp_busy_unit_cycles = dp_busy_acc_cycles_; }
-uint64_t TensorCoreUnit::run(int max_cycles) { if (state_==IDLE||state_==DONE) start(); while(state_!=DONE && (int)cycle_<max_cycles) tick(); return cycle_; }
-bool TensorCoreUnit::is_done() const { return state_==DONE; }
-bool TensorCoreUnit::is_busy() const { return state_!=IDLE && state_!=DONE; }
+bool TensorCoreUnit::can_accept_job() const {
+    if (reconfig_pending_) return false;
+    if (cfg_.staging_buffers == 0) return !active_batch_.batch_valid;
+    return (int)staged_.size() + (active_batch_.batch_valid ? 1 : 0) < cfg_.staging_buffers;
+}
+bool TensorCoreUnit::has_pending_work() const { if (active_batch_.batch_valid || !draining_.empty() || !staged_.empty()) return true; for (const auto& d: dp_units_) if (d.busy()) return true; return false; }
+void TensorCoreUnit::tick() {
+    cycle_++; stats_.total_cycles++;
+    if (reconfig_pending_) {
+        if (has_pending_work()) stats_.reconfig_drain_cycles++;
+        else if (!reconfig_datapath_) apply_config();  // register update: no reconfig latency
+        else { stats_.reconfig_cycles++; if (--reconfig_countdown_ <= 0) apply_config(); return; }
+    }
+    if (state_==IDLE||state_==DONE) return;
+    bool staging = stage_step();
+    int busy0 = dp_busy_acc_cycles_; bool dispatching = active_batch_.batch_valid;
+    dispatch_some(stats_); collect_results();
+    bool computing = dispatching || dp_busy_acc_cycles_ > busy0;
+    if (staging && computing) stats_.staging_overlap_cycles++;
+    if (!computing && !staged_.empty()) stats_.staging_stall_cycles++;
+    if (has_pending_work()) stats_.busy_cycles++; else state_=DONE; stats_.dp_busy_unit_cycles = dp_busy_acc_cycles_;
+}
+uint64_t TensorCoreUnit::run(int max_cycles) { if (state_==IDLE||state_==DONE) start(); while((state_!=DONE || reconfig_pending_) && (int)cycle_<max_cycles) tick(); return cycle_; }
+bool TensorCoreUnit::is_done() const { return state_==DONE && !reconfig_pending_; }
+bool TensorCoreUnit::is_busy() const { return reconfig_pending_ || (state_!=IDLE && state_!=DONE); }
 std::vector<double> TensorCoreUnit::get_result_f64() const { return !output_fifo_.empty()?output_fifo_.front().d_f64:last_output_d_; }
 std::vector<uint16_t> TensorCoreUnit::get_result_fp16() const { auto src=get_result_f64(); std::vector<uint16_t> out(src.size()); for(size_t i=0;i<src.size();++i) out[i]=SoftFloat::f64_to_fp16(src[i]); return out; }
 std::vector<uint32_t> TensorCoreUnit::get_result_fp32() const { auto src=get_result_f64(); std::vector<uint32_t> out(src.size()); for(size_t i=0;i<src.size();++i) out[i]=SoftFloat::f64_to_fp32(src[i]); return out; }
@@ -8,8 +8,12 @@
 struct BatchResult {
     int batch_id = -1;
     std::vector<double> d_f64;
+    std::vector<uint32_t> d_packed;  // requantized D, packed like A/B operands
+    std::vector<uint32_t> d_fp22;    // raw accumulators, before epilogue and output rounding
+    bool partial = false;            // result stays on chip (K-slice sum, attention scores), never written out
     uint64_t start_cycle = 0;
     uint64_t done_cycle = 0;
+    double energy_pj = 0;            // operand fetch, datapath and register activity of this batch
 };
 
 // Per-dot-product input/output packet.
@@ -19,12 +23,14 @@ struct DPInput {
     uint32_t c_fp22;
     int row;
     int col;
+    int batch_id;
 };
 
 struct DPResult {
     uint32_t value_fp22;
     int row;
     int col;
+    int batch_id;
 };
 
 class DotProductUnit {
@@ -41,6 +47,10 @@ public:
     std::vector<PipeEntry> pipe_q_;
     DPResult output_data_;
     bool output_valid_ = false;
+    int mul_busy_ = 0;  // cycles until the multipliers take the next dot product
+    // last latched values, for the toggle count of the energy model
+    std::vector<uint32_t> op_a_reg_, op_b_reg_, prod_reg_, tree_reg_;
+    uint32_t acc_reg_ = 0;
 
     void init(const OTC_Config* cfg);
     void reset();
@@ -62,6 +72,8 @@ public:
 
     std::deque<BatchResult> output_fifo_;
 
+    // active_batch_ is being dispatched; once every DP has its operands it
+    // moves to draining_ so the next batch can start while it finishes.
     struct ActiveBatch {
         bool batch_valid = false;
         int batch_id = -1;
@@ -69,24 +81,62 @@ public:
         std::vector<uint16_t> b_fp9;
         std::vector<uint32_t> c_fp22;
         std::vector<double> d_f64;
+        std::vector<uint32_t> d_fp22;
+        bool partial = false;
+        double energy_pj = 0;
         int dispatch_ptr = 0;
         int results_collected = 0;
         uint64_t start_cycle = 0;
+        uint64_t load_start = 0, ready_cycle = 0;  // staging window, see start_batch
+        OTC_Epilogue epi;
+        std::vector<uint32_t> d_packed;
+        std::deque<DPResult> epi_in;
+        struct EpiEntry { int idx; uint32_t value_fp22; uint64_t ready_cycle; };
+        std::deque<EpiEntry> epi_pipe;
     } active_batch_;
+    std::deque<ActiveBatch> draining_;
+    // Accepted batches whose operands are still loading or converting, or
+    // waiting for active_batch_ to finish dispatching. Each holds one of the
+    // staging_buffers until it has been dispatched.
+    std::deque<ActiveBatch> staged_;
+    uint64_t load_busy_until_ = 0;   // memory port free from this cycle
+    uint64_t read_bytes_mark_ = 0;   // dram_read_bytes when the last batch was accepted
 
     int next_batch_id_ = 0;
+    uint64_t sfu_busy_until_ = 0;
     int dp_busy_acc_cycles_ = 0;
 
     std::vector<double> last_output_d_;
 
+    // config_registers.v: new values are only taken while busy is low, an
+    // illegal combination raises config_error and keeps the old config
+    bool config_error_ = false;
+    bool reconfig_pending_ = false;
+    bool reconfig_datapath_ = false;  // the pending config changes the datapath
+    int reconfig_countdown_ = 0;
+    OTC_Config pending_cfg_;
+
     void init(const OTC_Config& cfg);
     void reset();
+    bool reconfigure(const OTC_Config& cfg);
+    void apply_config();
+    bool is_reconfiguring() const;
     void load(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, const std::vector<uint32_t>& c);
     bool enqueue_job(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, const std::vector<uint32_t>& c);
     void start();
-    bool try_start_batch(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, const std::vector<uint32_t>& c);
+    bool try_start_batch(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, const std::vector<uint32_t>& c,
+                         bool partial = false);
+    bool enqueue_job_acc(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, std::vector<uint32_t> c_fp22,
+                         bool partial, bool a_on_chip);
+    uint64_t sfu_issue(int ops);
+    bool start_batch(std::vector<uint16_t> a_fp9, std::vector<uint16_t> b_fp9, std::vector<uint32_t> c_fp22, bool partial);
+    bool enqueue_conv_tile(const OTC_ConvShape& cs, const uint32_t* input, const uint32_t* filter, int group,
+                           int m0, int k0, int n0, std::vector<uint32_t> c_fp22, bool partial);
+    bool stage_step();
     void dispatch_some(OTC_Stats& stats);
     void collect_results();
+    ActiveBatch* find_batch(int batch_id);
+    void epilogue_step(ActiveBatch& b, int& budget);
     bool push_output_result(const BatchResult& br);
     bool pop_output_result(BatchResult& br);
     bool can_accept_job() const;
@@ -0,0 +1,271 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Step shape x k-fusion x data type sweep for TensorUnit::wmma: every
+// supported step shape must compute the warp fragment product, and fusing
+// k-steps into one micro-op must not change a bit of the result.
+
+#include <iostream>
+#include <random>
+#include <cmath>
+#include "arch.h"
+#include "tensor_unit.h"
+#include "tensor_cfg.h"
+
+using namespace vortex;
+
+namespace vt = vortex::tensor;
+using cfg = vt::wmma_config_t<NUM_THREADS>;
+
+static constexpr uint32_t tileM = cfg::tcM * cfg::m_steps;
+static constexpr uint32_t tileN = cfg::tcN * cfg::n_steps;
+static constexpr uint32_t tileK = cfg::tcK * cfg::k_steps; // in 32-bit words
+
+struct Format {
+  const char* name;
+  uint32_t fmt_s;
+  uint32_t fmt_d;
+  uint32_t elem_bits;
+};
+
+static const Format formats[] = {
+  {"fp16->fp32", vt::fp16::id,  vt::fp32::id,  16},
+  {"bf16->fp32", vt::bf16::id,  vt::fp32::id,  16},
+  {"int8->int32", vt::int8::id,  vt::int32::id, 8},
+  {"uint8->int32", vt::uint8::id, vt::int32::id, 8},
+  {"int4->int32", vt::int4::id,  vt::int32::id, 4},
+  {"uint4->int32", vt::uint4::id, vt::int32::id, 4},
+};
+
+// small exactly representable floating-point operands keep the reference
+// independent of the accumulation order.
+static const float fp_values[] = {-2.0f, -1.5f, -1.0f, -0.5f, 0.0f, 0.5f, 1.0f, 1.5f, 2.0f};
+
+static uint16_t f32_to_fp16(float f) {
+  auto x = bit_cast<uint32_t>(f);
+  uint16_t s = (x >> 16) & 0x8000;
+  if ((x & 0x7fffffff) == 0)
+    return s;
+  uint32_t e = ((x >> 23) & 0xff) - 127 + 15;
+  return s | (e << 10) | ((x >> 13) & 0x3ff);
+}
+
+static float fp16_to_f32(uint16_t h) {
+  float v = (h & 0x7fff) ? std::ldexp(1.0f + (h & 0x3ff) / 1024.0f, ((h >> 10) & 0x1f) - 15) : 0.0f;
+  return (h & 0x8000) ? -v : v;
+}
+
+static uint32_t random_elem(const Format& f, std::mt19937& rng) {
+  switch (f.fmt_s) {
+  case vt::fp16::id:
+    return f32_to_fp16(fp_values[rng() % 9]);
+  case vt::bf16::id:
+    return bit_cast<uint32_t>(fp_values[rng() % 9]) >> 16;
+  default:
+    return rng() & ((1u << f.elem_bits) - 1);
+  }
+}
+
+static double elem_value(const Format& f, uint32_t word, uint32_t i) {
+  uint32_t bits = (word >> (i * f.elem_bits)) & ((1u << f.elem_bits) - 1);
+  switch (f.fmt_s) {
+  case vt::fp16::id:  return fp16_to_f32(bits);
+  case vt::bf16::id:  return bit_cast<float>(bits << 16);
+  case vt::int8::id:  return (int8_t)bits;
+  case vt::uint8::id: return bits;
+  case vt::int4::id:  return (bits & 0x8) ? (int)bits - 16 : (int)bits;
+  case vt::uint4::id: return bits;
+  default:
+    std::abort();
+  }
+}
+
+static uint32_t random_word(const Format& f, std::mt19937& rng) {
+  uint32_t w = 0;
+  for (uint32_t i = 0; i < 32 / f.elem_bits; ++i) {
+    w |= random_elem(f, rng) << (i * f.elem_bits);
+  }
+  return w;
+}
+
+struct Operands {
+  std::vector<uint32_t> A; // row-major, packed words
+  std::vector<uint32_t> B; // column-major, packed words
+  std::vector<uint32_t> C;
+};
+
+static Operands random_operands(const Format& f, std::mt19937& rng) {
+  Operands ops{std::vector<uint32_t>(tileM * tileK), std::vector<uint32_t>(tileN * tileK), std::vector<uint32_t>(tileM * tileN)};
+  for (auto& w : ops.A) w = random_word(f, rng);
+  for (auto& w : ops.B) w = random_word(f, rng);
+  for (auto& w : ops.C) {
+    int c = (int)(rng() % 9) - 4;
+    w = (f.fmt_d == vt::fp32::id) ? bit_cast<uint32_t>((float)c) : (uint32_t)c;
+  }
+  return ops;
+}
+
+// run the fragment through the unit in decode order, one call per fused
+// k-group; returns D, or an empty vector if a micro-op reports a latency
+// that does not cover every step of its group.
+static std::vector<uint32_t> run_config(const Format& f, const TensorUnit::Config& tc, const Operands& ops) {
+  auto& A = ops.A;
+  auto& B = ops.B;
+  Arch arch(NUM_THREADS, NUM_WARPS, NUM_CORES);
+  arch.set_tcu_tile(tc.tcM, tc.tcN, tc.tcK, tc.k_fusion);
+  arch.set_tcu_kernel_tile(tc.tcM, tc.tcN, tc.tcK);
+  auto tcu = TensorUnit::Create("tcu", arch, nullptr);
+
+  auto acc = ops.C;
+  std::vector<std::vector<reg_data_t>> a_data(tc.k_fusion, std::vector<reg_data_t>(NUM_THREADS));
+  std::vector<std::vector<reg_data_t>> b_data(tc.k_fusion, std::vector<reg_data_t>(NUM_THREADS));
+  std::vector<reg_data_t> rs3(NUM_THREADS), rd(NUM_THREADS);
+  for (uint32_t kg = 0; kg < tc.k_steps; kg += tc.k_fusion) {
+    for (uint32_t m = 0; m < tc.m_steps; ++m) {
+      for (uint32_t n = 0; n < tc.n_steps; ++n) {
+        uint32_t a_off = (m % tc.a_sub_blocks) * tc.a_block_size;
+        uint32_t b_off = (n % tc.b_sub_blocks) * tc.b_block_size;
+        for (uint32_t s = 0; s < tc.k_fusion; ++s) {
+          uint32_t k = kg + s;
+          for (uint32_t i = 0; i < tc.tcM; ++i) {
+            for (uint32_t z = 0; z < tc.tcK; ++z) {
+              a_data.at(s).at(a_off + i * tc.tcK + z).u32 = A.at((m * tc.tcM + i) * tileK + k * tc.tcK + z);
+            }
+          }
+          for (uint32_t j = 0; j < tc.tcN; ++j) {
+            for (uint32_t z = 0; z < tc.tcK; ++z) {
+              b_data.at(s).at(b_off + j * tc.tcK + z).u32 = B.at((n * tc.tcN + j) * tileK + k * tc.tcK + z);
+            }
+          }
+        }
+        for (uint32_t i = 0; i < tc.tcM; ++i) {
+          for (uint32_t j = 0; j < tc.tcN; ++j) {
+            rs3.at(i * tc.tcN + j).u32 = acc.at((m * tc.tcM + i) * tileN + n * tc.tcN + j);
+          }
+        }
+        TensorUnit::ExeTraceData trace_data;
+        tcu->wmma(0, f.fmt_s, f.fmt_d, m, n, kg, a_data, b_data, rs3, rd, &trace_data);
+        if (trace_data.latency < 2 + tc.k_fusion) {
+          std::cout << "  unexpected latency " << trace_data.latency << " at k=" << kg << std::endl;
+          return {};
+        }
+        for (uint32_t i = 0; i < tc.tcM; ++i) {
+          for (uint32_t j = 0; j < tc.tcN; ++j) {
+            acc.at((m * tc.tcM + i) * tileN + n * tc.tcN + j) = rd.at(i * tc.tcN + j).u32;
+          }
+        }
+      }
+    }
+  }
+
+  return acc;
+}
+
+// compare D with a host GEMM
+static int check_gemm(const Format& f, const Operands& ops, const std::vector<uint32_t>& D) {
+  auto& A = ops.A;
+  auto& B = ops.B;
+  auto& C = ops.C;
+  int errors = 0;
+  uint32_t ratio = 32 / f.elem_bits;
+  for (uint32_t r = 0; r < tileM; ++r) {
+    for (uint32_t c = 0; c < tileN; ++c) {
+      double ref = (f.fmt_d == vt::fp32::id) ? bit_cast<float>(C.at(r * tileN + c)) : (int32_t)C.at(r * tileN + c);
+      for (uint32_t kw = 0; kw < tileK; ++kw) {
+        for (uint32_t i = 0; i < ratio; ++i) {
+          ref += elem_value(f, A.at(r * tileK + kw), i) * elem_value(f, B.at(c * tileK + kw), i);
+        }
+      }
+      uint32_t d = D.at(r * tileN + c);
+      double out = (f.fmt_d == vt::fp32::id) ? bit_cast<float>(d) : (int32_t)d;
+      if (out != ref) {
+        if (errors == 0) {
+          std::cout << "  D[" << r << "][" << c << "]=" << out << ", expected " << ref << std::endl;
+        }
+        ++errors;
+      }
+    }
+  }
+  return errors;
+}
+
+int main() {
+  std::mt19937 rng(42);
+  int failed = 0;
+  int tested = 0;
+  bool saw_default = false;
+  for (auto& f : formats) {
+    for (uint32_t tcM = 1; tcM <= tileM; ++tcM) {
+      for (uint32_t tcN = 1; tcN <= tileN; ++tcN) {
+        for (uint32_t tcK = 1; tcK <= tileK; ++tcK) {
+          TensorUnit::Config tc;
+          if (!TensorUnit::resolve_config(tcM, tcN, tcK, 1, &tc))
+            continue;
+          saw_default |= (tcM == cfg::tcM && tcN == cfg::tcN && tcK == cfg::tcK);
+          auto ops = random_operands(f, rng);
+          auto unfused = run_config(f, tc, ops);
+          for (uint32_t k_fusion = 1; k_fusion <= IntrTcuArgs::MAX_STEPS; ++k_fusion) {
+            if (!TensorUnit::resolve_config(tcM, tcN, tcK, k_fusion, &tc))
+              continue;
+            auto D = (k_fusion == 1) ? unfused : run_config(f, tc, ops);
+            int errors = D.empty() ? 1 : check_gemm(f, ops, D);
+            if (errors == 0 && D != unfused) {
+              std::cout << "  k-fusion changed the result" << std::endl;
+              errors = 1;
+            }
+            std::cout << (errors ? "FAIL: " : "PASS: ") << f.name << " " << tcM << "x" << tcN << "x" << tcK
+                      << ":" << k_fusion << std::endl;
+            failed += (errors != 0);
+            ++tested;
+          }
+        }
+      }
+    }
+  }
+  // shapes that do not tile the fragment are rejected
+  TensorUnit::Config tc;
+  if (TensorUnit::resolve_config(tileM + 1, cfg::tcN, cfg::tcK, 1, &tc)
+   || TensorUnit::resolve_config(cfg::tcM, cfg::tcN, cfg::tcK, 0, &tc)
+   || TensorUnit::resolve_config(cfg::tcM, cfg::tcN, cfg::tcK, cfg::k_steps + 1, &tc)) {
+    std::cout << "FAIL: invalid tile accepted" << std::endl;
+    ++failed;
+  }
+  // a step shape the kernel was not built for is rejected
+  Arch arch(NUM_THREADS, NUM_WARPS, NUM_CORES);
+  if (!TensorUnit::resolve_config(arch, &tc)) {
+    std::cout << "FAIL: default tile rejected" << std::endl;
+    ++failed;
+  }
+  for (uint32_t tcM = 1; tcM <= tileM; ++tcM) {
+    if (tcM == cfg::tcM || !TensorUnit::resolve_config(tcM, cfg::tcN, cfg::tcK, 1, &tc))
+      continue;
+    arch.set_tcu_tile(tcM, cfg::tcN, cfg::tcK, 1);
+    if (TensorUnit::resolve_config(arch, &tc)) {
+      std::cout << "FAIL: " << tcM << "x" << cfg::tcN << "x" << cfg::tcK << " accepted for a "
+                << cfg::tcM << "x" << cfg::tcN << "x" << cfg::tcK << " kernel" << std::endl;
+      ++failed;
+    }
+    arch.set_tcu_kernel_tile(tcM, cfg::tcN, cfg::tcK);
+    if (!TensorUnit::resolve_config(arch, &tc)) {
+      std::cout << "FAIL: " << tcM << "x" << cfg::tcN << "x" << cfg::tcK << " rejected for its own kernel" << std::endl;
+      ++failed;
+    }
+    arch.set_tcu_kernel_tile(0, 0, 0);
+  }
+  if (!saw_default) {
+    std::cout << "FAIL: default tile not covered" << std::endl;
+    ++failed;
+  }
+  std::cout << tested << " configurations, " << failed << " failed" << std::endl;
+  return failed ? 1 : 0;
+}
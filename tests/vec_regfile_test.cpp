@@ -0,0 +1,65 @@
+// Copyright © 2019-2023
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Bounds of the per-thread VregFile views: the threads' registers share one
+// buffer, so a register or LMUL group past v31 must throw (in release builds
+// too) instead of reaching the next thread's registers.
+
+#include <iostream>
+#include <functional>
+#include <vector>
+#include "vec_ops.h"
+
+using namespace vortex;
+
+static int failed = 0;
+
+static void check(const char* name, bool ok) {
+  std::cout << (ok ? "PASS: " : "FAIL: ") << name << std::endl;
+  failed += !ok;
+}
+
+static bool throws(const std::function<void()>& fn) {
+  try {
+    fn();
+  } catch (const std::out_of_range&) {
+    return true;
+  }
+  return false;
+}
+
+int main() {
+  // two threads' registers, back to back
+  std::vector<Byte> storage(2 * MAX_NUM_REGS * VLENB, 0);
+  VRF_t t0(storage.data());
+  ConstVRF_t t1(storage.data() + MAX_NUM_REGS * VLENB);
+
+  check("v31 in range", !throws([&] { t0.data(MAX_NUM_REGS - 1); }));
+  check("v32 throws", throws([&] { t0.data(MAX_NUM_REGS); }));
+  check("v28 LMUL=4 in range", !throws([&] { t0.span<uint32_t>(28, 4); }));
+  check("v30 LMUL=4 throws", throws([&] { t0.span<uint32_t>(30, 4); }));
+  check("v32 LMUL=1 throws", throws([&] { t0.span<Byte>(MAX_NUM_REGS); }));
+  check("group size wrap throws", throws([&] { t0.span<Byte>(1, UINT32_MAX); }));
+
+  // an element write that runs past v31 leaves thread 1 untouched
+  uint32_t elts = VLENB / sizeof(uint32_t);
+  check("element past v31 throws", throws([&] { setVregData<uint32_t>(t0, 30, 2 * elts, 0xdeadbeef); }));
+  bool clean = true;
+  for (auto b : t1.span<Byte>(0, MAX_NUM_REGS)) {
+    clean &= (b == 0);
+  }
+  check("next thread untouched", clean);
+
+  std::cout << failed << " failed" << std::endl;
+  return failed ? 1 : 0;
+}
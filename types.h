@@ -644,10 +644,12 @@ enum class TcuType {
 };
 
 struct IntrTcuArgs {
+  static constexpr uint32_t MAX_STEPS = 1 << 4; // range of the step_* fields
   uint32_t fmt_s  : 4;
   uint32_t fmt_d  : 4;
   uint32_t step_m : 4;
   uint32_t step_n : 4;
+  uint32_t step_k : 4;
 };
 
 inline std::ostream &operator<<(std::ostream &os, const TcuType& type) {
@@ -8,13 +8,92 @@
 #include <limits>
 #include <iostream>
 #include <algorithm>
+#include <new>
+#include <stdexcept>
 #include <bitmanip.h>
 #include <rvfloats.h>
 #include "types.h"
 
 namespace vortex {
 
-typedef std::vector<std::vector<Byte>> VRF_t;
+// Typed view over a contiguous run of vector register bytes.
+template <typename DT>
+class VregSpan {
+public:
+  VregSpan(DT* data, uint32_t size) : data_(data), size_(size) {}
+
+  DT* data() const { return data_; }
+  uint32_t size() const { return size_; }
+
+  DT* begin() const { return data_; }
+  DT* end() const { return data_ + size_; }
+
+  DT& operator[](uint32_t index) const {
+    assert(index < size_);
+    return data_[index];
+  }
+
+private:
+  DT*      data_;
+  uint32_t size_;
+};
+
+// Allocator for the vector register storage: rows start on a cache-line
+// boundary, so the row loops below get aligned loads and stores.
+template <typename T, size_t Align = 64>
+struct AlignedAllocator {
+  using value_type = T;
+  template <typename U>
+  struct rebind { using other = AlignedAllocator<U, Align>; };
+
+  AlignedAllocator() = default;
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, Align>&) {}
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Align)));
+  }
+  void deallocate(T* p, size_t) {
+    ::operator delete(p, std::align_val_t(Align));
+  }
+
+  bool operator==(const AlignedAllocator&) const { return true; }
+  bool operator!=(const AlignedAllocator&) const { return false; }
+};
+
+// Vector registers of one thread, viewed in place in the warp's register
+// storage. A thread's registers are adjacent, so an LMUL group is one range.
+// B is Byte for a writable view and const Byte for a read-only one.
+template <typename B>
+class VregFile {
+public:
+  explicit VregFile(B* base) : base_(base) {}
+
+  // Out-of-range registers throw in every build: the storage runs on into
+  // the next thread's registers, so an unchecked access would not fault.
+  B* data(uint32_t reg) const {
+    if (reg >= MAX_NUM_REGS)
+      throw std::out_of_range("vector register v" + std::to_string(reg) + " out of range");
+    return base_ + reg * VLENB;
+  }
+
+  VregSpan<B> at(uint32_t reg) const {
+    return VregSpan<B>(this->data(reg), VLENB);
+  }
+
+  template <typename DT, typename T = std::conditional_t<std::is_const<B>::value, const DT, DT>>
+  VregSpan<T> span(uint32_t baseVreg, uint32_t num_regs = 1) const {
+    if (baseVreg >= MAX_NUM_REGS || num_regs > MAX_NUM_REGS - baseVreg)
+      throw std::out_of_range("vector register group v" + std::to_string(baseVreg) + "+" + std::to_string(num_regs) + " out of range");
+    return VregSpan<T>(reinterpret_cast<T*>(this->data(baseVreg)), num_regs * (VLENB / sizeof(DT)));
+  }
+
+private:
+  B* base_;
+};
+
+typedef VregFile<Byte> VRF_t;
+typedef VregFile<const Byte> ConstVRF_t;
 
 template <typename T, typename R>
 class Add {
@@ -1133,26 +1212,26 @@ public:
 
 ///////////////////////////////////////////////////////////////////////////////
 
-bool isMasked(const VRF_t& vreg_file, uint32_t maskVreg, uint32_t byteI, uint32_t vmask) {
+inline bool isMasked(const VRF_t& vreg_file, uint32_t maskVreg, uint32_t byteI, uint32_t vmask) {
   if (vmask == 1)
     return false; // unmasked
-  auto& mask = vreg_file.at(maskVreg);
-  uint8_t emask = *(uint8_t *)(mask.data() + byteI / 8);
+  auto mask = vreg_file.data(maskVreg);
+  uint8_t emask = *(mask + byteI / 8);
   uint8_t value = (emask >> (byteI % 8)) & 0x1;
   DP(4, "Masking enabled: " << +value);
   return (value == 0);
 }
 
 template <typename DT>
-DT getVregData(const std::vector<Byte>& reg_data, uint32_t eltIndex) {
+DT getVregData(const Byte* reg_data, uint32_t eltIndex) {
   assert(eltIndex < (VLENB / sizeof(DT)));
-  return *reinterpret_cast<const DT*>(reg_data.data() + eltIndex * sizeof(DT));
+  return *reinterpret_cast<const DT*>(reg_data + eltIndex * sizeof(DT));
 }
 
 template <typename DT>
-void setVregData(std::vector<Byte>& reg_data, uint32_t eltIndex, DT value) {
+void setVregData(Byte* reg_data, uint32_t eltIndex, DT value) {
   assert(eltIndex < (VLENB / sizeof(DT)));
-  *reinterpret_cast<DT*>(reg_data.data() + eltIndex * sizeof(DT)) = value;
+  *reinterpret_cast<DT*>(reg_data + eltIndex * sizeof(DT)) = value;
 }
 
 template <typename DT>
@@ -1173,7 +1252,7 @@ template <typename DT>
 DT getVregData(const VRF_t& vreg_file, uint32_t baseVreg, uint32_t eltIndex) {
   uint32_t reg_no  = getVregNo<DT>(baseVreg, eltIndex);
   uint32_t reg_elt = getVregElt<DT>(eltIndex);
-  auto value = getVregData<DT>(vreg_file.at(reg_no), reg_elt);
+  auto value = getVregData<DT>(vreg_file.data(reg_no), reg_elt);
   DP(4, "VRF Read: v[" << reg_no << "][" << reg_elt * sizeof(DT) << "]=0x" << std::hex << +value << std::dec);
   return value;
 }
@@ -1183,7 +1262,7 @@ void setVregData(VRF_t& vreg_file, uint32_t baseVreg, uint32_t eltIndex, DT valu
   uint32_t reg_no  = getVregNo<DT>(baseVreg, eltIndex);
   uint32_t reg_elt = getVregElt<DT>(eltIndex);
   DP(4, "VRF Write: v[" << reg_no << "][" << reg_elt * sizeof(DT) << "]=0x" << std::hex << +value << std::dec);
-  setVregData<DT>(vreg_file.at(reg_no), reg_elt, value);
+  setVregData<DT>(vreg_file.data(reg_no), reg_elt, value);
 }
 
 inline uint64_t getVregData(uint32_t vsew, const VRF_t& vreg_file, uint32_t baseVreg, uint32_t eltIndex) {
@@ -1221,16 +1300,59 @@ inline void setVregData(uint32_t vsew, VRF_t& vreg_file, uint32_t baseVreg, uint
   }
 }
 
+template <typename DT>
+DT* getVregPtr(const VRF_t& vreg_file, uint32_t baseVreg, uint32_t eltIndex) {
+  uint32_t reg_no  = getVregNo<DT>(baseVreg, eltIndex);
+  uint32_t reg_elt = getVregElt<DT>(eltIndex);
+  return reinterpret_cast<DT*>(vreg_file.data(reg_no)) + reg_elt;
+}
+
+// mask row of v0, or nullptr for unmasked instructions
+inline const uint8_t* getVmask(const VRF_t& vreg_file, uint32_t vmask) {
+  return (vmask == 1) ? nullptr : vreg_file.data(0);
+}
+
+inline bool isActive(const uint8_t* mask, uint32_t i) {
+  return (mask == nullptr) || ((mask[i / 8] >> (i % 8)) & 0x1);
+}
+
+inline void setMaskBit(uint8_t* mask, uint32_t i, bool value) {
+  if (value) {
+    mask[i / 8] |= (1 << (i % 8));
+  } else {
+    mask[i / 8] &= ~(1 << (i % 8));
+  }
+}
+
+// Element loops below walk a register group one VLENB row at a time:
+// the register lookup happens once per row and the unmasked inner loop
+// runs over plain typed pointers so the compiler can vectorize it.
+// There are no hand-written intrinsics: the ops are generic functors shared
+// with the scalar FP helpers, and the simulator also builds on non-x86 hosts.
+
 template <template <typename DT1, typename DT2> class OP, typename DT>
 void vector_op_vix(DT first, VRF_t& vreg_file, uint32_t rsrc0, uint32_t rdest, uint32_t vl, uint32_t vmask) {
-  for (uint32_t i = 0; i < vl; i++) {
-    if (isMasked(vreg_file, 0, i, vmask))
-      continue;
-    DT second = getVregData<DT>(vreg_file, rsrc0, i);
-    DT third = getVregData<DT>(vreg_file, rdest, i);
-    DT result = OP<DT, DT>::apply(first, second, third);
-    DP(4, (OP<DT, DT>::name()) << "(" << +first << ", " << +second << ", " << +third << ")" << " = " << +result);
-    setVregData<DT>(vreg_file, rdest, i, result);
+  constexpr uint32_t row_elts = VLENB / sizeof(DT);
+  auto mask = getVmask(vreg_file, vmask);
+  for (uint32_t base = 0; base < vl; base += row_elts) {
+    uint32_t n = std::min(row_elts, vl - base);
+    auto src = getVregPtr<DT>(vreg_file, rsrc0, base);
+    auto dst = getVregPtr<DT>(vreg_file, rdest, base);
+    if (mask == nullptr) {
+      for (uint32_t j = 0; j < n; ++j) {
+        DT result = OP<DT, DT>::apply(first, src[j], dst[j]);
+        DP(4, (OP<DT, DT>::name()) << "(" << +first << ", " << +src[j] << ", " << +dst[j] << ")" << " = " << +result);
+        dst[j] = result;
+      }
+    } else {
+      for (uint32_t j = 0; j < n; ++j) {
+        if (!isActive(mask, base + j))
+          continue;
+        DT result = OP<DT, DT>::apply(first, src[j], dst[j]);
+        DP(4, (OP<DT, DT>::name()) << "(" << +first << ", " << +src[j] << ", " << +dst[j] << ")" << " = " << +result);
+        dst[j] = result;
+      }
+    }
   }
 }
 
@@ -1381,14 +1503,19 @@ void vector_op_scalar(DT *dest, const VRF_t& vreg_file, uint32_t rsrc0, uint32_t
 
 template <template <typename DT1, typename DT2> class OP, typename DT, typename DTR>
 void vector_op_vix_w(DT first, VRF_t& vreg_file, uint32_t rsrc0, uint32_t rdest, uint32_t vl, uint32_t vmask) {
-  for (uint32_t i = 0; i < vl; i++) {
-    if (isMasked(vreg_file, 0, i, vmask))
-      continue;
-    DT second = getVregData<DT>(vreg_file, rsrc0, i);
-    DTR third = getVregData<DTR>(vreg_file, rdest, i);
-    DTR result = OP<DT, DTR>::apply(first, second, third);
-    DP(4, "Widening " << (OP<DT, DTR>::name()) << "(" << +first << ", " << +second << ", " << +third << ")" << " = " << +result);
-    setVregData<DTR>(vreg_file, rdest, i, result);
+  constexpr uint32_t row_elts = VLENB / sizeof(DTR);
+  auto mask = getVmask(vreg_file, vmask);
+  for (uint32_t base = 0; base < vl; base += row_elts) {
+    uint32_t n = std::min(row_elts, vl - base);
+    auto src = getVregPtr<DT>(vreg_file, rsrc0, base);
+    auto dst = getVregPtr<DTR>(vreg_file, rdest, base);
+    for (uint32_t j = 0; j < n; ++j) {
+      if (!isActive(mask, base + j))
+        continue;
+      DTR result = OP<DT, DTR>::apply(first, src[j], dst[j]);
+      DP(4, "Widening " << (OP<DT, DTR>::name()) << "(" << +first << ", " << +src[j] << ", " << +dst[j] << ")" << " = " << +result);
+      dst[j] = result;
+    }
   }
 }
 
@@ -1430,13 +1557,19 @@ void vector_op_vix_wx(Word src1, VRF_t& vreg_file, uint32_t rsrc0, uint32_t rdes
 
 template <template <typename DT1, typename DT2> class OP, typename DT, typename DTR>
 void vector_op_vix_n(DT first, VRF_t& vreg_file, uint32_t rsrc0, uint32_t rdest, uint32_t vl, uint32_t vmask, uint32_t vxrm, uint32_t &vxsat) {
-  for (uint32_t i = 0; i < vl; i++) {
-    if (isMasked(vreg_file, 0, i, vmask))
-      continue;
-    DT second = getVregData<DT>(vreg_file, rsrc0, i);
-    DTR result = OP<DT, DTR>::apply(first, second, vxrm, vxsat);
-    DP(4, "Narrowing " << (OP<DT, DTR>::name()) << "(" << +first << ", " << +second << ")" << " = " << +result);
-    setVregData<DTR>(vreg_file, rdest, i, result);
+  constexpr uint32_t row_elts = VLENB / sizeof(DT);
+  auto mask = getVmask(vreg_file, vmask);
+  for (uint32_t base = 0; base < vl; base += row_elts) {
+    uint32_t n = std::min(row_elts, vl - base);
+    auto src = getVregPtr<DT>(vreg_file, rsrc0, base);
+    auto dst = getVregPtr<DTR>(vreg_file, rdest, base);
+    for (uint32_t j = 0; j < n; ++j) {
+      if (!isActive(mask, base + j))
+        continue;
+      DTR result = OP<DT, DTR>::apply(first, src[j], vxrm, vxsat);
+      DP(4, "Narrowing " << (OP<DT, DTR>::name()) << "(" << +first << ", " << +src[j] << ")" << " = " << +result);
+      dst[j] = result;
+    }
   }
 }
 
@@ -1576,17 +1709,18 @@ void vector_op_vix_ext(Word src1, VRF_t& vreg_file, uint32_t rsrc0, uint32_t rde
 
 template <template <typename DT1, typename DT2> class OP, typename DT>
 void vector_op_vix_mask(DT first, VRF_t& vreg_file, uint32_t rsrc0, uint32_t rdest, uint32_t vl, uint32_t vmask) {
-  for (uint32_t i = 0; i < vl; i++) {
-    if (isMasked(vreg_file, 0, i, vmask))
-      continue;
-    DT second = getVregData<DT>(vreg_file, rsrc0, i);
-    bool result = OP<DT, bool>::apply(first, second, 0);
-    DP(4, "Integer/float compare mask " << (OP<DT, bool>::name()) << "(" << +first << ", " << +second << ")" << " = " << +result);
-    auto old_value = getVregData<uint8_t>(vreg_file, rdest, i / 8);
-    if (result) {
-      setVregData<uint8_t>(vreg_file, rdest, i / 8, old_value | (1 << (i % 8)));
-    } else {
-      setVregData<uint8_t>(vreg_file, rdest, i / 8, old_value & ~(1 << (i % 8)));
+  constexpr uint32_t row_elts = VLENB / sizeof(DT);
+  auto mask = getVmask(vreg_file, vmask);
+  auto dst = vreg_file.data(rdest);
+  for (uint32_t base = 0; base < vl; base += row_elts) {
+    uint32_t n = std::min(row_elts, vl - base);
+    auto src = getVregPtr<DT>(vreg_file, rsrc0, base);
+    for (uint32_t j = 0; j < n; ++j) {
+      if (!isActive(mask, base + j))
+        continue;
+      bool result = OP<DT, bool>::apply(first, src[j], 0);
+      DP(4, "Integer/float compare mask " << (OP<DT, bool>::name()) << "(" << +first << ", " << +src[j] << ")" << " = " << +result);
+      setMaskBit(dst, base + j, result);
     }
   }
 }
@@ -1691,15 +1825,28 @@ void vector_op_vix_gather(Word src1, VRF_t& vreg_file, uint32_t rsrc0, uint32_t
 
 template <template <typename DT1, typename DT2> class OP, typename DT>
 void vector_op_vv(VRF_t& vreg_file, uint32_t rsrc0, uint32_t rsrc1, uint32_t rdest, uint32_t vl, uint32_t vmask) {
-  for (uint32_t i = 0; i < vl; i++) {
-    if (isMasked(vreg_file, 0, i, vmask))
-      continue;
-    DT first = getVregData<DT>(vreg_file, rsrc0, i);
-    DT second = getVregData<DT>(vreg_file, rsrc1, i);
-    DT third = getVregData<DT>(vreg_file, rdest, i);
-    DT result = OP<DT, DT>::apply(first, second, third);
-    DP(4, (OP<DT, DT>::name()) << "(" << +first << ", " << +second << ", " << +third << ")" << " = " << +result);
-    setVregData<DT>(vreg_file, rdest, i, result);
+  constexpr uint32_t row_elts = VLENB / sizeof(DT);
+  auto mask = getVmask(vreg_file, vmask);
+  for (uint32_t base = 0; base < vl; base += row_elts) {
+    uint32_t n = std::min(row_elts, vl - base);
+    auto src0 = getVregPtr<DT>(vreg_file, rsrc0, base);
+    auto src1 = getVregPtr<DT>(vreg_file, rsrc1, base);
+    auto dst  = getVregPtr<DT>(vreg_file, rdest, base);
+    if (mask == nullptr) {
+      for (uint32_t j = 0; j < n; ++j) {
+        DT result = OP<DT, DT>::apply(src0[j], src1[j], dst[j]);
+        DP(4, (OP<DT, DT>::name()) << "(" << +src0[j] << ", " << +src1[j] << ", " << +dst[j] << ")" << " = " << +result);
+        dst[j] = result;
+      }
+    } else {
+      for (uint32_t j = 0; j < n; ++j) {
+        if (!isActive(mask, base + j))
+          continue;
+        DT result = OP<DT, DT>::apply(src0[j], src1[j], dst[j]);
+        DP(4, (OP<DT, DT>::name()) << "(" << +src0[j] << ", " << +src1[j] << ", " << +dst[j] << ")" << " = " << +result);
+        dst[j] = result;
+      }
+    }
   }
 }
 
@@ -1861,15 +2008,20 @@ void vector_op_vv_gather(VRF_t& vreg_file, uint32_t rsrc0, uint32_t rsrc1, uint3
 
 template <template <typename DT1, typename DT2> class OP, typename DT, typename DTR>
 void vector_op_vv_w(VRF_t& vreg_file, uint32_t rsrc0, uint32_t rsrc1, uint32_t rdest, uint32_t vl, uint32_t vmask) {
-  for (uint32_t i = 0; i < vl; i++) {
-    if (isMasked(vreg_file, 0, i, vmask))
-      continue;
-    DT first = getVregData<DT>(vreg_file, rsrc0, i);
-    DT second = getVregData<DT>(vreg_file, rsrc1, i);
-    DTR third = getVregData<DTR>(vreg_file, rdest, i);
-    DTR result = OP<DT, DTR>::apply(first, second, third);
-    DP(4, "Widening " << (OP<DT, DTR>::name()) << "(" << +first << ", " << +second << ", " << +third << ")" << " = " << +result);
-    setVregData<DTR>(vreg_file, rdest, i, result);
+  constexpr uint32_t row_elts = VLENB / sizeof(DTR);
+  auto mask = getVmask(vreg_file, vmask);
+  for (uint32_t base = 0; base < vl; base += row_elts) {
+    uint32_t n = std::min(row_elts, vl - base);
+    auto src0 = getVregPtr<DT>(vreg_file, rsrc0, base);
+    auto src1 = getVregPtr<DT>(vreg_file, rsrc1, base);
+    auto dst  = getVregPtr<DTR>(vreg_file, rdest, base);
+    for (uint32_t j = 0; j < n; ++j) {
+      if (!isActive(mask, base + j))
+        continue;
+      DTR result = OP<DT, DTR>::apply(src0[j], src1[j], dst[j]);
+      DP(4, "Widening " << (OP<DT, DTR>::name()) << "(" << +src0[j] << ", " << +src1[j] << ", " << +dst[j] << ")" << " = " << +result);
+      dst[j] = result;
+    }
   }
 }
 
@@ -1893,15 +2045,20 @@ void vector_op_vv_w(VRF_t& vreg_file, uint32_t rsrc0, uint32_t rsrc1, uint32_t r
 
 template <template <typename DT1, typename DT2> class OP, typename DT, typename DTR>
 void vector_op_vv_wv(VRF_t& vreg_file, uint32_t rsrc0, uint32_t rsrc1, uint32_t rdest, uint32_t vl, uint32_t vmask) {
-  for (uint32_t i = 0; i < vl; i++) {
-    if (isMasked(vreg_file, 0, i, vmask))
-      continue;
-    DT first = getVregData<DT>(vreg_file, rsrc0, i);
-    DTR second = getVregData<DTR>(vreg_file, rsrc1, i);
-    DTR third = getVregData<DTR>(vreg_file, rdest, i);
-    DTR result = OP<DTR, DTR>::apply(first, second, third);
-    DP(4, "Widening wv " << (OP<DT, DTR>::name()) << "(" << +first << ", " << +second << ", " << +third << ")" << " = " << +result);
-    setVregData<DTR>(vreg_file, rdest, i, result);
+  constexpr uint32_t row_elts = VLENB / sizeof(DTR);
+  auto mask = getVmask(vreg_file, vmask);
+  for (uint32_t base = 0; base < vl; base += row_elts) {
+    uint32_t n = std::min(row_elts, vl - base);
+    auto src0 = getVregPtr<DT>(vreg_file, rsrc0, base);
+    auto src1 = getVregPtr<DTR>(vreg_file, rsrc1, base);
+    auto dst  = getVregPtr<DTR>(vreg_file, rdest, base);
+    for (uint32_t j = 0; j < n; ++j) {
+      if (!isActive(mask, base + j))
+        continue;
+      DTR result = OP<DTR, DTR>::apply(src0[j], src1[j], dst[j]);
+      DP(4, "Widening wv " << (OP<DT, DTR>::name()) << "(" << +src0[j] << ", " << +src1[j] << ", " << +dst[j] << ")" << " = " << +result);
+      dst[j] = result;
+    }
   }
 }
 
@@ -1949,14 +2106,20 @@ void vector_op_vv_wfv(VRF_t& vreg_file, uint32_t rsrc0, uint32_t rsrc1, uint32_t
 
 template <template <typename DT1, typename DT2> class OP, typename DT, typename DTR>
 void vector_op_vv_n(VRF_t& vreg_file, uint32_t rsrc0, uint32_t rsrc1, uint32_t rdest, uint32_t vl, uint32_t vmask, uint32_t vxrm, uint32_t &vxsat) {
-  for (uint32_t i = 0; i < vl; i++) {
-    if (isMasked(vreg_file, 0, i, vmask))
-      continue;
-    DTR first = getVregData<DTR>(vreg_file, rsrc0, i);
-    DT second = getVregData<DT>(vreg_file, rsrc1, i);
-    DTR result = OP<DT, DTR>::apply(first, second, vxrm, vxsat);
-    DP(4, "Narrowing " << (OP<DT, DTR>::name()) << "(" << +first << ", " << +second << ")" << " = " << +result);
-    setVregData<DTR>(vreg_file, rdest, i, result);
+  constexpr uint32_t row_elts = VLENB / sizeof(DT);
+  auto mask = getVmask(vreg_file, vmask);
+  for (uint32_t base = 0; base < vl; base += row_elts) {
+    uint32_t n = std::min(row_elts, vl - base);
+    auto src0 = getVregPtr<DTR>(vreg_file, rsrc0, base);
+    auto src1 = getVregPtr<DT>(vreg_file, rsrc1, base);
+    auto dst  = getVregPtr<DTR>(vreg_file, rdest, base);
+    for (uint32_t j = 0; j < n; ++j) {
+      if (!isActive(mask, base + j))
+        continue;
+      DTR result = OP<DT, DTR>::apply(src0[j], src1[j], vxrm, vxsat);
+      DP(4, "Narrowing " << (OP<DT, DTR>::name()) << "(" << +src0[j] << ", " << +src1[j] << ")" << " = " << +result);
+      dst[j] = result;
+    }
   }
 }
 
@@ -2035,19 +2198,24 @@ void vector_op_vv_scale(VRF_t& vreg_file, uint32_t rsrc0, uint32_t rsrc1, uint32
 
 template <template <typename DT1, typename DT2> class OP, typename DT>
 void vector_op_vv_red(VRF_t& vreg_file, uint32_t rsrc0, uint32_t rsrc1, uint32_t rdest, uint32_t vl, uint32_t vmask) {
-  for (uint32_t i = 0; i < vl; i++) {
-    // use rdest as accumulator
-    if (i == 0) {
-      setVregData<DT>(vreg_file, rdest, 0, getVregData<DT>(vreg_file, rsrc0, 0));
+  if (vl == 0)
+    return;
+  constexpr uint32_t row_elts = VLENB / sizeof(DT);
+  auto mask = getVmask(vreg_file, vmask);
+  // accumulate locally, rdest is only written once
+  DT acc = getVregData<DT>(vreg_file, rsrc0, 0);
+  for (uint32_t base = 0; base < vl; base += row_elts) {
+    uint32_t n = std::min(row_elts, vl - base);
+    auto src = getVregPtr<DT>(vreg_file, rsrc1, base);
+    for (uint32_t j = 0; j < n; ++j) {
+      if (!isActive(mask, base + j))
+        continue;
+      DT result = OP<DT, DT>::apply(acc, src[j], 0);
+      DP(4, "Reduction " << (OP<DT, DT>::name()) << "(" << +acc << ", " << +src[j] << ")" << " = " << +result);
+      acc = result;
     }
-    if (isMasked(vreg_file, 0, i, vmask))
-      continue;
-    DT first = getVregData<DT>(vreg_file, rdest, 0);
-    DT second = getVregData<DT>(vreg_file, rsrc1, i);
-    DT result = OP<DT, DT>::apply(first, second, 0);
-    DP(4, "Reduction " << (OP<DT, DT>::name()) << "(" << +first << ", " << +second << ")" << " = " << +result);
-    setVregData<DT>(vreg_file, rdest, 0, result);
   }
+  setVregData<DT>(vreg_file, rdest, 0, acc);
 }
 
 template <template <typename DT1, typename DT2> class OP, typename DT8, typename DT16, typename DT32, typename DT64>
@@ -2073,20 +2241,24 @@ void vector_op_vv_red(VRF_t& vreg_file, uint32_t rsrc0, uint32_t rsrc1, uint32_t
 
 template <template <typename DT1, typename DT2> class OP, typename DT, typename DTR>
 void vector_op_vv_red_w(VRF_t& vreg_file, uint32_t rsrc0, uint32_t rsrc1, uint32_t rdest, uint32_t vl, uint32_t vmask) {
-  for (uint32_t i = 0; i < vl; i++) {
-    // use rdest as accumulator
-    if (i == 0) {
-      setVregData<DTR>(vreg_file, rdest, 0, getVregData<DTR>(vreg_file, rsrc0, 0));
+  if (vl == 0)
+    return;
+  constexpr uint32_t row_elts = VLENB / sizeof(DT);
+  auto mask = getVmask(vreg_file, vmask);
+  DTR acc = getVregData<DTR>(vreg_file, rsrc0, 0);
+  for (uint32_t base = 0; base < vl; base += row_elts) {
+    uint32_t n = std::min(row_elts, vl - base);
+    auto src = getVregPtr<DT>(vreg_file, rsrc1, base);
+    for (uint32_t j = 0; j < n; ++j) {
+      if (!isActive(mask, base + j))
+        continue;
+      DTR second_w = std::is_signed<DT>() ? sext((DTR)src[j], sizeof(DT) * 8) : zext((DTR)src[j], sizeof(DT) * 8);
+      DTR result = OP<DTR, DTR>::apply(acc, second_w, 0);
+      DP(4, "Widening reduction " << (OP<DTR, DTR>::name()) << "(" << +acc << ", " << +second_w << ")" << " = " << +result);
+      acc = result;
     }
-    if (isMasked(vreg_file, 0, i, vmask))
-      continue;
-    DTR first = getVregData<DTR>(vreg_file, rdest, 0);
-    DT second = getVregData<DT>(vreg_file, rsrc1, i);
-    DTR second_w = std::is_signed<DT>() ? sext((DTR)second, sizeof(DT) * 8) : zext((DTR)second, sizeof(DT) * 8);
-    DTR result = OP<DTR, DTR>::apply(first, second_w, 0);
-    DP(4, "Widening reduction " << (OP<DTR, DTR>::name()) << "(" << +first << ", " << +second_w << ")" << " = " << +result);
-    setVregData<DTR>(vreg_file, rdest, 0, result);
   }
+  setVregData<DTR>(vreg_file, rdest, 0, acc);
 }
 
 template <template <typename DT1, typename DT2> class OP, typename DT8, typename DT16, typename DT32, typename DT64>
@@ -2145,7 +2317,7 @@ void vector_op_vid(VRF_t& vreg_file, uint32_t rdest, uint32_t vl, uint32_t vmask
   }
 }
 
-void vector_op_vid(VRF_t& vreg_file, uint32_t rdest, uint32_t vsew, uint32_t vl, uint32_t vmask) {
+inline void vector_op_vid(VRF_t& vreg_file, uint32_t rdest, uint32_t vsew, uint32_t vl, uint32_t vmask) {
   switch (vsew) {
   case 0:
     vector_op_vid<uint8_t>(vreg_file, rdest, vl, vmask);
@@ -2167,18 +2339,19 @@ void vector_op_vid(VRF_t& vreg_file, uint32_t rdest, uint32_t vsew, uint32_t vl,
 
 template <template <typename DT1, typename DT2> class OP, typename DT>
 void vector_op_vv_mask(VRF_t& vreg_file, uint32_t rsrc0, uint32_t rsrc1, uint32_t rdest, uint32_t vl, uint32_t vmask) {
-  for (uint32_t i = 0; i < vl; i++) {
-    if (isMasked(vreg_file, 0, i, vmask))
-      continue;
-    DT first = getVregData<DT>(vreg_file, rsrc0, i);
-    DT second = getVregData<DT>(vreg_file, rsrc1, i);
-    bool result = OP<DT, bool>::apply(first, second, 0);
-    DP(4, "Integer/float compare mask " << (OP<DT, bool>::name()) << "(" << +first << ", " << +second << ")" << " = " << +result);
-    auto old_value = getVregData<uint8_t>(vreg_file, rdest, i / 8);
-    if (result) {
-      setVregData<uint8_t>(vreg_file, rdest, i / 8, old_value | (1 << (i % 8)));
-    } else {
-      setVregData<uint8_t>(vreg_file, rdest, i / 8, old_value & ~(1 << (i % 8)));
+  constexpr uint32_t row_elts = VLENB / sizeof(DT);
+  auto mask = getVmask(vreg_file, vmask);
+  auto dst = vreg_file.data(rdest);
+  for (uint32_t base = 0; base < vl; base += row_elts) {
+    uint32_t n = std::min(row_elts, vl - base);
+    auto src0 = getVregPtr<DT>(vreg_file, rsrc0, base);
+    auto src1 = getVregPtr<DT>(vreg_file, rsrc1, base);
+    for (uint32_t j = 0; j < n; ++j) {
+      if (!isActive(mask, base + j))
+        continue;
+      bool result = OP<DT, bool>::apply(src0[j], src1[j], 0);
+      DP(4, "Integer/float compare mask " << (OP<DT, bool>::name()) << "(" << +src0[j] << ", " << +src1[j] << ")" << " = " << +result);
+      setMaskBit(dst, base + j, result);
     }
   }
 }
@@ -2206,19 +2379,17 @@ void vector_op_vv_mask(VRF_t& vreg_file, uint32_t rsrc0, uint32_t rsrc1, uint32_
 
 template <template <typename DT1, typename DT2> class OP>
 void vector_op_vv_mask(VRF_t& vreg_file, uint32_t rsrc0, uint32_t rsrc1, uint32_t rdest, uint32_t vl) {
-  for (uint32_t i = 0; i < vl; i++) {
-    uint8_t firstMask = getVregData<uint8_t>(vreg_file, rsrc0, i / 8);
-    bool first = (firstMask >> (i % 8)) & 0x1;
-    uint8_t secondMask = getVregData<uint8_t>(vreg_file, rsrc1, i / 8);
-    bool second = (secondMask >> (i % 8)) & 0x1;
-    bool result = OP<uint8_t, uint8_t>::apply(first, second, 0) & 0x1;
-    DP(4, "Compare mask bits " << (OP<uint8_t, uint8_t>::name()) << "(" << +first << ", " << +second << ")" << " = " << +result);
-    auto old_value = getVregData<uint8_t>(vreg_file, rdest, i / 8);
-    if (result) {
-      setVregData<uint8_t>(vreg_file, rdest, i / 8, old_value | (1 << (i % 8)));
-    } else {
-      setVregData<uint8_t>(vreg_file, rdest, i / 8, old_value & ~(1 << (i % 8)));
-    }
+  // mask-logical ops are bitwise, so they run a whole mask byte at a time;
+  // each byte is read before it is written, which keeps vd = vs1/vs2 safe.
+  auto src0 = vreg_file.data(rsrc0);
+  auto src1 = vreg_file.data(rsrc1);
+  auto dst = vreg_file.data(rdest);
+  for (uint32_t b = 0; b < (vl + 7) / 8; ++b) {
+    uint8_t result = OP<uint8_t, uint8_t>::apply(src0[b], src1[b], 0);
+    DP(4, "Compare mask bits " << (OP<uint8_t, uint8_t>::name()) << "(" << +src0[b] << ", " << +src1[b] << ")" << " = " << +result);
+    uint32_t bits = std::min<uint32_t>(8, vl - b * 8);
+    uint8_t keep = (bits == 8) ? 0 : (0xff << bits); // tail bits are undisturbed
+    dst[b] = (dst[b] & keep) | (result & ~keep);
   }
 }
 
@@ -1,6 +1,7 @@
 #include "vec_unit.h"
 #include "core.h"
 #include "vec_ops.h"
+#include <cstring>
 
 using namespace vortex;
 
@@ -33,7 +34,7 @@ using namespace vortex;
 class VecUnit::Impl {
 public:
   Impl(VecUnit *simobject, const Arch &arch, Core *core)
-      : simobject_(simobject), core_(core), vpu_states_(arch.num_warps(), arch.num_threads()), num_lanes_(arch.num_warps()), pending_reqs_(arch.num_warps()) {
+      : simobject_(simobject), core_(core), vpu_states_(arch.num_warps(), arch.num_threads()), num_lanes_(arch.vpu_num_lanes()), lane_width_(arch.vpu_lane_width()), chaining_(arch.vpu_chaining()), pipes_(ISSUE_WIDTH), pending_reqs_(arch.num_warps()), elem_addrs_(nullptr) {
     this->reset();
   }
 
@@ -41,10 +42,14 @@ public:
 
   void reset() {
     pending_reqs_.clear();
+    for (auto& pipe : pipes_) {
+      pipe = pipe_state_t();
+    }
     perf_stats_ = PerfStats();
   }
 
   void tick() {
+    uint64_t cycle = SimPlatform::instance().cycles();
     for (uint32_t iw = 0; iw < ISSUE_WIDTH; ++iw) {
       auto &input = simobject_->Inputs.at(iw);
       if (input.empty())
@@ -53,6 +58,30 @@ public:
       auto trace = input.front();
       auto trace_data = std::dynamic_pointer_cast<ExeTraceData>(trace->data);
       auto vpu_op = trace_data->vpu_op;
+      auto &pipe = pipes_.at(iw);
+
+      // does this op read the result of the op still streaming through the pipe?
+      bool dependent = false;
+      if (cycle < pipe.free_cycle && pipe.dst_reg.type != RegType::None) {
+        for (auto& src_reg : trace->src_regs) {
+          if (src_reg.type != RegType::None && src_reg.id() == pipe.dst_reg.id()) {
+            dependent = true;
+            break;
+          }
+        }
+      }
+
+      // the arithmetic pipe streams one instruction at a time; with chaining,
+      // a dependent op trails its producer one element group behind, so it
+      // only waits for the producer's first group.
+      uint64_t ready_cycle = (dependent && chaining_) ? pipe.chain_cycle : pipe.free_cycle;
+      if (cycle < ready_cycle) {
+        ++perf_stats_.stalls;
+        if (dependent) {
+          ++perf_stats_.dep_stalls;
+        }
+        continue;
+      }
 
       int delay = 0;
       switch (vpu_op) {
@@ -74,24 +103,68 @@ public:
         break;
       case VpuOpType::FMA:
       case VpuOpType::FMA_R:
-        delay = LATENCY_FMA;
+        delay = core_->arch().fma_latency();
         break;
       case VpuOpType::FDIV:
-        delay = LATENCY_FDIV;
+        delay = core_->arch().fdiv_latency();
         break;
       case VpuOpType::FSQRT:
-        delay = LATENCY_FSQRT;
+        delay = core_->arch().fsqrt_latency();
         break;
       case VpuOpType::FCVT:
-        delay = LATENCY_FCVT;
+        delay = core_->arch().fcvt_latency();
         break;
       default:
         std::abort();
       }
 
+      // reductions add a cross-lane combining tree
+      bool reduction = (vpu_op == VpuOpType::ARITH_R
+                     || vpu_op == VpuOpType::FNCP_R
+                     || vpu_op == VpuOpType::FMA_R);
+      if (reduction) {
+        delay += log2ceil(num_lanes_);
+      }
+
+      // VecUnit executes every active thread's vector, so the element groups
+      // of all of them stream through the datapath, num_lanes_ * lane_width_
+      // bits per cycle
+      uint32_t occupancy = 1;
+      if (vpu_op != VpuOpType::VSET) {
+        uint32_t sew_bits = 8 << trace_data->vsew;
+        uint64_t work_bits = uint64_t(trace_data->vl) * sew_bits * trace->tmask.count();
+        uint32_t datapath_width = num_lanes_ * lane_width_;
+        occupancy = std::max<uint32_t>(1, (work_bits + datapath_width - 1) / datapath_width);
+        perf_stats_.lane_cycles += (work_bits + lane_width_ - 1) / lane_width_;
+      }
+      // FMA covers vfadd/vfmul/vfmacc alike, so each element of each
+      // active thread counts once
+      if (vpu_op == VpuOpType::FMA
+       || vpu_op == VpuOpType::FMA_R
+       || vpu_op == VpuOpType::FDIV
+       || vpu_op == VpuOpType::FSQRT) {
+        perf_stats_.flops += uint64_t(trace_data->vl) * trace->tmask.count();
+      }
+      // a chained op cannot overtake its producer's element groups
+      uint64_t free_cycle = std::max<uint64_t>(pipe.free_cycle, cycle + occupancy);
+      perf_stats_.busy_cycles += free_cycle - std::max<uint64_t>(pipe.free_cycle, cycle);
+      perf_stats_.lane_slots += uint64_t(occupancy) * num_lanes_;
+      pipe.free_cycle = free_cycle;
+
+      // with chaining, the result is forwarded as soon as the first element
+      // group leaves the pipeline; otherwise, or for a reduction, which has
+      // no partial result, after the last one.
+      if (!chaining_ || reduction) {
+        delay += occupancy - 1;
+      }
+      pipe.chain_cycle = cycle + delay;
+      pipe.dst_reg = trace->dst_reg;
+      perf_stats_.latency += delay;
+
       simobject_->Outputs.at(iw).push(trace, 2 + delay);
 
-      DT(3, simobject_->name() << ": op=" << vpu_op << ", " << *trace);
+      DT(3, simobject_->name() << ": op=" << vpu_op << ", occupancy=" << occupancy << ", " << *trace);
+      BT(VpuOp, core_->trace_src(), trace->wid, trace->uuid, trace->PC, occupancy);
 
       input.pop();
     }
@@ -110,13 +183,14 @@ public:
     uint32_t vd = instr.getDestReg().idx;
     uint32_t vsewb = 1 << states.vtype.vsew;
     assert(lsuArgs.width == states.vtype.vsew && "vsew and width must match!");
-    auto &vreg_file = states.vreg_file.at(tid);
+    auto vreg_file = states.vreg_file(tid);
     uint64_t base_addr = rs1_data.at(tid).i;
     base_addr &= 0xFFFFFFFC; // TODO: riscv-tests fix
 
     // udpate trace data
     trace_data->vl = states.vl;
     trace_data->vnf = lsuArgs.nf + 1;
+    elem_addrs_ = trace_data->elem_addrs.empty() ? nullptr : &trace_data->elem_addrs.at(tid);
 
     switch (vls_type) {
     case VlsType::VL: { // unit-stride
@@ -142,14 +216,18 @@ public:
         uint32_t emul = (states.vtype.vlmul >> 2) ? 1 : (1 << (states.vtype.vlmul & 0b11));
         assert(nfields * emul <= 8);
 
+        if (vmask == 1) {
+          this->load_block(vreg_file, vd, emul, nfields, states.vtype.vsew, states.vl, base_addr, trace_data->mem_addrs.at(tid));
+          break;
+        }
+
         for (uint32_t i = 0; i < states.vl; i++) {
           if (isMasked(vreg_file, 0, i, vmask))
             continue;
           for (uint32_t f = 0; f < nfields; f++) {
             uint64_t mem_addr = base_addr + (i * nfields + f) * vsewb;
             uint64_t mem_data = 0;
-            core_->dcache_read(&mem_data, mem_addr, vsewb);
-            trace_data->mem_addrs.at(tid).push_back({mem_addr, vsewb});
+            this->read_elem(&mem_data, mem_addr, vsewb, trace_data->mem_addrs.at(tid));
             setVregData(states.vtype.vsew, vreg_file, vd + f * emul, i, mem_data);
           }
         }
@@ -169,13 +247,17 @@ public:
         trace_data->vl = vl;
         trace_data->vnf = 1;
 
+        if (vmask == 1 && stride == vsewb) {
+          this->load_block(vreg_file, vd, 1, 1, states.vtype.vsew, vl, base_addr, trace_data->mem_addrs.at(tid));
+          break;
+        }
+
         for (uint32_t i = 0; i < vl; i++) {
           if (isMasked(vreg_file, 0, i, vmask))
             continue;
           uint64_t mem_addr = base_addr + i * stride;
           uint64_t mem_data = 0;
-          core_->dcache_read(&mem_data, mem_addr, vsewb);
-          trace_data->mem_addrs.at(tid).push_back({mem_addr, vsewb});
+          this->read_elem(&mem_data, mem_addr, vsewb, trace_data->mem_addrs.at(tid));
           setVregData(states.vtype.vsew, vreg_file, vd, i, mem_data);
         }
         break;
@@ -187,20 +269,11 @@ public:
         }
 
         uint32_t vl = (states.vl + 7) / 8;
-        uint32_t stride = vsewb;
 
         trace_data->vl = vl;
         trace_data->vnf = 1;
 
-        for (uint32_t i = 0; i < vl; i++) {
-          if (isMasked(vreg_file, 0, i, 1))
-            continue;
-          uint64_t mem_addr = base_addr + i * stride;
-          uint64_t mem_data = 0;
-          core_->dcache_read(&mem_data, mem_addr, vsewb);
-          trace_data->mem_addrs.at(tid).push_back({mem_addr, vsewb});
-          setVregData(states.vtype.vsew, vreg_file, vd, i, mem_data);
-        }
+        this->load_block(vreg_file, vd, 1, 1, states.vtype.vsew, vl, base_addr, trace_data->mem_addrs.at(tid));
         break;
       }
       default:
@@ -224,6 +297,11 @@ public:
 
       WordI stride = rs2_data.at(tid).i;
 
+      if (vmask == 1 && stride == WordI(nfields * vsewb)) {
+        this->load_block(vreg_file, vd, emul, nfields, states.vtype.vsew, states.vl, base_addr, trace_data->mem_addrs.at(tid));
+        break;
+      }
+
       for (uint32_t i = 0; i < states.vl; i++) {
         if (isMasked(vreg_file, 0, i, vmask))
           continue;
@@ -231,8 +309,7 @@ public:
           WordI offset = i * stride + f * vsewb;
           uint64_t mem_addr = base_addr + offset;
           uint64_t mem_data = 0;
-          core_->dcache_read(&mem_data, mem_addr, vsewb);
-          trace_data->mem_addrs.at(tid).push_back({mem_addr, vsewb});
+          this->read_elem(&mem_data, mem_addr, vsewb, trace_data->mem_addrs.at(tid));
           setVregData(states.vtype.vsew, vreg_file, vd + f * emul, i, mem_data);
         }
       }
@@ -271,6 +348,8 @@ public:
           uint64_t mem_data = 0;
           core_->dcache_read(&mem_data, mem_addr, vsewb);
           trace_data->mem_addrs.at(tid).push_back({mem_addr, vsewb});
+          this->record_elem(mem_addr, vsewb);
+          ++perf_stats_.reads;
           setVregData(states.vtype.vsew, vreg_file, vd + f * emul, i, mem_data);
         }
       }
@@ -294,13 +373,14 @@ public:
     uint32_t vsewb = 1 << states.vtype.vsew;
     assert(lsuArgs.width == states.vtype.vsew && "vsew and width must match!");
     uint32_t vs3 = instr.getSrcReg(2).idx;
-    auto &vreg_file = states.vreg_file.at(tid);
+    auto vreg_file = states.vreg_file(tid);
     uint64_t base_addr = rs1_data.at(tid).i;
     base_addr &= 0xFFFFFFFC; // TODO: riscv-tests fix
 
     // udpate trace data
     trace_data->vl = states.vl;
     trace_data->vnf = lsuArgs.nf + 1;
+    elem_addrs_ = trace_data->elem_addrs.empty() ? nullptr : &trace_data->elem_addrs.at(tid);
 
     switch (vls_type) {
     case VlsType::VS: { // unit-stride
@@ -311,14 +391,18 @@ public:
         uint32_t emul = states.vtype.vlmul >> 2 ? 1 : 1 << (states.vtype.vlmul & 0b11);
         assert(nfields * emul <= 8);
 
+        if (vmask == 1 && !is_cout_range(base_addr, states.vl * nfields * vsewb)) {
+          this->store_block(vreg_file, vs3, emul, nfields, states.vtype.vsew, states.vl, base_addr, trace_data->mem_addrs.at(tid));
+          break;
+        }
+
         for (uint32_t i = 0; i < states.vl; i++) {
           if (isMasked(vreg_file, 0, i, vmask))
             continue;
           for (uint32_t f = 0; f < nfields; f++) {
             uint64_t mem_addr = base_addr + (i * nfields + f) * vsewb;
             uint64_t value = getVregData(states.vtype.vsew, vreg_file, vs3 + f * emul, i);
-            core_->dcache_write(&value, mem_addr, vsewb);
-            trace_data->mem_addrs.at(tid).push_back({mem_addr, vsewb});
+            this->write_elem(&value, mem_addr, vsewb, trace_data->mem_addrs.at(tid));
           }
         }
         break;
@@ -335,13 +419,17 @@ public:
         trace_data->vl = vl;
         trace_data->vnf = 1;
 
+        if (vmask == 1 && !is_cout_range(base_addr, vl * vsewb)) {
+          this->store_block(vreg_file, vs3, 1, 1, states.vtype.vsew, vl, base_addr, trace_data->mem_addrs.at(tid));
+          break;
+        }
+
         for (uint32_t i = 0; i < vl; i++) {
           if (isMasked(vreg_file, 0, i, vmask))
             continue;
           uint64_t value = getVregData(states.vtype.vsew, vreg_file, vs3, i);
           uint64_t mem_addr = base_addr + i * stride;
-          core_->dcache_write(&value, mem_addr, vsewb);
-          trace_data->mem_addrs.at(tid).push_back({mem_addr, vsewb});
+          this->write_elem(&value, mem_addr, vsewb, trace_data->mem_addrs.at(tid));
         }
         break;
       }
@@ -356,13 +444,17 @@ public:
         trace_data->vl = vl;
         trace_data->vnf = 1;
 
+        if (!is_cout_range(base_addr, vl * stride)) {
+          this->store_block(vreg_file, vs3, 1, 1, states.vtype.vsew, vl, base_addr, trace_data->mem_addrs.at(tid));
+          break;
+        }
+
         for (uint32_t i = 0; i < vl; i++) {
           if (isMasked(vreg_file, 0, i, 1))
             continue;
           uint64_t mem_addr = base_addr + i * stride;
           uint64_t value = getVregData(states.vtype.vsew, vreg_file, vs3, i);
-          core_->dcache_write(&value, mem_addr, vsewb);
-          trace_data->mem_addrs.at(tid).push_back({mem_addr, vsewb});
+          this->write_elem(&value, mem_addr, vsewb, trace_data->mem_addrs.at(tid));
         }
         break;
       }
@@ -387,6 +479,12 @@ public:
       uint32_t emul = states.vtype.vlmul >> 2 ? 1 : 1 << (states.vtype.vlmul & 0b11);
       assert(nfields * emul <= 8);
 
+      if (vmask == 1 && stride == WordI(nfields * vsewb)
+       && !is_cout_range(base_addr, states.vl * nfields * vsewb)) {
+        this->store_block(vreg_file, vs3, emul, nfields, states.vtype.vsew, states.vl, base_addr, trace_data->mem_addrs.at(tid));
+        break;
+      }
+
       for (uint32_t i = 0; i < states.vl; i++) {
         if (isMasked(vreg_file, 0, i, vmask))
           continue;
@@ -394,8 +492,7 @@ public:
           WordI offset = i * stride + f * vsewb;
           uint64_t mem_addr = base_addr + offset;
           uint64_t value = getVregData(states.vtype.vsew, vreg_file, vs3 + f * emul, i);
-          core_->dcache_write(&value, mem_addr, vsewb);
-          trace_data->mem_addrs.at(tid).push_back({mem_addr, vsewb});
+          this->write_elem(&value, mem_addr, vsewb, trace_data->mem_addrs.at(tid));
         }
       }
       break;
@@ -433,6 +530,8 @@ public:
           uint64_t value = getVregData(states.vtype.vsew, vreg_file, vs3 + f * emul, i);
           core_->dcache_write(&value, mem_addr, vsewb);
           trace_data->mem_addrs.at(tid).push_back({mem_addr, vsewb});
+          this->record_elem(mem_addr, vsewb);
+          ++perf_stats_.writes;
         }
       }
       break;
@@ -514,6 +613,7 @@ public:
 
     // udpate trace data
     trace_data->vl = states.vl;
+    trace_data->vsew = states.vtype.vsew;
     trace_data->vlmul = 1;
     trace_data->vpu_op = VpuOpType::VSET;
   }
@@ -523,7 +623,7 @@ public:
                std::vector<reg_data_t> &rd_data,
                ExeTraceData *trace_data) {
     auto &states = vpu_states_.at(wid);
-    auto &vreg_file = states.vreg_file.at(tid);
+    auto vreg_file = states.vreg_file(tid);
     auto op_type = instr.getOpType();
     auto instrArgs = instr.getArgs();
 
@@ -1639,6 +1739,7 @@ public:
 
     // udpate trace data
     trace_data->vl = states.vl;
+    trace_data->vsew = states.vtype.vsew;
     trace_data->vlmul = 1;
     trace_data->vpu_op = vpu_op;
   }
@@ -1699,9 +1800,8 @@ public:
   }
 
   std::string dumpRegister(uint32_t wid, uint32_t tid, uint32_t reg_idx) const {
-    assert(wid < vpu_states_.size() && tid < vpu_states_[wid].vreg_file.size());
-    assert(reg_idx < MAX_NUM_REGS);
-    const auto &reg = vpu_states_[wid].vreg_file[tid][reg_idx];
+    assert(wid < vpu_states_.size());
+    auto reg = vpu_states_[wid].vreg_file(tid).at(reg_idx);
     uint32_t n = VLENB / XLENB;
     std::ostringstream oss;
     oss << "{";
@@ -1709,7 +1809,7 @@ public:
       uint64_t value = 0;
       // Combine bytes in little-endian order
       for (uint32_t j = 0; j < XLENB; ++j) {
-        value |= static_cast<uint64_t>(reg.at(i * XLENB + j)) << (8 * j);
+        value |= static_cast<uint64_t>(reg[i * XLENB + j]) << (8 * j);
       }
       // Print the combined value
       oss << "0x" << std::hex << std::setfill('0');
@@ -1740,11 +1840,137 @@ public:
   }
 
 private:
+
+  static bool is_cout_range(uint64_t addr, uint32_t size) {
+    return addr < (uint64_t(IO_COUT_ADDR) + IO_COUT_SIZE)
+        && (addr + size) > uint64_t(IO_COUT_ADDR);
+  }
+
+  // Element access: requests falling in the same cache line as the
+  // previous one are merged into a single timing request.
+  static bool merge_line(std::vector<mem_addr_size_t> &mem_addrs, uint64_t addr, uint32_t size) {
+    if (mem_addrs.empty())
+      return false;
+    auto &last = mem_addrs.back();
+    if ((last.addr / L1_LINE_SIZE) != (addr / L1_LINE_SIZE)
+     || ((addr + size - 1) / L1_LINE_SIZE) != (addr / L1_LINE_SIZE))
+      return false;
+    uint64_t start = std::min(last.addr, addr);
+    uint64_t end = std::max(last.addr + last.size, addr + size);
+    last.addr = start;
+    last.size = end - start;
+    return true;
+  }
+
+  // The memory profiler classifies the element stream as issued, before
+  // merge_line() and the block paths fold it into cache lines.
+  void record_elem(uint64_t addr, uint32_t size) {
+    if (elem_addrs_) {
+      elem_addrs_->push_back({addr, size});
+    }
+  }
+
+  void read_elem(void *data, uint64_t addr, uint32_t size, std::vector<mem_addr_size_t> &mem_addrs) {
+    core_->dcache_read(data, addr, size);
+    this->record_elem(addr, size);
+    if (!merge_line(mem_addrs, addr, size)) {
+      mem_addrs.push_back({addr, size});
+      ++perf_stats_.reads;
+    }
+  }
+
+  void write_elem(const void *data, uint64_t addr, uint32_t size, std::vector<mem_addr_size_t> &mem_addrs) {
+    core_->dcache_write(data, addr, size);
+    this->record_elem(addr, size);
+    if (!merge_line(mem_addrs, addr, size)) {
+      mem_addrs.push_back({addr, size});
+      ++perf_stats_.writes;
+    }
+  }
+
+  // Contiguous access: one memory call and one timing request per cache line.
+  // Splitting on lines also keeps each call inside a single page.
+  void read_block(Byte *data, uint64_t addr, uint32_t size, std::vector<mem_addr_size_t> &mem_addrs) {
+    while (size != 0) {
+      uint32_t chunk = std::min<uint64_t>(size, L1_LINE_SIZE - (addr % L1_LINE_SIZE));
+      core_->dcache_read(data, addr, chunk);
+      mem_addrs.push_back({addr, chunk});
+      ++perf_stats_.reads;
+      addr += chunk;
+      data += chunk;
+      size -= chunk;
+    }
+  }
+
+  void write_block(const Byte *data, uint64_t addr, uint32_t size, std::vector<mem_addr_size_t> &mem_addrs) {
+    while (size != 0) {
+      uint32_t chunk = std::min<uint64_t>(size, L1_LINE_SIZE - (addr % L1_LINE_SIZE));
+      core_->dcache_write(data, addr, chunk);
+      mem_addrs.push_back({addr, chunk});
+      ++perf_stats_.writes;
+      addr += chunk;
+      data += chunk;
+      size -= chunk;
+    }
+  }
+
+  // Unit-stride (segment) load of vl elements into vd, fields interleaved in memory.
+  void load_block(VRF_t &vreg_file, uint32_t vd, uint32_t emul, uint32_t nfields, uint32_t vsew, uint32_t vl,
+                  uint64_t base_addr, std::vector<mem_addr_size_t> &mem_addrs) {
+    uint32_t vsewb = 1 << vsew;
+    for (uint32_t i = 0; elem_addrs_ && i < vl * nfields; i++) {
+      elem_addrs_->push_back({base_addr + i * vsewb, vsewb});
+    }
+    if (nfields == 1) {
+      // the register group is contiguous: load in place
+      auto group = vreg_file.span<Byte>(vd, (vl * vsewb + VLENB - 1) / VLENB);
+      this->read_block(group.data(), base_addr, vl * vsewb, mem_addrs);
+      return;
+    }
+    std::vector<Byte> buffer(vl * nfields * vsewb);
+    this->read_block(buffer.data(), base_addr, buffer.size(), mem_addrs);
+    for (uint32_t i = 0; i < vl; i++) {
+      for (uint32_t f = 0; f < nfields; f++) {
+        uint64_t mem_data = 0;
+        std::memcpy(&mem_data, buffer.data() + (i * nfields + f) * vsewb, vsewb);
+        setVregData(vsew, vreg_file, vd + f * emul, i, mem_data);
+      }
+    }
+  }
+
+  void store_block(const VRF_t &vreg_file, uint32_t vs3, uint32_t emul, uint32_t nfields, uint32_t vsew, uint32_t vl,
+                   uint64_t base_addr, std::vector<mem_addr_size_t> &mem_addrs) {
+    uint32_t vsewb = 1 << vsew;
+    for (uint32_t i = 0; elem_addrs_ && i < vl * nfields; i++) {
+      elem_addrs_->push_back({base_addr + i * vsewb, vsewb});
+    }
+    if (nfields == 1) {
+      // the register group is contiguous: store in place
+      auto group = vreg_file.span<Byte>(vs3, (vl * vsewb + VLENB - 1) / VLENB);
+      this->write_block(group.data(), base_addr, vl * vsewb, mem_addrs);
+      return;
+    }
+    std::vector<Byte> buffer(vl * nfields * vsewb);
+    for (uint32_t i = 0; i < vl; i++) {
+      for (uint32_t f = 0; f < nfields; f++) {
+        uint64_t value = getVregData(vsew, vreg_file, vs3 + f * emul, i);
+        std::memcpy(buffer.data() + (i * nfields + f) * vsewb, &value, vsewb);
+      }
+    }
+    this->write_block(buffer.data(), base_addr, buffer.size(), mem_addrs);
+  }
+
   struct pending_req_t {
     instr_trace_t *trace;
     uint32_t count;
   };
 
+  struct pipe_state_t {
+    uint64_t free_cycle = 0;  // last element group issued
+    uint64_t chain_cycle = 0; // first element group done
+    RegOpd   dst_reg;
+  };
+
   union vtype_t {
     struct {
       uint32_t vlmul : 3; // vector register group multiplier
@@ -1758,7 +1984,8 @@ private:
   };
 
   struct vpu_states_t {
-    std::vector<VRF_t> vreg_file;
+    std::vector<Byte, AlignedAllocator<Byte>> vreg_data; // [thread][vreg][VLENB]
+    uint32_t num_threads;
     uint32_t vstart;
     uint32_t vxsat;
     uint32_t vxrm;
@@ -1768,19 +1995,25 @@ private:
     uint32_t vlmax;
 
     vpu_states_t(uint32_t num_threads)
-        : vreg_file(num_threads, std::vector(MAX_NUM_REGS, std::vector<Byte>(VLENB, 0))), vstart(0), vxsat(0), vxrm(0), vl(0), vtype({0, 0, 0, 0, 0, 0}), vlenb(VLENB), vlmax(0) {}
+        : vreg_data(num_threads * MAX_NUM_REGS * VLENB, 0), num_threads(num_threads), vstart(0), vxsat(0), vxrm(0), vl(0), vtype({0, 0, 0, 0, 0, 0}), vlenb(VLENB), vlmax(0) {}
+
+    VRF_t vreg_file(uint32_t tid) {
+      assert(tid < num_threads);
+      return VRF_t(vreg_data.data() + tid * MAX_NUM_REGS * VLENB);
+    }
+
+    ConstVRF_t vreg_file(uint32_t tid) const {
+      assert(tid < num_threads);
+      return ConstVRF_t(vreg_data.data() + tid * MAX_NUM_REGS * VLENB);
+    }
 
     void reset() {
-      for (auto &reg_file : this->vreg_file) {
-        for (auto &reg : reg_file) {
-          for (auto &elm : reg) {
+      for (auto &elm : vreg_data) {
 #ifndef NDEBUG
-            elm = 0;
+        elm = 0;
 #else
-            elm = std::rand();
+        elm = std::rand();
 #endif
-          }
-        }
       }
     }
   };
@@ -1789,8 +2022,12 @@ private:
   Core *core_;
   std::vector<vpu_states_t> vpu_states_;
   uint32_t num_lanes_;
+  uint32_t lane_width_;
+  bool chaining_;
+  std::vector<pipe_state_t> pipes_;
   HashTable<pending_req_t> pending_reqs_;
   PerfStats perf_stats_;
+  std::vector<mem_addr_size_t> *elem_addrs_; // current thread's element stream, if profiled
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -15,15 +15,20 @@ public:
   struct MemTraceData : public ITraceData {
     using Ptr = std::shared_ptr<MemTraceData>;
     std::vector<std::vector<mem_addr_size_t>> mem_addrs;
+    std::vector<std::vector<mem_addr_size_t>> elem_addrs; // per-element addresses before line merging (memory profiler only)
     uint32_t vl = 0;
     uint32_t vnf = 0;
-    MemTraceData(uint32_t num_threads = 0) : mem_addrs(num_threads) {}
+    MemTraceData(uint32_t num_threads = 0, bool record_elems = false)
+      : mem_addrs(num_threads)
+      , elem_addrs(record_elems ? num_threads : 0)
+    {}
   };
 
   struct ExeTraceData : public ITraceData {
     using Ptr = std::shared_ptr<ExeTraceData>;
     VpuOpType vpu_op;
     uint32_t vl = 0;
+    uint32_t vsew = 0;
     uint32_t vlmul = 0;
   };
 
@@ -32,19 +37,34 @@ public:
     uint64_t writes;
     uint64_t latency;
     uint64_t stalls;
+    uint64_t dep_stalls;    // stalls waiting on the results of the op still in the pipe
+    uint64_t busy_cycles;   // arithmetic pipe occupancy
+    uint64_t lane_cycles;   // lane-cycles doing useful work
+    uint64_t lane_slots;    // lane-cycles available while the pipe is busy
+    uint64_t flops;         // floating-point element operations
 
     PerfStats()
       : reads(0)
       , writes(0)
       , latency(0)
       , stalls(0)
+      , dep_stalls(0)
+      , busy_cycles(0)
+      , lane_cycles(0)
+      , lane_slots(0)
+      , flops(0)
     {}
 
     PerfStats& operator+=(const PerfStats& rhs) {
-      this->reads   += rhs.reads;
-      this->writes  += rhs.writes;
-      this->latency += rhs.latency;
-      this->stalls  += rhs.stalls;
+      this->reads        += rhs.reads;
+      this->writes       += rhs.writes;
+      this->latency      += rhs.latency;
+      this->stalls       += rhs.stalls;
+      this->dep_stalls   += rhs.dep_stalls;
+      this->busy_cycles  += rhs.busy_cycles;
+      this->lane_cycles  += rhs.lane_cycles;
+      this->lane_slots   += rhs.lane_slots;
+      this->flops        += rhs.flops;
       return *this;
     }
   };